@@ -300,6 +300,9 @@ CP_C_API void cp_destroy_context(cp_context_t *context) {
 	// Unload all plug-ins 
 	cp_uninstall_plugins(context);
 
+	// Release cached plug-in descriptors
+	cpi_free_descriptor_cache(context);
+
 	// Release remaining information objects
 	cpi_release_infos(context);
 	
@@ -1141,6 +1141,20 @@ CP_C_API cp_status_t cp_install_plugin(cp_context_t *ctx, cp_plugin_info_t *pi)
  */
 CP_C_API cp_status_t cp_scan_plugins(cp_context_t *ctx, int flags) CP_GCC_NONNULL(1);
 
+/**
+ * Sets the file the plug-in descriptors loaded by ::cp_scan_plugins are
+ * persisted to. The first scan reads the descriptors from this file and
+ * only parses the descriptors which are new or whose descriptor file
+ * changed in modification time or size. Scans which change the
+ * descriptors write the file again. Must be called before the first scan
+ * to take effect at startup.
+ * 
+ * @param ctx the plug-in context
+ * @param file the cache file, or NULL to not persist descriptors
+ * @return @ref CP_OK (zero) on success or @ref CP_ERR_RESOURCE if insufficient memory
+ */
+CP_C_API cp_status_t cp_set_descriptor_cache_file(cp_context_t *ctx, const char *file) CP_GCC_NONNULL(1);
+
 /**
  * Starts a plug-in. Also starts any imported plug-ins. If the plug-in is
  * already starting then
@@ -175,6 +175,19 @@ struct cp_plugin_env_t {
 	/// Map of in-use reference counter information object
 	hash_t *infos;
 
+	/// Maps plug-in directory paths to descriptors loaded by earlier scans,
+	/// or NULL if no scan has been done yet
+	hash_t *descriptor_cache;
+
+	/// Number of plug-in scans done, used to expire descriptor cache entries
+	unsigned int scan_count;
+
+	/// File the descriptor cache is persisted to, or NULL
+	char *descriptor_cache_file;
+
+	/// Whether the descriptor cache differs from the persisted one
+	int descriptor_cache_dirty;
+
 	/// Maps plug-in identifiers to plug-in state structures 
 	hash_t *plugins;
 
@@ -557,6 +570,17 @@ CP_HIDDEN void cpi_release_info(cp_context_t *ctx, void *res) CP_GCC_NONNULL(1,
 CP_HIDDEN void cpi_release_infos(cp_context_t *ctx) CP_GCC_NONNULL(1);
 
 
+// Plug-in scanning
+
+/**
+ * Releases the plug-in descriptors cached by ::cp_scan_plugins,
+ * destroys the descriptor cache and forgets the descriptor cache file.
+ *
+ * @param ctx the plug-in context
+ */
+CP_HIDDEN void cpi_free_descriptor_cache(cp_context_t *ctx) CP_GCC_NONNULL(1);
+
+
 // Serialized execution
 
 /**
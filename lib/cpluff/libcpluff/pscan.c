@@ -29,6 +29,7 @@
 #include <config.h>
 #endif
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
@@ -41,12 +42,737 @@
 #include "defines.h"
 #include "util.h"
 #include "internal.h"
+#if defined(_WIN32)
+#include "win32_utils.h"
+#endif
+
+
+/* ------------------------------------------------------------------------
+ * Constants
+ * ----------------------------------------------------------------------*/
+
+/// File name of the plug-in descriptor
+#define CP_PLUGIN_DESCRIPTOR "addon.xml"
+
+/// Identifies a descriptor cache file, bump the version on format changes
+#define CP_DESCRIPTOR_CACHE_MAGIC "CPDCACHE1"
+
+
+/* ------------------------------------------------------------------------
+ * Data types
+ * ----------------------------------------------------------------------*/
+
+/// A plug-in descriptor loaded by an earlier scan
+typedef struct descriptor_cache_entry_t {
+
+	/// The plug-in directory path, used as the hash key
+	char *path;
+
+	/// Modification time of the descriptor file when it was loaded
+	time_t mtime;
+
+	/// Size of the descriptor file when it was loaded
+	long long size;
+
+	/// The scan which last found this plug-in directory
+	unsigned int scan;
+
+	/// The loaded plug-in descriptor
+	cp_plugin_info_t *plugin;
+
+} descriptor_cache_entry_t;
 
 
 /* ------------------------------------------------------------------------
  * Function definitions
  * ----------------------------------------------------------------------*/
 
+/**
+ * Gets the modification time and size of the descriptor of a plug-in.
+ * 
+ * @param path the plug-in directory path
+ * @param mtime pointer to the location where to store the modification time
+ * @param size pointer to the location where to store the file size
+ * @return non-zero if the descriptor exists
+ */
+static int stat_descriptor(const char *path, time_t *mtime, long long *size) {
+	char *file;
+	int path_len;
+	int found;
+
+	path_len = strlen(path);
+	if ((file = malloc((path_len + strlen(CP_PLUGIN_DESCRIPTOR) + 2) * sizeof(char))) == NULL) {
+		return 0;
+	}
+	strcpy(file, path);
+	file[path_len] = CP_FNAMESEP_CHAR;
+	strcpy(file + path_len + 1, CP_PLUGIN_DESCRIPTOR);
+
+#if defined(_WIN32)
+	{
+		struct _stat64 st;
+		wchar_t *fileW = to_utf16(file, 0);
+
+		found = (fileW != NULL && _wstat64(fileW, &st) == 0);
+		free(fileW);
+		if (found) {
+			*mtime = st.st_mtime;
+			*size = st.st_size;
+		}
+	}
+#else
+	{
+		struct stat st;
+
+		found = (stat(file, &st) == 0);
+		if (found) {
+			*mtime = st.st_mtime;
+			*size = st.st_size;
+		}
+	}
+#endif
+
+	free(file);
+	return found;
+}
+
+static void free_descriptor_cache_entry(cp_context_t *context, descriptor_cache_entry_t *entry) {
+	cp_release_info(context, entry->plugin);
+	free(entry->path);
+	free(entry);
+}
+
+/**
+ * Opens a file, converting the file name to UTF-16 on Windows.
+ * 
+ * @param file the file name in UTF-8
+ * @param mode the fopen mode
+ * @return the file handle or NULL on failure
+ */
+static FILE *open_file(const char *file, const char *mode) {
+#if defined(_WIN32)
+	wchar_t *fileW = to_utf16(file, 0);
+	wchar_t *modeW = to_utf16(mode, 0);
+	FILE *fh = NULL;
+
+	if (fileW != NULL && modeW != NULL) {
+		fh = _wfopen(fileW, modeW);
+	}
+	free(fileW);
+	free(modeW);
+	return fh;
+#else
+	return fopen(file, mode);
+#endif
+}
+
+/**
+ * Replaces a file with another one.
+ * 
+ * @param from the new file
+ * @param to the file to be replaced
+ * @return zero on success
+ */
+static int replace_file(const char *from, const char *to) {
+#if defined(_WIN32)
+	wchar_t *fromW = to_utf16(from, 0);
+	wchar_t *toW = to_utf16(to, 0);
+	int result = -1;
+
+	if (fromW != NULL && toW != NULL) {
+		_wremove(toW);
+		result = _wrename(fromW, toW);
+	}
+	free(fromW);
+	free(toW);
+	return result;
+#else
+	return rename(from, to);
+#endif
+}
+
+/// Deallocates a plug-in descriptor read from the descriptor cache file
+static void dealloc_cached_plugin_info(cp_context_t *context, cp_plugin_info_t *plugin) {
+	cpi_free_plugin(plugin);
+}
+
+/// Read position in the contents of a descriptor cache file
+typedef struct cache_reader_t {
+
+	/// The next byte to be read
+	const unsigned char *pos;
+
+	/// End of the data
+	const unsigned char *end;
+
+	/// Non-zero if the data is truncated or corrupt, or memory ran out
+	int error;
+
+} cache_reader_t;
+
+static void write_uint(FILE *fh, unsigned int value) {
+	unsigned char b[4];
+
+	b[0] = value & 0xff;
+	b[1] = (value >> 8) & 0xff;
+	b[2] = (value >> 16) & 0xff;
+	b[3] = (value >> 24) & 0xff;
+	fwrite(b, 1, sizeof(b), fh);
+}
+
+static void write_int64(FILE *fh, long long value) {
+	write_uint(fh, (unsigned int) ((unsigned long long) value & 0xffffffffu));
+	write_uint(fh, (unsigned int) ((unsigned long long) value >> 32));
+}
+
+static void write_str(FILE *fh, const char *str) {
+	if (str == NULL) {
+		write_uint(fh, 0);
+	} else {
+		size_t len = strlen(str);
+
+		write_uint(fh, (unsigned int) len + 1);
+		fwrite(str, 1, len, fh);
+	}
+}
+
+static unsigned int read_uint(cache_reader_t *reader) {
+	unsigned int value;
+
+	if (reader->error || reader->end - reader->pos < 4) {
+		reader->error = 1;
+		return 0;
+	}
+	value = reader->pos[0]
+		| ((unsigned int) reader->pos[1] << 8)
+		| ((unsigned int) reader->pos[2] << 16)
+		| ((unsigned int) reader->pos[3] << 24);
+	reader->pos += 4;
+	return value;
+}
+
+static long long read_int64(cache_reader_t *reader) {
+	unsigned long long low = read_uint(reader);
+	unsigned long long high = read_uint(reader);
+
+	return (long long) (low | (high << 32));
+}
+
+/**
+ * Reads an element count, rejecting counts which can't fit in the
+ * remaining data so that corrupt files don't cause huge allocations.
+ */
+static unsigned int read_count(cache_reader_t *reader) {
+	unsigned int count = read_uint(reader);
+
+	if ((size_t) (reader->end - reader->pos) / 4 < count) {
+		reader->error = 1;
+		return 0;
+	}
+	return count;
+}
+
+static char *read_str(cache_reader_t *reader) {
+	unsigned int len = read_uint(reader);
+	char *str;
+
+	if (reader->error || len == 0) {
+		return NULL;
+	}
+	len--;
+	if ((size_t) (reader->end - reader->pos) < len
+		|| memchr(reader->pos, '\0', len) != NULL
+		|| (str = malloc(len + 1)) == NULL) {
+		reader->error = 1;
+		return NULL;
+	}
+	memcpy(str, reader->pos, len);
+	str[len] = '\0';
+	reader->pos += len;
+	return str;
+}
+
+/// Maximum nesting of configuration elements accepted from the cache file
+#define CP_DESCRIPTOR_CACHE_MAX_DEPTH 64
+
+static void write_cfg_element(FILE *fh, const cp_cfg_element_t *ce) {
+	unsigned int i;
+
+	write_str(fh, ce->name);
+	write_uint(fh, ce->num_atts);
+	if (ce->num_atts > 0) {
+		size_t size = 0;
+
+		// The attributes share a single buffer, see parser_attsdup
+		for (i = 0; i < ce->num_atts * 2; i++) {
+			size += strlen(ce->atts[i]) + 1;
+		}
+		write_uint(fh, (unsigned int) size);
+		for (i = 0; i < ce->num_atts * 2; i++) {
+			fwrite(ce->atts[i], 1, strlen(ce->atts[i]) + 1, fh);
+		}
+	}
+	write_str(fh, ce->value);
+	write_uint(fh, ce->num_children);
+	for (i = 0; i < ce->num_children; i++) {
+		write_cfg_element(fh, ce->children + i);
+	}
+}
+
+static void read_cfg_element(cache_reader_t *reader, cp_cfg_element_t *ce, cp_cfg_element_t *parent, unsigned int index, int depth) {
+	unsigned int i, num;
+
+	ce->parent = parent;
+	ce->index = index;
+	if (depth > CP_DESCRIPTOR_CACHE_MAX_DEPTH) {
+		reader->error = 1;
+		return;
+	}
+	ce->name = read_str(reader);
+	num = read_count(reader);
+	if (num > 0) {
+		unsigned int size = read_uint(reader);
+		char *data;
+		size_t offset;
+
+		if (reader->error
+			|| (size_t) (reader->end - reader->pos) < size
+			|| (ce->atts = calloc(num * 2, sizeof(char *))) == NULL
+			|| (data = malloc(size)) == NULL) {
+			reader->error = 1;
+			return;
+		}
+		memcpy(data, reader->pos, size);
+		reader->pos += size;
+		ce->atts[0] = data;
+		ce->num_atts = num;
+		for (i = 0, offset = 0; i < num * 2; i++) {
+			const char *nul;
+
+			if (offset >= size || (nul = memchr(data + offset, '\0', size - offset)) == NULL) {
+				reader->error = 1;
+				return;
+			}
+			ce->atts[i] = data + offset;
+			offset = nul - data + 1;
+		}
+	}
+	ce->value = read_str(reader);
+	num = read_count(reader);
+	if (num > 0) {
+		if (reader->error || (ce->children = calloc(num, sizeof(cp_cfg_element_t))) == NULL) {
+			reader->error = 1;
+			return;
+		}
+		ce->num_children = num;
+		for (i = 0; i < num && !reader->error; i++) {
+			read_cfg_element(reader, ce->children + i, ce, i, depth + 1);
+		}
+	}
+}
+
+static void write_plugin(FILE *fh, const cp_plugin_info_t *plugin) {
+	unsigned int i;
+
+	write_str(fh, plugin->identifier);
+	write_str(fh, plugin->name);
+	write_str(fh, plugin->version);
+	write_str(fh, plugin->provider_name);
+	write_str(fh, plugin->plugin_path);
+	write_str(fh, plugin->abi_bw_compatibility);
+	write_str(fh, plugin->api_bw_compatibility);
+	write_str(fh, plugin->req_cpluff_version);
+	write_uint(fh, plugin->num_imports);
+	for (i = 0; i < plugin->num_imports; i++) {
+		write_str(fh, plugin->imports[i].plugin_id);
+		write_str(fh, plugin->imports[i].version);
+		write_uint(fh, plugin->imports[i].optional);
+	}
+	write_str(fh, plugin->runtime_lib_name);
+	write_str(fh, plugin->runtime_funcs_symbol);
+	write_uint(fh, plugin->num_ext_points);
+	for (i = 0; i < plugin->num_ext_points; i++) {
+		write_str(fh, plugin->ext_points[i].local_id);
+		write_str(fh, plugin->ext_points[i].identifier);
+		write_str(fh, plugin->ext_points[i].name);
+		write_str(fh, plugin->ext_points[i].schema_path);
+	}
+	write_uint(fh, plugin->num_extensions);
+	for (i = 0; i < plugin->num_extensions; i++) {
+		write_str(fh, plugin->extensions[i].ext_point_id);
+		write_str(fh, plugin->extensions[i].local_id);
+		write_str(fh, plugin->extensions[i].identifier);
+		write_str(fh, plugin->extensions[i].name);
+		write_uint(fh, plugin->extensions[i].configuration != NULL);
+		if (plugin->extensions[i].configuration != NULL) {
+			write_cfg_element(fh, plugin->extensions[i].configuration);
+		}
+	}
+}
+
+/**
+ * Reads a plug-in descriptor. Counts are only set once the arrays are
+ * allocated, so a partially read descriptor can be freed with
+ * cpi_free_plugin.
+ * 
+ * @param reader the cache file reader
+ * @return the plug-in descriptor or NULL on failure
+ */
+static cp_plugin_info_t *read_plugin(cache_reader_t *reader) {
+	cp_plugin_info_t *plugin;
+	unsigned int i, num;
+
+	if ((plugin = calloc(1, sizeof(cp_plugin_info_t))) == NULL) {
+		reader->error = 1;
+		return NULL;
+	}
+	plugin->identifier = read_str(reader);
+	plugin->name = read_str(reader);
+	plugin->version = read_str(reader);
+	plugin->provider_name = read_str(reader);
+	plugin->plugin_path = read_str(reader);
+	plugin->abi_bw_compatibility = read_str(reader);
+	plugin->api_bw_compatibility = read_str(reader);
+	plugin->req_cpluff_version = read_str(reader);
+	num = read_count(reader);
+	if (num > 0 && !reader->error) {
+		if ((plugin->imports = calloc(num, sizeof(cp_plugin_import_t))) == NULL) {
+			reader->error = 1;
+		} else {
+			plugin->num_imports = num;
+			for (i = 0; i < num; i++) {
+				plugin->imports[i].plugin_id = read_str(reader);
+				plugin->imports[i].version = read_str(reader);
+				plugin->imports[i].optional = (int) read_uint(reader);
+			}
+		}
+	}
+	plugin->runtime_lib_name = read_str(reader);
+	plugin->runtime_funcs_symbol = read_str(reader);
+	num = read_count(reader);
+	if (num > 0 && !reader->error) {
+		if ((plugin->ext_points = calloc(num, sizeof(cp_ext_point_t))) == NULL) {
+			reader->error = 1;
+		} else {
+			plugin->num_ext_points = num;
+			for (i = 0; i < num; i++) {
+				plugin->ext_points[i].plugin = plugin;
+				plugin->ext_points[i].local_id = read_str(reader);
+				plugin->ext_points[i].identifier = read_str(reader);
+				plugin->ext_points[i].name = read_str(reader);
+				plugin->ext_points[i].schema_path = read_str(reader);
+			}
+		}
+	}
+	num = read_count(reader);
+	if (num > 0 && !reader->error) {
+		if ((plugin->extensions = calloc(num, sizeof(cp_extension_t))) == NULL) {
+			reader->error = 1;
+		} else {
+			plugin->num_extensions = num;
+			for (i = 0; i < num && !reader->error; i++) {
+				cp_extension_t *extension = plugin->extensions + i;
+
+				extension->plugin = plugin;
+				extension->ext_point_id = read_str(reader);
+				extension->local_id = read_str(reader);
+				extension->identifier = read_str(reader);
+				extension->name = read_str(reader);
+				if (read_uint(reader) && !reader->error) {
+					if ((extension->configuration = calloc(1, sizeof(cp_cfg_element_t))) == NULL) {
+						reader->error = 1;
+					} else {
+						read_cfg_element(reader, extension->configuration, NULL, 0, 0);
+					}
+				}
+			}
+		}
+	}
+	if (reader->error || plugin->identifier == NULL || plugin->plugin_path == NULL) {
+		cpi_free_plugin(plugin);
+		reader->error = 1;
+		return NULL;
+	}
+	return plugin;
+}
+
+/**
+ * Fills the descriptor cache from the cache file set with
+ * ::cp_set_descriptor_cache_file. A missing, outdated or corrupt file is
+ * ignored, the descriptors are then loaded from the plug-in directories.
+ * The caller must have locked the context.
+ * 
+ * @param context the plug-in context
+ */
+static void load_descriptor_cache_file(cp_context_t *context) {
+	hash_t *cache = context->env->descriptor_cache;
+	const char *file = context->env->descriptor_cache_file;
+	cache_reader_t reader;
+	unsigned char *data = NULL;
+	size_t size = 0;
+	unsigned int i, count;
+	FILE *fh;
+
+	if (cache == NULL || file == NULL || (fh = open_file(file, "rb")) == NULL) {
+		return;
+	}
+	while (!ferror(fh) && !feof(fh)) {
+		unsigned char *new_data = realloc(data, size + 65536);
+
+		if (new_data == NULL) {
+			break;
+		}
+		data = new_data;
+		size += fread(data + size, 1, 65536, fh);
+	}
+	if (!feof(fh)) {
+		fclose(fh);
+		free(data);
+		return;
+	}
+	fclose(fh);
+
+	reader.pos = data;
+	reader.end = data + size;
+	reader.error = 0;
+	if (size < strlen(CP_DESCRIPTOR_CACHE_MAGIC)
+		|| memcmp(data, CP_DESCRIPTOR_CACHE_MAGIC, strlen(CP_DESCRIPTOR_CACHE_MAGIC)) != 0) {
+		cpi_debugf(context, N_("Ignoring outdated plug-in descriptor cache %s."), file);
+		free(data);
+		return;
+	}
+	reader.pos += strlen(CP_DESCRIPTOR_CACHE_MAGIC);
+
+	count = read_count(&reader);
+	for (i = 0; i < count && !reader.error; i++) {
+		descriptor_cache_entry_t *entry;
+		cp_plugin_info_t *plugin;
+		char *path;
+		time_t mtime;
+		long long fsize;
+
+		path = read_str(&reader);
+		mtime = (time_t) read_int64(&reader);
+		fsize = read_int64(&reader);
+		if (path == NULL || (plugin = read_plugin(&reader)) == NULL) {
+			free(path);
+			reader.error = 1;
+			break;
+		}
+		if (hash_lookup(cache, path) != NULL
+			|| (entry = malloc(sizeof(descriptor_cache_entry_t))) == NULL) {
+			cpi_free_plugin(plugin);
+			free(path);
+			continue;
+		}
+		if (cpi_register_info(context, plugin, (void (*)(cp_context_t *, void *)) dealloc_cached_plugin_info) != CP_OK) {
+			cpi_free_plugin(plugin);
+			free(path);
+			free(entry);
+			continue;
+		}
+		entry->path = path;
+		entry->mtime = mtime;
+		entry->size = fsize;
+		entry->scan = 0;
+		entry->plugin = plugin;
+		if (!hash_alloc_insert(cache, entry->path, entry)) {
+			free_descriptor_cache_entry(context, entry);
+		}
+	}
+	free(data);
+
+	if (reader.error) {
+		cpi_warnf(context, N_("Plug-in descriptor cache %s is corrupt."), file);
+	} else {
+		cpi_debugf(context, N_("Read %u plug-in descriptors from %s."), count, file);
+	}
+	context->env->descriptor_cache_dirty = reader.error;
+}
+
+/**
+ * Writes the descriptor cache to the cache file set with
+ * ::cp_set_descriptor_cache_file if it changed. The file is replaced
+ * atomically so an interrupted write never leaves a truncated cache.
+ * The caller must have locked the context.
+ * 
+ * @param context the plug-in context
+ */
+static void save_descriptor_cache_file(cp_context_t *context) {
+	hash_t *cache = context->env->descriptor_cache;
+	const char *file = context->env->descriptor_cache_file;
+	char *tmp_file;
+	hscan_t hscan;
+	hnode_t *hnode;
+	FILE *fh;
+	int failed;
+
+	if (cache == NULL || file == NULL || !context->env->descriptor_cache_dirty) {
+		return;
+	}
+	if ((tmp_file = malloc(strlen(file) + 5)) == NULL) {
+		return;
+	}
+	strcpy(tmp_file, file);
+	strcat(tmp_file, ".tmp");
+	if ((fh = open_file(tmp_file, "wb")) == NULL) {
+		cpi_debugf(context, N_("Could not write plug-in descriptor cache %s."), tmp_file);
+		free(tmp_file);
+		return;
+	}
+
+	fwrite(CP_DESCRIPTOR_CACHE_MAGIC, 1, strlen(CP_DESCRIPTOR_CACHE_MAGIC), fh);
+	write_uint(fh, (unsigned int) hash_count(cache));
+	hash_scan_begin(&hscan, cache);
+	while ((hnode = hash_scan_next(&hscan)) != NULL) {
+		const descriptor_cache_entry_t *entry = hnode_get(hnode);
+
+		write_str(fh, entry->path);
+		write_int64(fh, (long long) entry->mtime);
+		write_int64(fh, entry->size);
+		write_plugin(fh, entry->plugin);
+	}
+	failed = ferror(fh);
+	failed = fclose(fh) != 0 || failed;
+
+	if (failed || replace_file(tmp_file, file) != 0) {
+		cpi_debugf(context, N_("Could not write plug-in descriptor cache %s."), file);
+#if defined(_WIN32)
+		{
+			wchar_t *tmp_fileW = to_utf16(tmp_file, 0);
+			if (tmp_fileW != NULL) {
+				_wremove(tmp_fileW);
+			}
+			free(tmp_fileW);
+		}
+#else
+		remove(tmp_file);
+#endif
+	} else {
+		context->env->descriptor_cache_dirty = 0;
+	}
+	free(tmp_file);
+}
+
+/**
+ * Loads a plug-in descriptor, reusing the descriptor loaded by an earlier
+ * scan if the descriptor file has not been modified since. The caller must
+ * have locked the context and must release the returned descriptor.
+ * 
+ * @param context the plug-in context
+ * @param path the plug-in directory path
+ * @param status pointer to the location where to store the status code
+ * @return the plug-in descriptor or NULL on failure
+ */
+static cp_plugin_info_t *load_cached_descriptor(cp_context_t *context, const char *path, cp_status_t *status) {
+	hash_t *cache = context->env->descriptor_cache;
+	descriptor_cache_entry_t *entry = NULL;
+	cp_plugin_info_t *plugin;
+	hnode_t *hnode;
+	time_t mtime = 0;
+	long long size = 0;
+	int found;
+
+	found = stat_descriptor(path, &mtime, &size);
+	if (cache != NULL && (hnode = hash_lookup(cache, path)) != NULL) {
+		entry = hnode_get(hnode);
+		if (found && entry->mtime == mtime && entry->size == size) {
+			entry->scan = context->env->scan_count;
+			cpi_use_info(context, entry->plugin);
+			*status = CP_OK;
+			return entry->plugin;
+		}
+		hash_delete_free(cache, hnode);
+		free_descriptor_cache_entry(context, entry);
+		entry = NULL;
+		context->env->descriptor_cache_dirty = 1;
+	}
+
+	if ((plugin = cp_load_plugin_descriptor(context, path, status)) == NULL) {
+		return NULL;
+	}
+
+	// Remember the descriptor for the next scan, failure is not fatal
+	if (found && cache != NULL
+		&& (entry = malloc(sizeof(descriptor_cache_entry_t))) != NULL) {
+		if ((entry->path = strdup(path)) != NULL
+			&& hash_alloc_insert(cache, entry->path, entry)) {
+			entry->mtime = mtime;
+			entry->size = size;
+			entry->scan = context->env->scan_count;
+			entry->plugin = plugin;
+			cpi_use_info(context, plugin);
+			context->env->descriptor_cache_dirty = 1;
+		} else {
+			free(entry->path);
+			free(entry);
+		}
+	}
+
+	return plugin;
+}
+
+/**
+ * Drops the cached descriptors of plug-in directories which were not found
+ * by the current scan. The caller must have locked the context.
+ * 
+ * @param context the plug-in context
+ */
+static void expire_descriptor_cache(cp_context_t *context) {
+	hscan_t hscan;
+	hnode_t *hnode;
+
+	if (context->env->descriptor_cache == NULL) {
+		return;
+	}
+	hash_scan_begin(&hscan, context->env->descriptor_cache);
+	while ((hnode = hash_scan_next(&hscan)) != NULL) {
+		descriptor_cache_entry_t *entry = hnode_get(hnode);
+
+		if (entry->scan != context->env->scan_count) {
+			hash_scan_delfree(context->env->descriptor_cache, hnode);
+			free_descriptor_cache_entry(context, entry);
+			context->env->descriptor_cache_dirty = 1;
+		}
+	}
+}
+
+CP_HIDDEN void cpi_free_descriptor_cache(cp_context_t *context) {
+	hscan_t hscan;
+	hnode_t *hnode;
+
+	free(context->env->descriptor_cache_file);
+	context->env->descriptor_cache_file = NULL;
+	if (context->env->descriptor_cache == NULL) {
+		return;
+	}
+	hash_scan_begin(&hscan, context->env->descriptor_cache);
+	while ((hnode = hash_scan_next(&hscan)) != NULL) {
+		descriptor_cache_entry_t *entry = hnode_get(hnode);
+
+		hash_scan_delfree(context->env->descriptor_cache, hnode);
+		free_descriptor_cache_entry(context, entry);
+	}
+	hash_destroy(context->env->descriptor_cache);
+	context->env->descriptor_cache = NULL;
+}
+
+CP_C_API cp_status_t cp_set_descriptor_cache_file(cp_context_t *context, const char *file) {
+	char *f = NULL;
+
+	CHECK_NOT_NULL(context);
+	if (file != NULL && (f = strdup(file)) == NULL) {
+		return CP_ERR_RESOURCE;
+	}
+	cpi_lock_context(context);
+	cpi_check_invocation(context, CPI_CF_ANY, __func__);
+	free(context->env->descriptor_cache_file);
+	context->env->descriptor_cache_file = f;
+	context->env->descriptor_cache_dirty = 1;
+	cpi_unlock_context(context);
+	return CP_OK;
+}
+
 CP_C_API cp_status_t cp_scan_plugins(cp_context_t *context, int flags) {
 	hash_t *avail_plugins = NULL;
 	list_t *started_plugins = NULL;
@@ -71,6 +797,13 @@ CP_C_API cp_status_t cp_scan_plugins(cp_context_t *context, int flags) {
 			status = CP_ERR_RESOURCE;
 			break;
 		}
+
+		// Create the descriptor cache on first scan, scanning works without it
+		if (context->env->descriptor_cache == NULL) {
+			context->env->descriptor_cache = hash_create(HASHCOUNT_T_MAX, (int (*)(const void *, const void *)) strcmp, NULL);
+			load_descriptor_cache_file(context);
+		}
+		context->env->scan_count++;
 	
 		// Scan plug-in directories for available plug-ins 
 		lnode = list_first(context->env->plugin_dirs);
@@ -121,8 +854,8 @@ CP_C_API cp_status_t cp_scan_plugins(cp_context_t *context, int flags) {
 						pdir_path[dir_path_len] = CP_FNAMESEP_CHAR;
 						strcpy(pdir_path + dir_path_len + 1, de->d_name);
 							
-						// Try to load a plug-in 
-						plugin = cp_load_plugin_descriptor(context, pdir_path, &s);
+						// Try to load a plug-in, unchanged descriptors are reused
+						plugin = load_cached_descriptor(context, pdir_path, &s);
 						if (plugin == NULL) {
 							status = s;
 							// continue loading plug-ins from other directories 
@@ -166,6 +899,10 @@ CP_C_API cp_status_t cp_scan_plugins(cp_context_t *context, int flags) {
 			lnode = list_next(context->env->plugin_dirs, lnode);
 		}
 		
+		// Forget plug-ins which have been removed
+		expire_descriptor_cache(context);
+		save_descriptor_cache_file(context);
+
 		// Copy the list of started plug-ins, if necessary 
 		if ((flags & CP_SP_RESTART_ACTIVE)
 			&& (flags & (CP_SP_UPGRADE | CP_SP_STOP_ALL_ON_INSTALL))) {
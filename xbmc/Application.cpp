@@ -19,6 +19,7 @@
 #include "utils/Variant.h"
 #include "LangInfo.h"
 #include "utils/Screenshot.h"
+#include "utils/TraceProfiler.h"
 #include "Util.h"
 #include "URL.h"
 #include "guilib/GUIComponent.h"
@@ -352,6 +353,8 @@ bool CApplication::Create(const CAppParamParser &params)
 {
   // Grab a handle to our thread to be used later in identifying the render thread.
   m_threadID = CThread::GetCurrentThreadId();
+  KODI_TRACE_THREAD_NAME("Main");
+  KODI_TRACE_SCOPE("startup", "CApplication::Create");
 
   m_ServiceManager.reset(new CServiceManager());
 
@@ -963,6 +966,8 @@ void CApplication::CreateUserDirs() const
 
 bool CApplication::Initialize()
 {
+  KODI_TRACE_SCOPE("startup", "CApplication::Initialize");
+
 #if defined(HAS_DVD_DRIVE) && !defined(TARGET_WINDOWS) // somehow this throws an "unresolved external symbol" on win32
   // turn off cdio logging
   cdio_loglevel_default = CDIO_LOG_ERROR;
@@ -1468,6 +1473,8 @@ bool CApplication::Save(TiXmlNode *settings) const
 
 bool CApplication::LoadSkin(const std::string& skinID)
 {
+  KODI_TRACE_SCOPE("gui", "CApplication::LoadSkin");
+
   SkinPtr skin;
   {
     AddonPtr addon;
@@ -1765,6 +1772,8 @@ void CApplication::Render()
   if (m_bStop)
     return;
 
+  KODI_TRACE_SCOPE("frame", "CApplication::Render");
+
   bool hasRendered = false;
 
   // Whether externalplayer is playing and we're unfocused
@@ -2582,6 +2591,8 @@ void CApplication::UnlockFrameMoveGuard()
 
 void CApplication::FrameMove(bool processEvents, bool processGUI)
 {
+  KODI_TRACE_SCOPE("frame", "CApplication::FrameMove");
+
   if (processEvents)
   {
     // currently we calculate the repeat time (ie time from last similar keypress) just global as fps
@@ -18,6 +18,7 @@
 #include "PlayListPlayer.h"
 #include "ServiceBroker.h"
 #include "settings/MediaSettings.h"
+#include "utils/TraceProfiler.h"
 
 CApplicationPlayer::CApplicationPlayer()
 {
@@ -76,6 +77,8 @@ bool CApplicationPlayer::OpenFile(const CFileItem& item, const CPlayerOptions& o
                                   const CPlayerCoreFactory &factory,
                                   const std::string &playerName, IPlayerCallback& callback)
 {
+  KODI_TRACE_SCOPE("player", "CApplicationPlayer::OpenFile");
+
   // get player type
   std::string newPlayer;
   if (!playerName.empty())
@@ -0,0 +1,217 @@
+/*
+ *  Copyright (C) 2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ServiceInitGraph.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "threads/Thread.h"
+#include "utils/log.h"
+#include "utils/TraceProfiler.h"
+
+#include <algorithm>
+#include <cstring>
+
+class CServiceInitWorker : public CThread
+{
+public:
+  explicit CServiceInitWorker(CServiceInitGraph& graph)
+    : CThread("ServiceInit"), m_graph(graph)
+  {
+  }
+
+protected:
+  void Process() override
+  {
+    CSingleLock lock(m_graph.m_critSection);
+    while (!m_graph.IsFinished())
+    {
+      size_t step;
+      if (m_graph.GetReadyStep(false, step))
+      {
+        CSingleExit exit(m_graph.m_critSection);
+        m_graph.RunStep(step);
+      }
+      else
+        m_graph.m_stepFinished.wait(lock);
+    }
+  }
+
+private:
+  CServiceInitGraph& m_graph;
+};
+
+CServiceInitGraph::CServiceInitGraph(const char* name)
+  : m_name(name)
+{
+}
+
+CServiceInitGraph::~CServiceInitGraph() = default;
+
+void CServiceInitGraph::Add(const char* name, const InitFunction& function,
+                            const std::vector<const char*>& dependencies, bool callingThread)
+{
+  Step step;
+  step.name = name;
+  step.function = function;
+  step.callingThread = callingThread;
+
+  for (const char* dependency : dependencies)
+  {
+    auto it = std::find_if(m_steps.begin(), m_steps.end(), [dependency](const Step& other)
+    {
+      return strcmp(other.name, dependency) == 0;
+    });
+    if (it == m_steps.end())
+    {
+      CLog::Log(LOGERROR, "CServiceInitGraph: %s: step %s depends on unknown step %s", m_name, name, dependency);
+      m_valid = false;
+      continue;
+    }
+    step.dependencies.push_back(it - m_steps.begin());
+  }
+
+  m_steps.push_back(std::move(step));
+}
+
+bool CServiceInitGraph::Run(unsigned int maxWorkers)
+{
+  if (!m_valid)
+    return false;
+
+  m_startTime = XbmcThreads::SystemClockMillis();
+  m_pending = m_steps.size();
+
+  // the calling thread runs steps as well, workers are only needed for concurrent steps
+  size_t workerSteps = std::count_if(m_steps.begin(), m_steps.end(), [](const Step& step)
+  {
+    return !step.callingThread;
+  });
+  size_t workerCount = std::min<size_t>(maxWorkers, workerSteps > 0 ? workerSteps - 1 : 0);
+
+  std::vector<std::unique_ptr<CServiceInitWorker>> workers;
+  for (size_t i = 0; i < workerCount; ++i)
+  {
+    workers.emplace_back(new CServiceInitWorker(*this));
+    workers.back()->Create();
+  }
+
+  {
+    CSingleLock lock(m_critSection);
+    while (!IsFinished())
+    {
+      size_t step;
+      if (GetReadyStep(true, step))
+      {
+        CSingleExit exit(m_critSection);
+        RunStep(step);
+      }
+      else
+        m_stepFinished.wait(lock);
+    }
+  }
+
+  for (auto& worker : workers)
+    worker->StopThread(true);
+
+  LogReport(XbmcThreads::SystemClockMillis() - m_startTime);
+
+  return std::all_of(m_steps.begin(), m_steps.end(), [](const Step& step)
+  {
+    return step.state == State::DONE;
+  });
+}
+
+bool CServiceInitGraph::GetReadyStep(bool callingThread, size_t& step)
+{
+  bool found = false;
+  for (size_t i = 0; i < m_steps.size(); ++i)
+  {
+    Step& candidate = m_steps[i];
+    if (candidate.state != State::PENDING)
+      continue;
+
+    bool ready = true;
+    bool skip = false;
+    for (size_t dependency : candidate.dependencies)
+    {
+      State state = m_steps[dependency].state;
+      if (state == State::FAILED || state == State::SKIPPED)
+        skip = true;
+      else if (state != State::DONE)
+        ready = false;
+    }
+
+    // dependencies always precede their dependents, so skipping cascades in a single pass
+    if (skip)
+    {
+      CLog::Log(LOGERROR, "CServiceInitGraph: %s: skipping %s, a dependency failed", m_name, candidate.name);
+      candidate.state = State::SKIPPED;
+      m_pending--;
+      m_stepFinished.notifyAll();
+      continue;
+    }
+
+    if (!ready || (candidate.callingThread && !callingThread))
+      continue;
+
+    // the calling thread prefers the steps only it can run
+    if (!found || (candidate.callingThread && !m_steps[step].callingThread))
+    {
+      step = i;
+      found = true;
+    }
+  }
+
+  if (found)
+    m_steps[step].state = State::RUNNING;
+
+  return found;
+}
+
+bool CServiceInitGraph::IsFinished() const
+{
+  return m_pending == 0;
+}
+
+void CServiceInitGraph::RunStep(size_t index)
+{
+  Step& step = m_steps[index];
+  unsigned int start = XbmcThreads::SystemClockMillis();
+
+  bool success;
+  {
+    KODI_TRACE_SCOPE("startup", step.name);
+    success = step.function();
+  }
+
+  unsigned int end = XbmcThreads::SystemClockMillis();
+  if (!success)
+    CLog::Log(LOGERROR, "CServiceInitGraph: %s: step %s failed", m_name, step.name);
+
+  CSingleLock lock(m_critSection);
+  step.start = start - m_startTime;
+  step.duration = end - start;
+  step.state = success ? State::DONE : State::FAILED;
+  m_pending--;
+  m_stepFinished.notifyAll();
+}
+
+void CServiceInitGraph::LogReport(unsigned int duration) const
+{
+  unsigned int total = 0;
+  for (const auto& step : m_steps)
+  {
+    total += step.duration;
+    CLog::Log(LOGDEBUG, "CServiceInitGraph: %s: %-24s started at %5u ms, took %5u ms%s",
+              m_name, step.name, step.start, step.duration,
+              step.state == State::DONE ? "" : (step.state == State::FAILED ? " (failed)" : " (skipped)"));
+  }
+
+  CLog::Log(LOGNOTICE, "CServiceInitGraph: %s: %u steps finished in %u ms (%u ms sequential)",
+            m_name, static_cast<unsigned int>(m_steps.size()), duration, total);
+}
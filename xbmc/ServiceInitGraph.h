@@ -0,0 +1,97 @@
+/*
+ *  Copyright (C) 2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+
+#include <functional>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class CServiceInitWorker;
+
+/*!
+ \brief Runs the initialization steps of services in dependency order.
+
+ Every step declares the steps it depends on, steps without pending
+ dependencies run concurrently on a small set of worker threads. Steps that
+ have to run on the calling thread (e.g. because they touch the windowing
+ system) are flagged as such. If a step fails, all steps that depend on it are
+ skipped and Run() returns false once the running steps have finished.
+
+ Step names must be string literals, they are used for the timing report and
+ the trace profiler.
+ */
+class CServiceInitGraph
+{
+public:
+  using InitFunction = std::function<bool()>;
+
+  explicit CServiceInitGraph(const char* name);
+  ~CServiceInitGraph();
+
+  /*!
+   \brief Adds an initialization step.
+   \param name name of the step.
+   \param function the step, returns false on failure.
+   \param dependencies steps that have to finish successfully before this one
+          starts. They have to be added before, which keeps the graph acyclic.
+   \param callingThread whether the step has to run on the thread calling Run().
+   */
+  void Add(const char* name, const InitFunction& function,
+           const std::vector<const char*>& dependencies = {}, bool callingThread = false);
+
+  /*!
+   \brief Runs all steps and waits for them to finish.
+   \param maxWorkers maximum number of worker threads.
+   \return false if a step failed or has unknown dependencies.
+   */
+  bool Run(unsigned int maxWorkers = 4);
+
+private:
+  friend class CServiceInitWorker;
+
+  enum class State
+  {
+    PENDING,
+    RUNNING,
+    DONE,
+    FAILED,
+    SKIPPED
+  };
+
+  struct Step
+  {
+    const char* name;
+    InitFunction function;
+    std::vector<size_t> dependencies;
+    bool callingThread;
+    State state = State::PENDING;
+    unsigned int start = 0;
+    unsigned int duration = 0;
+  };
+
+  // must be called with m_critSection held
+  bool GetReadyStep(bool callingThread, size_t& step);
+  bool IsFinished() const;
+  void RunStep(size_t step);
+  void LogReport(unsigned int duration) const;
+
+  const char* m_name;
+  std::vector<Step> m_steps;
+  bool m_valid = true;
+  unsigned int m_startTime = 0;
+  size_t m_pending = 0;
+
+  CCriticalSection m_critSection;
+  XbmcThreads::ConditionVariable m_stepFinished;
+};
@@ -7,6 +7,7 @@
  */
 
 #include "ServiceManager.h"
+#include "ServiceInitGraph.h"
 #include "addons/BinaryAddonCache.h"
 #include "addons/VFSEntry.h"
 #include "addons/binary-addons/BinaryAddonManager.h"
@@ -29,6 +30,7 @@
 #include "network/Network.h"
 #include "settings/Settings.h"
 #include "utils/FileExtensionProvider.h"
+#include "utils/TraceProfiler.h"
 #include "windowing/WinSystem.h"
 #include "powermanagement/PowerManager.h"
 #include "weather/WeatherManager.h"
@@ -79,6 +81,9 @@ bool CServiceManager::InitForTesting()
   m_fileExtensionProvider.reset(new CFileExtensionProvider(*m_addonMgr,
                                                            *m_binaryAddonManager));
 
+  // not started, but PVR tags need it to be constructed
+  m_PVRManager.reset(new PVR::CPVRManager());
+
   init_level = 1;
   return true;
 }
@@ -86,6 +91,7 @@ bool CServiceManager::InitForTesting()
 void CServiceManager::DeinitTesting()
 {
   init_level = 0;
+  m_PVRManager.reset();
   m_fileExtensionProvider.reset();
   m_binaryAddonManager.reset();
   m_addonMgr.reset();
@@ -97,6 +103,8 @@ void CServiceManager::DeinitTesting()
 
 bool CServiceManager::InitStageOne()
 {
+  KODI_TRACE_SCOPE("startup", "CServiceManager::InitStageOne");
+
   m_announcementManager.reset(new ANNOUNCEMENT::CAnnouncementManager());
   m_announcementManager->Start();
 
@@ -125,47 +133,22 @@ bool CServiceManager::InitStageOnePointFive()
 
 bool CServiceManager::InitStageTwo(const CAppParamParser &params)
 {
+  KODI_TRACE_SCOPE("startup", "CServiceManager::InitStageTwo");
+
   // Initialize the addon database (must be before the addon manager is init'd)
   m_databaseManager.reset(new CDatabaseManager);
 
+  // sets the environment on some platforms, before the graph's workers read it
   m_Platform.reset(CPlatform::CreateInstance());
   m_Platform->Init();
 
   m_binaryAddonManager.reset(new ADDON::CBinaryAddonManager()); /* Need to constructed before, GetRunningInstance() of binary CAddonDll need to call them */
   m_addonMgr.reset(new ADDON::CAddonMgr());
-  if (!m_addonMgr->Init())
-  {
-    CLog::Log(LOGFATAL, "CServiceManager::%s: Unable to start CAddonMgr", __FUNCTION__);
-    return false;
-  }
-
-  if (!m_binaryAddonManager->Init())
-  {
-    CLog::Log(LOGFATAL, "CServiceManager::%s: Unable to initialize CBinaryAddonManager", __FUNCTION__);
-    return false;
-  }
-
-  m_repositoryUpdater.reset(new ADDON::CRepositoryUpdater(*m_addonMgr));
-
-  m_vfsAddonCache.reset(new ADDON::CVFSAddonCache());
-  m_vfsAddonCache->Init();
-
-  m_PVRManager.reset(new PVR::CPVRManager());
 
   m_dataCacheCore.reset(new CDataCacheCore());
 
-  m_binaryAddonCache.reset( new ADDON::CBinaryAddonCache());
-  m_binaryAddonCache->Init();
-
-  m_favouritesService.reset(new CFavouritesService(m_profileManager->GetProfileUserDataFolder()));
-
-  m_serviceAddons.reset(new ADDON::CServiceAddonManager(*m_addonMgr));
-
-  m_contextMenuManager.reset(new CContextMenuManager(*m_addonMgr.get()));
-
   m_gameControllerManager.reset(new GAME::CControllerManager);
   m_inputManager.reset(new CInputManager(params));
-  m_inputManager->InitializeInputs();
 
   m_peripherals.reset(new PERIPHERALS::CPeripherals(*m_announcementManager,
                                                     *m_inputManager,
@@ -173,15 +156,98 @@ bool CServiceManager::InitStageTwo(const CAppParamParser &params)
 
   m_gameRenderManager.reset(new RETRO::CGUIGameRenderManager);
 
-  m_fileExtensionProvider.reset(new CFileExtensionProvider(*m_addonMgr,
-                                                           *m_binaryAddonManager));
-
   m_powerManager.reset(new CPowerManager());
-  m_powerManager->Initialize();
-  m_powerManager->SetDefaults();
 
   m_weatherManager.reset(new CWeatherManager());
 
+  // The add-on system is by far the slowest part of this stage, the services
+  // that don't depend on it are initialized while it is loading
+  CServiceInitGraph graph("InitStageTwo");
+
+  graph.Add("addons", [this]()
+  {
+    if (!m_addonMgr->Init())
+    {
+      CLog::Log(LOGFATAL, "CServiceManager::InitStageTwo: Unable to start CAddonMgr");
+      return false;
+    }
+    return true;
+  });
+
+  graph.Add("binaryaddons", [this]()
+  {
+    if (!m_binaryAddonManager->Init())
+    {
+      CLog::Log(LOGFATAL, "CServiceManager::InitStageTwo: Unable to initialize CBinaryAddonManager");
+      return false;
+    }
+    return true;
+  }, { "addons" });
+
+  graph.Add("repositoryupdater", [this]()
+  {
+    m_repositoryUpdater.reset(new ADDON::CRepositoryUpdater(*m_addonMgr));
+    return true;
+  }, { "addons" });
+
+  graph.Add("vfsaddons", [this]()
+  {
+    m_vfsAddonCache.reset(new ADDON::CVFSAddonCache());
+    m_vfsAddonCache->Init();
+    return true;
+  }, { "binaryaddons" });
+
+  graph.Add("pvr", [this]()
+  {
+    m_PVRManager.reset(new PVR::CPVRManager());
+    return true;
+  }, { "vfsaddons" }, true);
+
+  graph.Add("binaryaddoncache", [this]()
+  {
+    m_binaryAddonCache.reset( new ADDON::CBinaryAddonCache());
+    m_binaryAddonCache->Init();
+    return true;
+  }, { "binaryaddons" });
+
+  graph.Add("favourites", [this]()
+  {
+    m_favouritesService.reset(new CFavouritesService(m_profileManager->GetProfileUserDataFolder()));
+    return true;
+  });
+
+  graph.Add("addonservices", [this]()
+  {
+    m_serviceAddons.reset(new ADDON::CServiceAddonManager(*m_addonMgr));
+    m_contextMenuManager.reset(new CContextMenuManager(*m_addonMgr.get()));
+    return true;
+  }, { "addons" });
+
+  graph.Add("input", [this]()
+  {
+    m_inputManager->InitializeInputs();
+    return true;
+  }, {}, true);
+
+  graph.Add("fileextensions", [this]()
+  {
+    m_fileExtensionProvider.reset(new CFileExtensionProvider(*m_addonMgr,
+                                                             *m_binaryAddonManager));
+    return true;
+  }, { "binaryaddons" });
+
+  // The power syscalls register their notifications with the run loop of the
+  // calling thread on macOS, they would stop when a worker thread exits
+  graph.Add("power", [this]()
+  {
+    m_powerManager->Initialize();
+    m_powerManager->SetDefaults();
+    return true;
+  }, {}, true);
+
+  if (!graph.Run())
+    return false;
+
   init_level = 2;
   return true;
 }
@@ -189,6 +255,8 @@ bool CServiceManager::InitStageTwo(const CAppParamParser &params)
 // stage 3 is called after successful initialization of WindowManager
 bool CServiceManager::InitStageThree()
 {
+  KODI_TRACE_SCOPE("startup", "CServiceManager::InitStageThree");
+
   // Peripherals depends on strings being loaded before stage 3
   m_peripherals->Initialise();
 
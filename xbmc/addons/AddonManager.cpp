@@ -13,9 +13,11 @@
 #include "events/AddonManagementEvent.h"
 #include "events/EventLog.h"
 #include "events/NotificationEvent.h"
+#include "filesystem/Directory.h"
 #include "filesystem/File.h"
 #include "filesystem/SpecialProtocol.h"
 #include "settings/AdvancedSettings.h"
+#include "threads/SystemClock.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
@@ -34,6 +36,7 @@ void cp_logger(cp_log_severity_t level, const char *msg, const char *apid, void
 namespace {
 // Note that all of these characters are url-safe
 const std::string VALID_ADDON_IDENTIFIER_CHARACTERS = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789.-_@!$";
+const std::string ADDON_DESCRIPTOR_CACHE_FOLDER = "special://masterprofile/Cache/";
 }
 
 /**********************************************************
@@ -312,6 +315,8 @@ bool CAddonMgr::Init()
 {
   CSingleLock lock(m_critSection);
 
+  unsigned int start = XbmcThreads::SystemClockMillis();
+
   cp_set_fatal_error_handler(cp_fatalErrorHandler);
 
   cp_status_t status;
@@ -325,6 +330,11 @@ bool CAddonMgr::Init()
   //! @todo could separate addons into different contexts would allow partial unloading of addon framework
   m_cp_context = cp_create_context(&status);
   assert(m_cp_context);
+
+  // parsed add-on descriptors are persisted, so only new or changed addon.xml files are parsed at startup
+  if (CDirectory::Exists(ADDON_DESCRIPTOR_CACHE_FOLDER) || CDirectory::Create(ADDON_DESCRIPTOR_CACHE_FOLDER))
+    cp_set_descriptor_cache_file(m_cp_context, CSpecialProtocol::TranslatePath(ADDON_DESCRIPTOR_CACHE_FOLDER + "addons.cache").c_str());
+
   status = cp_register_pcollection(m_cp_context, CSpecialProtocol::TranslatePath("special://home/addons").c_str());
   if (status != CP_OK)
   {
@@ -353,6 +363,8 @@ bool CAddonMgr::Init()
     return false;
   }
 
+  unsigned int frameworkTime = XbmcThreads::SystemClockMillis();
+
   if (!LoadManifest(m_systemAddons, m_optionalAddons))
   {
     CLog::Log(LOGERROR, "ADDONS: Failed to read manifest");
@@ -362,8 +374,14 @@ bool CAddonMgr::Init()
  if (!m_database.Open())
    CLog::Log(LOGFATAL, "ADDONS: Failed to open database");
 
+  unsigned int databaseTime = XbmcThreads::SystemClockMillis();
+
   FindAddons();
 
+  unsigned int end = XbmcThreads::SystemClockMillis();
+  CLog::Log(LOGNOTICE, "ADDONS: initialized in %u ms (framework %u ms, manifest and database %u ms, scan %u ms)",
+            end - start, frameworkTime - start, databaseTime - frameworkTime, end - databaseTime);
+
   //Ensure required add-ons are installed and enabled
   for (const auto& id : m_systemAddons)
   {
@@ -685,7 +703,9 @@ bool CAddonMgr::FindAddons()
   if (m_cp_context)
   {
     result = true;
+    unsigned int start = XbmcThreads::SystemClockMillis();
     cp_scan_plugins(m_cp_context, CP_SP_UPGRADE);
+    unsigned int scanTime = XbmcThreads::SystemClockMillis();
 
     //Sync with db
     {
@@ -700,6 +720,8 @@ bool CAddonMgr::FindAddons()
       }
       cp_release_info(m_cp_context, cp_addons);
       m_database.SyncInstalled(installed, m_systemAddons, m_optionalAddons);
+      CLog::Log(LOGDEBUG, "CAddonMgr::%s: scanned %d add-ons in %u ms, database sync took %u ms", __FUNCTION__,
+                n, scanTime - start, XbmcThreads::SystemClockMillis() - scanTime);
     }
 
     // Reload caches
@@ -42,6 +42,12 @@ extern "C" {
 
 using namespace ADDON;
 
+namespace
+{
+  // Entries transferred by add-on calls made on this thread are queued here, if set
+  thread_local PVR::CPVRClient::TransferQueue* transferQueue = nullptr;
+}
+
 namespace PVR
 {
 
@@ -1228,6 +1234,19 @@ const char *CPVRClient::ToString(const PVR_ERROR error)
   }
 }
 
+void CPVRClient::SetTransferQueue(TransferQueue* queue)
+{
+  transferQueue = queue;
+}
+
+void CPVRClient::Transfer(std::function<void()> transfer)
+{
+  if (transferQueue)
+    transferQueue->emplace_back(std::move(transfer));
+  else
+    transfer();
+}
+
 PVR_ERROR CPVRClient::DoAddonCall(const char* strFunctionName, std::function<PVR_ERROR(const AddonInstance*)> function, bool bIsImplemented /* = true */, bool bCheckReadyToUse /* = true */) const
 {
   // Check preconditions.
@@ -1443,8 +1462,11 @@ void CPVRClient::cb_transfer_channel_group(void *kodiInstance, const ADDON_HANDL
   }
 
   /* transfer this entry to the groups container */
-  CPVRChannelGroup transferGroup(*group);
-  kodiGroups->UpdateFromClient(transferGroup);
+  const PVR_CHANNEL_GROUP entry = *group;
+  Transfer([kodiGroups, entry]() {
+    CPVRChannelGroup transferGroup(entry);
+    kodiGroups->UpdateFromClient(transferGroup);
+  });
 }
 
 void CPVRClient::cb_transfer_channel_group_member(void *kodiInstance, const ADDON_HANDLE handle, const PVR_CHANNEL_GROUP_MEMBER *member)
@@ -1463,16 +1485,20 @@ void CPVRClient::cb_transfer_channel_group_member(void *kodiInstance, const ADDO
     return;
   }
 
-  CPVRChannelPtr channel  = CServiceBroker::GetPVRManager().ChannelGroups()->GetByUniqueID(member->iChannelUniqueId, client->GetID());
-  if (!channel)
-  {
-    CLog::LogF(LOGERROR, "Cannot find group '%s' or channel '%d'", member->strGroupName, member->iChannelUniqueId);
-  }
-  else if (group->IsRadio() == channel->IsRadio())
-  {
-    /* transfer this entry to the group */
-    group->AddToGroup(channel, CPVRChannelNumber(member->iChannelNumber, member->iSubChannelNumber), true);
-  }
+  const PVR_CHANNEL_GROUP_MEMBER entry = *member;
+  const int iClientId = client->GetID();
+  Transfer([group, entry, iClientId]() {
+    CPVRChannelPtr channel  = CServiceBroker::GetPVRManager().ChannelGroups()->GetByUniqueID(entry.iChannelUniqueId, iClientId);
+    if (!channel)
+    {
+      CLog::LogFunction(LOGERROR, "cb_transfer_channel_group_member", "Cannot find group '%s' or channel '%d'", entry.strGroupName, entry.iChannelUniqueId);
+    }
+    else if (group->IsRadio() == channel->IsRadio())
+    {
+      /* transfer this entry to the group */
+      group->AddToGroup(channel, CPVRChannelNumber(entry.iChannelNumber, entry.iSubChannelNumber), true);
+    }
+  });
 }
 
 void CPVRClient::cb_transfer_epg_entry(void *kodiInstance, const ADDON_HANDLE handle, const EPG_TAG *epgentry)
@@ -1513,7 +1539,9 @@ void CPVRClient::cb_transfer_channel_entry(void *kodiInstance, const ADDON_HANDL
 
   /* transfer this entry to the internal channels group */
   CPVRChannelPtr transferChannel(new CPVRChannel(*channel, client->GetID()));
-  kodiChannels->UpdateFromClient(transferChannel, CPVRChannelNumber());
+  Transfer([kodiChannels, transferChannel]() {
+    kodiChannels->UpdateFromClient(transferChannel, CPVRChannelNumber());
+  });
 }
 
 void CPVRClient::cb_transfer_recording_entry(void *kodiInstance, const ADDON_HANDLE handle, const PVR_RECORDING *recording)
@@ -1533,8 +1561,12 @@ void CPVRClient::cb_transfer_recording_entry(void *kodiInstance, const ADDON_HAN
   }
 
   /* transfer this entry to the recordings container */
-  CPVRRecordingPtr transferRecording(new CPVRRecording(*recording, client->GetID()));
-  kodiRecordings->UpdateFromClient(transferRecording);
+  const PVR_RECORDING entry = *recording;
+  const int iClientId = client->GetID();
+  Transfer([kodiRecordings, entry, iClientId]() {
+    CPVRRecordingPtr transferRecording(new CPVRRecording(entry, iClientId));
+    kodiRecordings->UpdateFromClient(transferRecording);
+  });
 }
 
 void CPVRClient::cb_transfer_timer_entry(void *kodiInstance, const ADDON_HANDLE handle, const PVR_TIMER *timer)
@@ -1553,12 +1585,16 @@ void CPVRClient::cb_transfer_timer_entry(void *kodiInstance, const ADDON_HANDLE
     return;
   }
 
-  /* Note: channel can be NULL here, for instance for epg-based timer rules ("record on any channel" condition). */
-  CPVRChannelPtr channel = CServiceBroker::GetPVRManager().ChannelGroups()->GetByUniqueID(timer->iClientChannelUid, client->GetID());
+  const PVR_TIMER entry = *timer;
+  const int iClientId = client->GetID();
+  Transfer([kodiTimers, entry, iClientId]() {
+    /* Note: channel can be NULL here, for instance for epg-based timer rules ("record on any channel" condition). */
+    CPVRChannelPtr channel = CServiceBroker::GetPVRManager().ChannelGroups()->GetByUniqueID(entry.iClientChannelUid, iClientId);
 
-  /* transfer this entry to the timers container */
-  CPVRTimerInfoTagPtr transferTimer(new CPVRTimerInfoTag(*timer, channel, client->GetID()));
-  kodiTimers->UpdateFromClient(transferTimer);
+    /* transfer this entry to the timers container */
+    CPVRTimerInfoTagPtr transferTimer(new CPVRTimerInfoTag(entry, channel, iClientId));
+    kodiTimers->UpdateFromClient(transferTimer);
+  });
 }
 
 void CPVRClient::cb_add_menu_hook(void *kodiInstance, PVR_MENUHOOK *hook)
@@ -798,6 +798,14 @@ namespace PVR
 
     static const char *ToString(const PVR_ERROR error);
 
+    typedef std::vector<std::function<void()>> TransferQueue;
+
+    /*!
+     * @brief Queue the entries the add-on transfers during calls made on the current thread, instead of adding them to their containers right away.
+     * @param queue The queue to add the transfers to, nullptr to add entries right away again. Running the queued transfers adds the entries.
+     */
+    static void SetTransferQueue(TransferQueue* queue);
+
     /*!
      * @brief Check whether timeshifting is active for the currently playing stream, if any.
      * @param bTimeshifting True, if timeshifting is active, false otherwise.
@@ -927,6 +935,12 @@ namespace PVR
                           bool bIsImplemented = true,
                           bool bCheckReadyToUse = true) const;
 
+    /*!
+     * @brief Add an entry transferred by the add-on now, or queue it if a transfer queue is set for the current thread.
+     * @param transfer The function adding the entry to its container.
+     */
+    static void Transfer(std::function<void()> transfer);
+
     /*!
      * @brief Callback functions from addon to kodi
      */
@@ -9,6 +9,7 @@
 #include "RetroPlayerAutoSave.h"
 #include "cores/RetroPlayer/playback/IPlayback.h"
 #include "games/GameSettings.h"
+#include "threads/SystemClock.h"
 #include "utils/log.h"
 #include "URL.h"
 
@@ -51,9 +52,12 @@ void CRetroPlayerAutoSave::Process()
 
     if (m_callback.IsAutoSaveEnabled())
     {
+      const unsigned int startTime = XbmcThreads::SystemClockMillis();
+
       std::string savePath = m_callback.CreateSavestate();
       if (!savePath.empty())
-        CLog::Log(LOGDEBUG, "RetroPlayer[SAVE]: Saved state to %s", CURL::GetRedacted(savePath).c_str());
+        CLog::Log(LOGDEBUG, "RetroPlayer[SAVE]: Saved state to %s in %u ms", CURL::GetRedacted(savePath).c_str(),
+                  XbmcThreads::SystemClockMillis() - startTime);
     }
   }
 
@@ -9,14 +9,17 @@
 #include "ReversiblePlayback.h"
 #include "cores/RetroPlayer/savestates/ISavestate.h"
 #include "cores/RetroPlayer/savestates/SavestateDatabase.h"
-#include "cores/RetroPlayer/streams/memory/DeltaPairMemoryStream.h"
+#include "cores/RetroPlayer/streams/memory/CompressedDeltaMemoryStream.h"
 #include "games/addons/GameClient.h"
 #include "games/GameServices.h"
 #include "games/GameSettings.h"
 #include "threads/SingleLock.h"
+#include "utils/log.h"
 #include "utils/MathUtils.h"
+#include "utils/TimeUtils.h"
 #include "utils/URIUtils.h"
 #include "ServiceBroker.h"
+#include "URL.h"
 
 #include <algorithm>
 
@@ -24,6 +27,7 @@ using namespace KODI;
 using namespace RETRO;
 
 #define REWIND_FACTOR  0.25  // Rewind at 25% of gameplay speed
+#define REWIND_MEMORY_BUDGET  (64 * 1024 * 1024) // Max memory used by the rewind history
 
 CReversiblePlayback::CReversiblePlayback(GAME::CGameClient* gameClient, double fps, size_t serializeSize) :
   m_gameClient(gameClient),
@@ -127,7 +131,16 @@ std::string CReversiblePlayback::CreateSavestate()
   const std::string gameClientId = m_gameClient->ID();
   const std::string gameClientVersion = m_gameClient->Version().asString();
 
-  std::unique_ptr<ISavestate> savestate = m_savestateDatabase->CreateSavestate();
+  const int64_t startTime = CurrentHostCounter();
+
+  CSingleLock savestateLock(m_savestateMutex);
+
+  if (m_savestate)
+    m_savestate->Reset();
+  else
+    m_savestate = m_savestateDatabase->CreateSavestate();
+
+  ISavestate *savestate = m_savestate.get();
 
   savestate->SetType(SAVE_TYPE::AUTO);
   savestate->SetLabel(label);
@@ -140,11 +153,21 @@ std::string CReversiblePlayback::CreateSavestate()
 
   uint8_t *memoryData = savestate->GetMemoryBuffer(memorySize);
 
+  // The game loop is blocked while the mutex is held, so only copy the
+  // memory here. Compressing and writing happens after it is released.
+  int64_t lockedTime = 0;
+  uint64_t maxFrameTimeUs = 0;
   {
     CSingleLock lock(m_mutex);
+    const int64_t lockTime = CurrentHostCounter();
+
+    maxFrameTimeUs = m_maxFrameTimeUs;
+    m_maxFrameTimeUs = 0;
+
     if (m_memoryStream && m_memoryStream->CurrentFrame() != nullptr)
     {
       std::memcpy(memoryData, m_memoryStream->CurrentFrame(), memorySize);
+      lockedTime = CurrentHostCounter() - lockTime;
     }
     else
     {
@@ -154,12 +177,43 @@ std::string CReversiblePlayback::CreateSavestate()
     }
   }
 
+  const int64_t frequencyUs = CurrentHostFrequency() / 1000000;
+  if (frequencyUs > 0)
+  {
+    CLog::Log(LOGDEBUG, "RetroPlayer[SAVE]: Snapshot of %u bytes took %lld us (%lld us holding the game loop), "
+              "longest frame since last snapshot %llu us",
+              static_cast<unsigned int>(memorySize),
+              static_cast<long long>((CurrentHostCounter() - startTime) / frequencyUs),
+              static_cast<long long>(lockedTime / frequencyUs),
+              static_cast<unsigned long long>(maxFrameTimeUs));
+  }
+
+  const std::string gamePath = m_gameClient->GetGamePath();
+
+  const int64_t finalizeTime = CurrentHostCounter();
+
   savestate->Finalize();
 
-  if (!m_savestateDatabase->AddSavestate(m_gameClient->GetGamePath(), *savestate))
+  const int64_t writeTime = CurrentHostCounter();
+
+  const uint8_t *data = nullptr;
+  size_t size = 0;
+  savestate->Serialize(data, size);
+
+  if (!m_savestateDatabase->AddSavestate(gamePath, *savestate))
+  {
+    CLog::Log(LOGERROR, "RetroPlayer[SAVE]: Failed to save state for %s", CURL::GetRedacted(gamePath).c_str());
     return "";
+  }
+
+  const double frequencyMs = CurrentHostFrequency() / 1000.0;
+  CLog::Log(LOGDEBUG, "RetroPlayer[SAVE]: Wrote %u bytes of memory as %u bytes, compressing took %.2f ms, writing took %.2f ms",
+            static_cast<unsigned int>(memorySize),
+            static_cast<unsigned int>(size),
+            (writeTime - finalizeTime) / frequencyMs,
+            (CurrentHostCounter() - writeTime) / frequencyMs);
 
-  return m_gameClient->GetGamePath();
+  return gamePath;
 }
 
 bool CReversiblePlayback::LoadSavestate(const std::string& path)
@@ -172,6 +226,9 @@ bool CReversiblePlayback::LoadSavestate(const std::string& path)
 
   bool bSuccess = false;
 
+  // Don't read a savestate that is still being written
+  CSingleLock savestateLock(m_savestateMutex);
+
   std::unique_ptr<ISavestate> savestate = m_savestateDatabase->CreateSavestate();
   if (m_savestateDatabase->GetSavestate(path, *savestate) && savestate->GetMemorySize() == memorySize)
   {
@@ -211,6 +268,9 @@ void CReversiblePlayback::RewindEvent()
 
 void CReversiblePlayback::AddFrame()
 {
+  // Includes the time spent waiting for a savestate snapshot
+  const int64_t startTime = CurrentHostCounter();
+
   CSingleLock lock(m_mutex);
 
   if (m_memoryStream)
@@ -223,6 +283,9 @@ void CReversiblePlayback::AddFrame()
   }
 
   m_totalFrameCount++;
+
+  const uint64_t frameTimeUs = (CurrentHostCounter() - startTime) * 1000000 / CurrentHostFrequency();
+  m_maxFrameTimeUs = std::max(m_maxFrameTimeUs, frameTimeUs);
 }
 
 void CReversiblePlayback::RewindFrames(uint64_t frames)
@@ -300,7 +363,7 @@ void CReversiblePlayback::UpdateMemoryStream()
 
     if (!m_memoryStream)
     {
-      m_memoryStream.reset(new CDeltaPairMemoryStream);
+      m_memoryStream.reset(new CCompressedDeltaMemoryStream(REWIND_MEMORY_BUDGET));
       m_memoryStream->Init(m_gameClient->SerializeSize(), frameCount);
     }
 
@@ -28,6 +28,7 @@ namespace RETRO
 {
   class CSavestateDatabase;
   class IMemoryStream;
+  class ISavestate;
 
   class CReversiblePlayback : public IPlayback,
                               public IGameLoopCallback,
@@ -77,6 +78,8 @@ namespace RETRO
 
     // Savestate functionality
     std::unique_ptr<CSavestateDatabase> m_savestateDatabase;
+    std::unique_ptr<ISavestate> m_savestate; // Reused, so autosaves don't allocate
+    CCriticalSection m_savestateMutex;
 
     // Playback stats
     uint64_t m_totalFrameCount;
@@ -85,6 +88,9 @@ namespace RETRO
     unsigned int m_playTimeMs;
     unsigned int m_totalTimeMs;
     unsigned int m_cacheTimeMs;
+
+    // Frame time stats, the longest time spent adding a frame since the last savestate
+    uint64_t m_maxFrameTimeUs = 0;
   };
 }
 }
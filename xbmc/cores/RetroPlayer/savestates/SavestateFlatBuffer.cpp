@@ -7,16 +7,27 @@
  */
 
 #include "SavestateFlatBuffer.h"
+#include "utils/Crc32.h"
 #include "utils/log.h"
 
 #include "savestate_generated.h"
 
+#include <lzo/lzo1x.h>
+
 using namespace KODI;
 using namespace RETRO;
 
 namespace
 {
-  const uint8_t SCHEMA_VERSION = 1;
+  const uint8_t SCHEMA_VERSION = 2;
+
+  /*!
+   * \brief The oldest schema version that can still be read
+   *
+   * Version 2 only appended the memory compression fields, which default to
+   * uncompressed memory.
+   */
+  const uint8_t MIN_SCHEMA_VERSION = 1;
 
   /*!
    * \brief The initial size of the FlatBuffer's memory buffer
@@ -26,6 +37,16 @@ namespace
    */
   const size_t INITIAL_FLATBUFFER_SIZE = 1024;
 
+  /*!
+   * \brief The largest ratio of uncompressed to compressed memory
+   *
+   * LZO encodes a long run of repeated bytes with one more byte for every 255
+   * bytes of the run, so it can't compress better than this. A savestate
+   * claiming a larger memory size is corrupt, and allocating that size could
+   * take gigabytes.
+   */
+  const size_t MAX_COMPRESSION_RATIO = 256;
+
   /*!
    * \brief Translate the save type (RetroPlayer to FlatBuffers)
    */
@@ -61,6 +82,22 @@ namespace
 
     return SAVE_TYPE::UNKNOWN;
   }
+
+  /*!
+   * \brief Initialize the LZO library once per process
+   */
+  bool InitializeLZO()
+  {
+    static const bool bInitialized = (lzo_init() == LZO_E_OK);
+    return bInitialized;
+  }
+
+  uint32_t ComputeCrc(const uint8_t *data, size_t size)
+  {
+    Crc32 crc;
+    crc.Compute(reinterpret_cast<const char*>(data), size);
+    return crc;
+  }
 }
 
 CSavestateFlatBuffer::CSavestateFlatBuffer()
@@ -72,9 +109,23 @@ CSavestateFlatBuffer::~CSavestateFlatBuffer() = default;
 
 void CSavestateFlatBuffer::Reset()
 {
-  m_builder.reset(new flatbuffers::FlatBufferBuilder(INITIAL_FLATBUFFER_SIZE));
+  // Keep the builder's buffer around, a reset savestate is usually reused
+  // for a savestate of the same size
+  if (m_builder)
+    m_builder->Clear();
+  else
+    m_builder.reset(new flatbuffers::FlatBufferBuilder(INITIAL_FLATBUFFER_SIZE));
   m_data.clear();
   m_savestate = nullptr;
+  m_memory.clear();
+  m_bMemoryDecompressed = false;
+  m_bHasMemory = false;
+  m_labelOffset.reset();
+  m_createdOffset.reset();
+  m_gameFileNameOffset.reset();
+  m_emulatorAddonIdOffset.reset();
+  m_emulatorVersionOffset.reset();
+  m_memoryDataOffset.reset();
 }
 
 bool CSavestateFlatBuffer::Serialize(const uint8_t *&data, size_t &size) const
@@ -220,6 +271,9 @@ void CSavestateFlatBuffer::SetGameClientVersion(const std::string &gameClientVer
 
 const uint8_t *CSavestateFlatBuffer::GetMemoryData() const
 {
+  if (m_bMemoryDecompressed)
+    return m_memory.data();
+
   if (m_savestate != nullptr && m_savestate->memory_data())
     return m_savestate->memory_data()->data();
 
@@ -228,6 +282,9 @@ const uint8_t *CSavestateFlatBuffer::GetMemoryData() const
 
 size_t CSavestateFlatBuffer::GetMemorySize() const
 {
+  if (m_bMemoryDecompressed)
+    return m_memory.size();
+
   if (m_savestate != nullptr && m_savestate->memory_data())
     return m_savestate->memory_data()->size();
 
@@ -236,15 +293,38 @@ size_t CSavestateFlatBuffer::GetMemorySize() const
 
 uint8_t *CSavestateFlatBuffer::GetMemoryBuffer(size_t size)
 {
-  uint8_t *memoryBuffer = nullptr;
-
-  m_memoryDataOffset.reset(new VectorOffset{ m_builder->CreateUninitializedVector(size, &memoryBuffer) });
+  // The memory is staged uncompressed and compressed into the FlatBuffer by
+  // Finalize(), so filling the buffer is a plain copy
+  m_memory.resize(size);
+  m_bMemoryDecompressed = false;
+  m_bHasMemory = true;
 
-  return memoryBuffer;
+  return m_memory.data();
 }
 
 void CSavestateFlatBuffer::Finalize()
 {
+  MemoryCompression compression = MemoryCompression_None;
+  uint32_t memoryCrc = 0;
+
+  if (m_bHasMemory)
+  {
+    memoryCrc = ComputeCrc(m_memory.data(), m_memory.size());
+
+    if (CompressMemory())
+    {
+      m_memoryDataOffset.reset(new VectorOffset{ m_builder->CreateVector(m_compressedMemory.data(), m_compressedSize) });
+      compression = MemoryCompression_LZO;
+    }
+    else
+    {
+      m_memoryDataOffset.reset(new VectorOffset{ m_builder->CreateVector(m_memory) });
+    }
+
+    m_bMemoryDecompressed = true;
+    m_bHasMemory = false;
+  }
+
   // Helper class to build the nested Savestate table
   SavestateBuilder savestateBuilder(*m_builder);
 
@@ -293,6 +373,10 @@ void CSavestateFlatBuffer::Finalize()
   {
     savestateBuilder.add_memory_data(*m_memoryDataOffset);
     m_memoryDataOffset.reset();
+
+    savestateBuilder.add_memory_compression(compression);
+    savestateBuilder.add_memory_size(m_memory.size());
+    savestateBuilder.add_memory_crc(memoryCrc);
   }
 
   auto savestate = savestateBuilder.Finish();
@@ -308,7 +392,7 @@ bool CSavestateFlatBuffer::Deserialize(std::vector<uint8_t> data)
   {
     const Savestate *savestate = GetSavestate(data.data());
 
-    if (savestate->version() != SCHEMA_VERSION)
+    if (savestate->version() < MIN_SCHEMA_VERSION || savestate->version() > SCHEMA_VERSION)
     {
       CLog::Log(LOGERROR, "RetroPlayer[SAVE): Schema version %u not supported, must be version %u",
         savestate->version(),
@@ -318,9 +402,105 @@ bool CSavestateFlatBuffer::Deserialize(std::vector<uint8_t> data)
     {
       m_data = std::move(data);
       m_savestate = GetSavestate(m_data.data());
-      return true;
+      m_memory.clear();
+      m_bMemoryDecompressed = false;
+
+      if (DecompressMemory())
+        return true;
+
+      m_data.clear();
+      m_savestate = nullptr;
     }
   }
 
   return false;
 }
+
+bool CSavestateFlatBuffer::CompressMemory()
+{
+  if (m_memory.empty() || !InitializeLZO())
+    return false;
+
+  // Worst case expansion of incompressible data, see the LZO FAQ
+  const size_t maxCompressedSize = m_memory.size() + m_memory.size() / 16 + 64 + 3;
+  if (m_compressedMemory.size() < maxCompressedSize)
+    m_compressedMemory.resize(maxCompressedSize);
+
+  if (!m_workMemory)
+    m_workMemory.reset(new uint8_t[LZO1X_1_MEM_COMPRESS]);
+
+  lzo_uint compressedSize = 0;
+  if (lzo1x_1_compress(m_memory.data(), static_cast<lzo_uint>(m_memory.size()),
+                       m_compressedMemory.data(), &compressedSize, m_workMemory.get()) != LZO_E_OK)
+    return false;
+
+  // Store the memory uncompressed if it doesn't pay off
+  if (compressedSize >= m_memory.size())
+    return false;
+
+  m_compressedSize = static_cast<size_t>(compressedSize);
+  return true;
+}
+
+bool CSavestateFlatBuffer::DecompressMemory()
+{
+  const flatbuffers::Vector<uint8_t> *memoryData = m_savestate->memory_data();
+  if (memoryData == nullptr)
+    return true;
+
+  switch (m_savestate->memory_compression())
+  {
+  case MemoryCompression_None:
+  {
+    // Version 1 savestates don't have a checksum
+    if (m_savestate->version() >= 2 && ComputeCrc(memoryData->data(), memoryData->size()) != m_savestate->memory_crc())
+    {
+      CLog::Log(LOGERROR, "RetroPlayer[SAVE]: Savestate memory is corrupt, checksum mismatch");
+      return false;
+    }
+    return true;
+  }
+  case MemoryCompression_LZO:
+    break;
+  default:
+    CLog::Log(LOGERROR, "RetroPlayer[SAVE]: Unknown memory compression %u",
+      static_cast<unsigned int>(m_savestate->memory_compression()));
+    return false;
+  }
+
+  if (!InitializeLZO())
+  {
+    CLog::Log(LOGERROR, "RetroPlayer[SAVE]: Failed to initialize lzo");
+    return false;
+  }
+
+  const uint64_t memorySize = m_savestate->memory_size();
+  if (memorySize == 0 || memorySize / MAX_COMPRESSION_RATIO > memoryData->size())
+  {
+    CLog::Log(LOGERROR, "RetroPlayer[SAVE]: Savestate memory is corrupt, %llu bytes can't be compressed to %u bytes",
+      static_cast<unsigned long long>(memorySize),
+      static_cast<unsigned int>(memoryData->size()));
+    return false;
+  }
+
+  m_memory.resize(static_cast<size_t>(memorySize));
+
+  lzo_uint size = static_cast<lzo_uint>(m_memory.size());
+  if (lzo1x_decompress_safe(memoryData->data(), static_cast<lzo_uint>(memoryData->size()),
+                            m_memory.data(), &size, nullptr) != LZO_E_OK || size != m_memory.size())
+  {
+    CLog::Log(LOGERROR, "RetroPlayer[SAVE]: Failed to decompress savestate memory");
+    m_memory.clear();
+    return false;
+  }
+
+  if (ComputeCrc(m_memory.data(), m_memory.size()) != m_savestate->memory_crc())
+  {
+    CLog::Log(LOGERROR, "RetroPlayer[SAVE]: Savestate memory is corrupt, checksum mismatch");
+    m_memory.clear();
+    return false;
+  }
+
+  m_bMemoryDecompressed = true;
+  return true;
+}
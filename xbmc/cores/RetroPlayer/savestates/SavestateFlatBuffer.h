@@ -60,6 +60,18 @@ namespace RETRO
     bool Deserialize(std::vector<uint8_t> data) override;
 
   private:
+    /*!
+     * \brief Compress the staged memory into m_compressedMemory
+     *
+     * \return False if the memory should be stored uncompressed
+     */
+    bool CompressMemory();
+
+    /*!
+     * \brief Decompress and verify the memory of a deserialized savestate
+     */
+    bool DecompressMemory();
+
     /*!
      * \brief Helper class to hold data needed in creation of a FlatBuffer
      *
@@ -79,6 +91,22 @@ namespace RETRO
      */
     const Savestate *m_savestate = nullptr;
 
+    /*!
+     * \brief Uncompressed memory
+     *
+     * When building, this stages the memory until Finalize() compresses it.
+     * When deserializing, this holds the decompressed memory. Its capacity is
+     * kept on Reset() so reused savestates don't reallocate.
+     */
+    std::vector<uint8_t> m_memory;
+    bool m_bMemoryDecompressed = false;
+    bool m_bHasMemory = false;
+
+    // Compression buffers, kept for reuse
+    std::vector<uint8_t> m_compressedMemory;
+    size_t m_compressedSize = 0;
+    std::unique_ptr<uint8_t[]> m_workMemory;
+
     using StringOffset = flatbuffers::Offset<flatbuffers::String>;
     using VectorOffset = flatbuffers::Offset<flatbuffers::Vector<uint8_t>>;
 
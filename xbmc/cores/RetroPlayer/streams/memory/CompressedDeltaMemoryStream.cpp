@@ -0,0 +1,310 @@
+/*
+ *  Copyright (C) 2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "CompressedDeltaMemoryStream.h"
+#include "utils/log.h"
+#include "utils/TimeUtils.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace KODI;
+using namespace RETRO;
+
+namespace
+{
+  // Worst case size of a varint encoded size_t
+  const size_t MAX_VARINT_SIZE = 10;
+
+  inline uint8_t* WriteVarint(uint8_t* output, size_t value)
+  {
+    while (value >= 0x80)
+    {
+      *output++ = static_cast<uint8_t>(value | 0x80);
+      value >>= 7;
+    }
+    *output++ = static_cast<uint8_t>(value);
+    return output;
+  }
+
+  inline const uint8_t* ReadVarint(const uint8_t* input, const uint8_t* end, size_t& value)
+  {
+    value = 0;
+    for (unsigned int shift = 0; input < end && shift < 64; shift += 7)
+    {
+      uint8_t byte = *input++;
+      value |= static_cast<size_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80))
+        return input;
+    }
+    return nullptr;
+  }
+}
+
+CCompressedDeltaMemoryStream::CCompressedDeltaMemoryStream(size_t maxMemoryBytes) :
+  m_maxMemoryBytes(maxMemoryBytes)
+{
+}
+
+CCompressedDeltaMemoryStream::~CCompressedDeltaMemoryStream()
+{
+  LogStatistics();
+}
+
+void CCompressedDeltaMemoryStream::Init(size_t frameSize, uint64_t maxFrameCount)
+{
+  CLinearMemoryStream::Init(frameSize, maxFrameCount);
+
+  AllocateBuffers(maxFrameCount);
+}
+
+void CCompressedDeltaMemoryStream::SetMaxFrameCount(uint64_t maxFrameCount)
+{
+  CLinearMemoryStream::SetMaxFrameCount(maxFrameCount);
+
+  // Growing the ring buffer discards the history
+  if (maxFrameCount > 0 && GetRingBufferSize(maxFrameCount) > m_ringBufferSize)
+  {
+    m_frames.clear();
+    AllocateBuffers(maxFrameCount);
+  }
+}
+
+void CCompressedDeltaMemoryStream::Reset()
+{
+  LogStatistics();
+
+  CLinearMemoryStream::Reset();
+
+  m_frames.clear();
+  m_ringBuffer.reset();
+  m_ringBufferSize = 0;
+  m_encodeBuffer.reset();
+
+  m_submittedFrames = 0;
+  m_encodedBytes = 0;
+  m_encodeTimeUs = 0;
+  m_droppedFrames = 0;
+}
+
+void CCompressedDeltaMemoryStream::SubmitFrameInternal()
+{
+  const int64_t startTime = CurrentHostCounter();
+
+  const size_t deltaSize = EncodeDelta(m_currentFrame.get(), m_nextFrame.get(), m_encodeBuffer.get());
+
+  size_t offset;
+  if (Reserve(deltaSize, offset))
+  {
+    std::memcpy(m_ringBuffer.get() + offset, m_encodeBuffer.get(), deltaSize);
+
+    // Record frame history
+    FrameRecord frame = { offset, deltaSize, m_currentFrameHistory++ };
+    m_frames.push_back(frame);
+  }
+  else
+  {
+    // The delta doesn't fit at all, the history can't be continued
+    m_droppedFrames += m_frames.size();
+    m_frames.clear();
+    m_currentFrameHistory++;
+  }
+
+  // Delta is generated, bring the new frame forward (m_nextFrame is now disposable)
+  std::swap(m_currentFrame, m_nextFrame);
+
+  m_bHasNextFrame = false;
+
+  if (PastFramesAvailable() + 1 > MaxFrameCount())
+    CullPastFrames(1);
+
+  m_submittedFrames++;
+  m_encodedBytes += deltaSize;
+  m_encodeTimeUs += (CurrentHostCounter() - startTime) * 1000000 / CurrentHostFrequency();
+}
+
+uint64_t CCompressedDeltaMemoryStream::PastFramesAvailable() const
+{
+  return static_cast<uint64_t>(m_frames.size());
+}
+
+uint64_t CCompressedDeltaMemoryStream::RewindFrames(uint64_t frameCount)
+{
+  uint64_t rewound;
+
+  for (rewound = 0; rewound < frameCount; rewound++)
+  {
+    if (m_frames.empty())
+      break;
+
+    const FrameRecord& frame = m_frames.back();
+
+    DecodeDelta(m_ringBuffer.get() + frame.offset, frame.size, m_currentFrame.get());
+
+    // Restore frame history
+    m_currentFrameHistory = frame.frameHistoryCount;
+
+    m_frames.pop_back();
+  }
+
+  return rewound;
+}
+
+void CCompressedDeltaMemoryStream::CullPastFrames(uint64_t frameCount)
+{
+  for (uint64_t removedCount = 0; removedCount < frameCount; removedCount++)
+  {
+    if (m_frames.empty())
+    {
+      CLog::Log(LOGDEBUG, "CCompressedDeltaMemoryStream: Tried to cull %d frames too many. Check your math!", frameCount - removedCount);
+      break;
+    }
+    m_frames.pop_front();
+  }
+}
+
+size_t CCompressedDeltaMemoryStream::EncodeDelta(const uint32_t* currentFrame, const uint32_t* nextFrame, uint8_t* output) const
+{
+  uint8_t* const start = output;
+
+  size_t i = 0;
+  while (i < m_paddedFrameSize)
+  {
+    // Run of unchanged words
+    const size_t skipStart = i;
+    while (i < m_paddedFrameSize && currentFrame[i] == nextFrame[i])
+      i++;
+
+    if (i == m_paddedFrameSize)
+      break;
+
+    // Run of changed words
+    const size_t literalStart = i;
+    while (i < m_paddedFrameSize && currentFrame[i] != nextFrame[i])
+      i++;
+
+    output = WriteVarint(output, literalStart - skipStart);
+    output = WriteVarint(output, i - literalStart);
+
+    // Plain loop over both frames, this is vectorized by the compiler
+    const size_t literalCount = i - literalStart;
+    uint32_t* literals = reinterpret_cast<uint32_t*>(output);
+    for (size_t j = 0; j < literalCount; j++)
+    {
+      const uint32_t xorValue = currentFrame[literalStart + j] ^ nextFrame[literalStart + j];
+      std::memcpy(literals + j, &xorValue, sizeof(xorValue));
+    }
+    output += literalCount * sizeof(uint32_t);
+  }
+
+  return output - start;
+}
+
+void CCompressedDeltaMemoryStream::DecodeDelta(const uint8_t* input, size_t size, uint32_t* frame) const
+{
+  const uint8_t* end = input + size;
+
+  size_t pos = 0;
+  while (input < end)
+  {
+    size_t skipCount;
+    size_t literalCount;
+    input = ReadVarint(input, end, skipCount);
+    if (input)
+      input = ReadVarint(input, end, literalCount);
+
+    if (!input ||
+        static_cast<size_t>(end - input) < literalCount * sizeof(uint32_t) ||
+        pos + skipCount + literalCount > m_paddedFrameSize)
+    {
+      CLog::Log(LOGERROR, "CCompressedDeltaMemoryStream: Corrupt delta, rewind state is invalid");
+      break;
+    }
+
+    pos += skipCount;
+    for (size_t j = 0; j < literalCount; j++)
+    {
+      uint32_t xorValue;
+      std::memcpy(&xorValue, input + j * sizeof(uint32_t), sizeof(xorValue));
+      frame[pos + j] ^= xorValue;
+    }
+    pos += literalCount;
+    input += literalCount * sizeof(uint32_t);
+  }
+}
+
+size_t CCompressedDeltaMemoryStream::GetMaxDeltaSize() const
+{
+  // A delta where every word changed is a single run of literals
+  return m_paddedFrameSize * sizeof(uint32_t) + 2 * MAX_VARINT_SIZE;
+}
+
+size_t CCompressedDeltaMemoryStream::GetRingBufferSize(uint64_t maxFrameCount) const
+{
+  // Don't allocate more than the max frame count could ever use, but always
+  // leave room for at least one frame
+  const size_t maxDeltaSize = GetMaxDeltaSize();
+  const uint64_t ringBufferSize = std::min<uint64_t>(m_maxMemoryBytes, maxFrameCount * maxDeltaSize);
+  return static_cast<size_t>(std::max<uint64_t>(ringBufferSize, maxDeltaSize));
+}
+
+void CCompressedDeltaMemoryStream::AllocateBuffers(uint64_t maxFrameCount)
+{
+  m_ringBufferSize = GetRingBufferSize(maxFrameCount);
+  m_ringBuffer.reset(new uint8_t[m_ringBufferSize]);
+  m_encodeBuffer.reset(new uint8_t[GetMaxDeltaSize()]);
+}
+
+bool CCompressedDeltaMemoryStream::Reserve(size_t size, size_t& offset)
+{
+  if (size > m_ringBufferSize)
+    return false;
+
+  size_t writePos = m_frames.empty() ? 0 : m_frames.back().offset + m_frames.back().size;
+
+  if (writePos + size > m_ringBufferSize)
+  {
+    // Frames behind the write position are the oldest ones, they would be
+    // overwritten next anyway
+    while (!m_frames.empty() && m_frames.front().offset >= writePos)
+    {
+      m_frames.pop_front();
+      m_droppedFrames++;
+    }
+    writePos = 0;
+  }
+
+  // Drop the oldest frames until the delta fits
+  while (!m_frames.empty())
+  {
+    const FrameRecord& oldest = m_frames.front();
+    if (oldest.offset >= writePos + size || oldest.offset + oldest.size <= writePos)
+      break;
+
+    m_frames.pop_front();
+    m_droppedFrames++;
+  }
+
+  offset = writePos;
+  return true;
+}
+
+void CCompressedDeltaMemoryStream::LogStatistics() const
+{
+  if (m_submittedFrames == 0 || m_paddedFrameSize == 0)
+    return;
+
+  CLog::Log(LOGDEBUG, "CCompressedDeltaMemoryStream: %llu frames of %u bytes, average delta %.2f%% of a frame, "
+            "%.1f us per frame, %llu frames dropped to stay within %u bytes",
+            static_cast<unsigned long long>(m_submittedFrames),
+            static_cast<unsigned int>(FrameSize()),
+            100.0 * m_encodedBytes / m_submittedFrames / (m_paddedFrameSize * sizeof(uint32_t)),
+            static_cast<double>(m_encodeTimeUs) / m_submittedFrames,
+            static_cast<unsigned long long>(m_droppedFrames),
+            static_cast<unsigned int>(m_ringBufferSize));
+}
@@ -0,0 +1,88 @@
+/*
+ *  Copyright (C) 2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "LinearMemoryStream.h"
+
+#include <deque>
+#include <memory>
+#include <stdint.h>
+
+namespace KODI
+{
+namespace RETRO
+{
+  /*!
+   * \brief Implementation of a linear memory stream using run-length encoded
+   *        XOR deltas stored in a fixed size ring buffer
+   *
+   * Like CDeltaPairMemoryStream, the history is a chain of XOR deltas that is
+   * applied backwards from the current frame when rewinding. Instead of storing
+   * a position for every changed 32 bit word, each delta is encoded as runs of
+   * unchanged words followed by runs of changed words, which is several times
+   * smaller for the mostly contiguous changes of emulator states.
+   *
+   * The encoded deltas are written back to back into a ring buffer that is
+   * allocated once, so submitting a frame doesn't allocate memory. When the
+   * ring buffer is full the oldest frames are dropped, so the rewind history
+   * is limited by both the max frame count and the memory budget.
+   */
+  class CCompressedDeltaMemoryStream : public CLinearMemoryStream
+  {
+  public:
+    /*!
+     * \param maxMemoryBytes The memory budget of the rewind history
+     */
+    explicit CCompressedDeltaMemoryStream(size_t maxMemoryBytes);
+
+    virtual ~CCompressedDeltaMemoryStream();
+
+    // implementation of IMemoryStream via CLinearMemoryStream
+    virtual void Init(size_t frameSize, uint64_t maxFrameCount) override;
+    virtual void Reset() override;
+    virtual void SetMaxFrameCount(uint64_t maxFrameCount) override;
+    virtual uint64_t PastFramesAvailable() const override;
+    virtual uint64_t RewindFrames(uint64_t frameCount) override;
+
+  protected:
+    // implementation of CLinearMemoryStream
+    virtual void SubmitFrameInternal() override;
+    virtual void CullPastFrames(uint64_t frameCount) override;
+
+  private:
+    struct FrameRecord
+    {
+      size_t offset; // offset of the encoded delta in the ring buffer
+      size_t size; // size of the encoded delta
+      uint64_t frameHistoryCount;
+    };
+
+    size_t EncodeDelta(const uint32_t* currentFrame, const uint32_t* nextFrame, uint8_t* output) const;
+    void DecodeDelta(const uint8_t* input, size_t size, uint32_t* frame) const;
+    size_t GetMaxDeltaSize() const;
+    size_t GetRingBufferSize(uint64_t maxFrameCount) const;
+    void AllocateBuffers(uint64_t maxFrameCount);
+    bool Reserve(size_t size, size_t& offset);
+    void LogStatistics() const;
+
+    const size_t m_maxMemoryBytes;
+
+    std::unique_ptr<uint8_t[]> m_ringBuffer;
+    size_t m_ringBufferSize = 0;
+    std::unique_ptr<uint8_t[]> m_encodeBuffer;
+    std::deque<FrameRecord> m_frames;
+
+    // Statistics
+    uint64_t m_submittedFrames = 0;
+    uint64_t m_encodedBytes = 0;
+    uint64_t m_encodeTimeUs = 0;
+    uint64_t m_droppedFrames = 0;
+  };
+}
+}
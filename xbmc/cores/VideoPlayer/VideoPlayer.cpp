@@ -52,6 +52,7 @@
 #include "utils/log.h"
 #include "utils/StreamDetails.h"
 #include "utils/StreamUtils.h"
+#include "utils/TraceProfiler.h"
 #include "utils/Variant.h"
 #include "storage/MediaManager.h"
 #include "dialogs/GUIDialogKaiToast.h"
@@ -788,6 +789,8 @@ void CVideoPlayer::OnStartup()
 
 bool CVideoPlayer::OpenInputStream()
 {
+  KODI_TRACE_SCOPE("player", "CVideoPlayer::OpenInputStream");
+
   if (m_pInputStream.use_count() > 1)
     throw std::runtime_error("m_pInputStream reference count is greater than 1");
   m_pInputStream.reset();
@@ -855,6 +858,8 @@ bool CVideoPlayer::OpenInputStream()
 
 bool CVideoPlayer::OpenDemuxStream()
 {
+  KODI_TRACE_SCOPE("player", "CVideoPlayer::OpenDemuxStream");
+
   CloseDemuxer();
 
   CLog::Log(LOGNOTICE, "Creating Demuxer");
@@ -9,6 +9,7 @@
 #include "AudioDecoder.h"
 #include "CodecFactory.h"
 #include "Application.h"
+#include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "FileItem.h"
 #include "ServiceBroker.h"
@@ -90,8 +91,8 @@ bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset)
     return false;
   }
 
-  /* allocate the pcmBuffer for 2 seconds of audio */
-  m_pcmBuffer.Create(2 * blockSize * m_codec->m_format.m_sampleRate);
+  /* allocate the pcmBuffer, PAPlayer fills it ahead when the track is queued for gapless playback */
+  m_pcmBuffer.Create(g_advancedSettings.m_audioDecodeBufferSeconds * blockSize * m_codec->m_format.m_sampleRate);
 
   if (file.HasMusicInfoTag())
   {
@@ -13,9 +13,61 @@
 #include "addons/AudioDecoder.h"
 #include "addons/binary-addons/BinaryAddonBase.h"
 #include "ServiceBroker.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "filesystem/File.h"
+
+#include <deque>
+#include <set>
+#include <tuple>
 
 using namespace ADDON;
 
+namespace
+{
+
+// Probing a wav file for compressed audio opens and demuxes the file, which is
+// slow on network shares. Files found to hold plain pcm are kept by path,
+// modification time and size, so queueing a song again (repeat, playlists)
+// doesn't probe it again while a changed file is probed anew.
+const size_t MAX_WAV_PROBE_RESULTS = 256;
+typedef std::tuple<std::string, int64_t, int64_t> WavProbeKey;
+CCriticalSection wavProbeSection;
+std::set<WavProbeKey> wavPlainFiles;
+std::deque<WavProbeKey> wavPlainFilesOrder; // oldest first
+
+bool GetWavProbeKey(const std::string& path, WavProbeKey& key)
+{
+  struct __stat64 buffer;
+  if (XFILE::CFile::Stat(path, &buffer) != 0)
+    return false;
+
+  key = WavProbeKey(path, static_cast<int64_t>(buffer.st_mtime), static_cast<int64_t>(buffer.st_size));
+  return true;
+}
+
+bool IsPlainWav(const WavProbeKey& key)
+{
+  CSingleLock lock(wavProbeSection);
+  return wavPlainFiles.find(key) != wavPlainFiles.end();
+}
+
+void SetPlainWav(const WavProbeKey& key)
+{
+  CSingleLock lock(wavProbeSection);
+  if (!wavPlainFiles.insert(key).second)
+    return;
+
+  wavPlainFilesOrder.push_back(key);
+  if (wavPlainFilesOrder.size() > MAX_WAV_PROBE_RESULTS)
+  {
+    wavPlainFiles.erase(wavPlainFilesOrder.front());
+    wavPlainFilesOrder.pop_front();
+  }
+}
+
+} // unnamed namespace
+
 ICodec* CodecFactory::CreateCodec(const std::string &strFileType)
 {
   std::string fileType = strFileType;
@@ -95,14 +147,25 @@ ICodec* CodecFactory::CreateCodecDemux(const CFileItem& file, unsigned int filec
       content == "audio/wav" ||
       content == "audio/x-wav")
   {
-    VideoPlayerCodec *dvdcodec = new VideoPlayerCodec();
-    dvdcodec->SetContentType("audio/x-spdif-compressed");
-    if (dvdcodec->Init(file, filecache))
+    WavProbeKey key;
+    const bool hasKey = GetWavProbeKey(file.GetDynPath(), key);
+    if (!hasKey || !IsPlainWav(key))
     {
-      return dvdcodec;
+      VideoPlayerCodec *dvdcodec = new VideoPlayerCodec();
+      dvdcodec->SetContentType("audio/x-spdif-compressed");
+      if (dvdcodec->Init(file, filecache))
+        return dvdcodec;
+
+      delete dvdcodec;
+
+      // the probe also fails if the file can't be read, only keep the result
+      // for a file that is still there and didn't change while it was probed
+      WavProbeKey probedKey;
+      if (hasKey && GetWavProbeKey(file.GetDynPath(), probedKey) && probedKey == key)
+        SetPlainWav(key);
     }
 
-    dvdcodec = new VideoPlayerCodec();
+    VideoPlayerCodec *dvdcodec = new VideoPlayerCodec();
     dvdcodec->SetContentType(content);
     return dvdcodec;
   }
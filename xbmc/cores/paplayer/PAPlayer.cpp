@@ -21,9 +21,9 @@
 #include "cores/AudioEngine/Interfaces/AEStream.h"
 #include "cores/DataCacheCore.h"
 #include "cores/VideoPlayer/Process/ProcessInfo.h"
+#include "URL.h"
 #include "Util.h"
 
-#define TIME_TO_CACHE_NEXT_FILE 5000 /* 5 seconds before end of song, start caching the next song */
 #define FAST_XFADE_TIME           80 /* 80 milliseconds */
 #define MAX_SKIP_XFADE_TIME     2000 /* max 2 seconds crossfade on track skip */
 
@@ -376,6 +376,8 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn)
   si->m_volume = (fadeIn && m_upcomingCrossfadeMS) ? 0.0f : 1.0f;
   si->m_fadeOutTriggered = false;
   si->m_isSlaved = false;
+  si->m_underruns = 0;
+  si->m_starved = false;
 
   si->m_decoderTotal = si->m_decoder.TotalTime();
   int64_t streamTotalTime = si->m_decoderTotal;
@@ -385,10 +387,7 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn)
   si->m_prepareNextAtFrame = 0;
   // cd drives don't really like it to be crossfaded or prepared
   if(!file.IsCDDA())
-  {
-    if (streamTotalTime >= TIME_TO_CACHE_NEXT_FILE + m_defaultCrossfadeMS)
-      si->m_prepareNextAtFrame = (int)((streamTotalTime - TIME_TO_CACHE_NEXT_FILE - m_defaultCrossfadeMS) * si->m_audioFormat.m_sampleRate / 1000.0f);
-  }
+    si->m_prepareNextAtFrame = GetPrepareNextAtFrame(streamTotalTime, si->m_audioFormat.m_sampleRate);
 
   if (m_currentStream && ((m_currentStream->m_audioFormat.m_dataFormat == AE_FMT_RAW) || (si->m_audioFormat.m_dataFormat == AE_FMT_RAW)))
   {
@@ -426,6 +425,17 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn)
   return true;
 }
 
+int PAPlayer::GetPrepareNextAtFrame(int64_t streamTotalTime, unsigned int sampleRate) const
+{
+  // start opening and decoding the next song this long before the end of the current one,
+  // slow sources (e.g. network shares) can use a larger lead time for gapless playback
+  int64_t prepareNextMS = g_advancedSettings.m_audioPrepareNextSeconds * 1000;
+  if (streamTotalTime < prepareNextMS + m_defaultCrossfadeMS)
+    return 0;
+
+  return (int)((streamTotalTime - prepareNextMS - m_defaultCrossfadeMS) * sampleRate / 1000.0f);
+}
+
 void PAPlayer::UpdateStreamInfoPlayNextAtFrame(StreamInfo *si, unsigned int crossFadingTime)
 {
   // if no crossfading or cue sheet, wait for eof
@@ -654,6 +664,10 @@ inline void PAPlayer::ProcessStreams(double &freeBufferTime)
         }
       }
 
+      if (si->m_underruns)
+        CLog::Log(LOGWARNING, "PAPlayer::ProcessStreams - %u decoder underruns while playing %s",
+                  si->m_underruns, CURL::GetRedacted(si->m_fileItem.GetDynPath()).c_str());
+
       /* unregister the audio callback */
       si->m_stream->UnRegisterAudioCallback();
       si->m_decoder.Destroy();
@@ -780,9 +794,7 @@ inline bool PAPlayer::ProcessStream(StreamInfo *si, double &freeBufferTime)
         streamTotalTime = si->m_endOffset - si->m_startOffset;
 
       // calculate time when to prepare next stream
-      si->m_prepareNextAtFrame = 0;
-      if (streamTotalTime >= TIME_TO_CACHE_NEXT_FILE + m_defaultCrossfadeMS)
-        si->m_prepareNextAtFrame = (int)((streamTotalTime - TIME_TO_CACHE_NEXT_FILE - m_defaultCrossfadeMS) * si->m_audioFormat.m_sampleRate / 1000.0f);
+      si->m_prepareNextAtFrame = GetPrepareNextAtFrame(streamTotalTime, si->m_audioFormat.m_sampleRate);
 
       si->m_prepareTriggered = false;
       si->m_playNextAtFrame = 0;
@@ -834,9 +846,20 @@ bool PAPlayer::QueueData(StreamInfo *si)
 
   if (si->m_audioFormat.m_dataFormat != AE_FMT_RAW)
   {
-    unsigned int samples = std::min(si->m_decoder.GetDataSize(false), space / si->m_bytesPerSample);
+    unsigned int available = si->m_decoder.GetDataSize(false);
+    unsigned int samples = std::min(available, space / si->m_bytesPerSample);
     if (!samples)
+    {
+      // the stream wants data but the decoder ran dry before the end of the song
+      if (!available && space && si->m_started && si->m_decoder.GetStatus() == STATUS_PLAYING)
+      {
+        if (!si->m_starved)
+          si->m_underruns++;
+        si->m_starved = true;
+      }
       return true;
+    }
+    si->m_starved = false;
 
     // we want complete frames
     samples -= samples % si->m_audioFormat.m_channelLayout.Count();
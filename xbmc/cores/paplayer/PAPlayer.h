@@ -108,6 +108,8 @@ private:
 
     bool m_isSlaved;                     /* true if the stream has been slaved to another */
     bool m_waitOnDrain;                  /* wait for stream being drained in AE */
+    unsigned int m_underruns;            /* number of times the decoder could not deliver data in time */
+    bool m_starved;                      /* if the decoder has no data for the stream right now */
   };
 
   typedef std::list<StreamInfo*> StreamList;
@@ -144,6 +146,7 @@ private:
   int64_t GetTotalTime64();
   void UpdateCrossfadeTime(const CFileItem& file);
   void UpdateStreamInfoPlayNextAtFrame(StreamInfo *si, unsigned int crossFadingTime);
+  int GetPrepareNextAtFrame(int64_t streamTotalTime, unsigned int sampleRate) const;
   void UpdateGUIData(StreamInfo *si);
   int64_t GetTimeInternal();
   void SetTimeInternal(int64_t time);
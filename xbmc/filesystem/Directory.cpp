@@ -13,6 +13,7 @@
 #include "commons/Exception.h"
 #include "FileItem.h"
 #include "DirectoryCache.h"
+#include "DirectoryIndex.h"
 #include "settings/Settings.h"
 #include "utils/log.h"
 #include "utils/Job.h"
@@ -163,9 +164,17 @@ bool CDirectory::GetDirectory(const CURL& url, std::shared_ptr<IDirectory> pDire
     if (!pDirectory.get())
       return false;
 
+    const bool indexed = !(hints.flags & DIR_FLAG_BYPASS_CACHE) && CDirectoryIndex::IsIndexed(realURL);
+
     // check our cache for this path
     if (g_directoryCache.GetDirectory(realURL.Get(), items, (hints.flags & DIR_FLAG_READ_CACHE) == DIR_FLAG_READ_CACHE))
       items.SetURL(url);
+    // then the persistent index, browsing may get an out of date listing
+    else if (indexed && CDirectoryIndex::GetDirectory(realURL, hints.flags, (hints.flags & DIR_FLAG_ALLOW_PROMPT) != 0, items))
+    {
+      items.SetURL(url);
+      g_directoryCache.SetDirectory(realURL.Get(), items, pDirectory->GetCacheType(url));
+    }
     else
     {
       // need to clear the cache (in case the directory fetch fails)
@@ -248,6 +257,10 @@ bool CDirectory::GetDirectory(const CURL& url, std::shared_ptr<IDirectory> pDire
       // cache the directory, if necessary
       if (!(hints.flags & DIR_FLAG_BYPASS_CACHE))
         g_directoryCache.SetDirectory(realURL.Get(), items, pDirectory->GetCacheType(url));
+
+      // listings without file info would change the fingerprint
+      if (indexed && !(hints.flags & DIR_FLAG_NO_FILE_INFO))
+        CDirectoryIndex::StoreDirectory(realURL, items);
     }
 
     // now filter for allowed files
@@ -324,7 +337,10 @@ bool CDirectory::Create(const CURL& url)
     std::unique_ptr<IDirectory> pDirectory(CDirectoryFactory::Create(realURL));
     if (pDirectory.get())
       if(pDirectory->Create(realURL))
+      {
+        CDirectoryIndex::ClearFile(realURL.Get());
         return true;
+      }
   }
   XBMCCOMMONS_HANDLE_UNCHECKED
   catch (...)
@@ -7,6 +7,7 @@
  */
 
 #include "DirectoryCache.h"
+#include "DirectoryIndex.h"
 #include "FileItem.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
@@ -116,6 +117,7 @@ void CDirectoryCache::ClearFile(const std::string& strFile)
   std::string strFile2 = CURL(strFile).GetWithoutOptions();
 
   ClearDirectory(URIUtils::GetDirectory(strFile2));
+  CDirectoryIndex::ClearFile(strFile);
 }
 
 void CDirectoryCache::ClearDirectory(const std::string& strPath)
@@ -150,6 +152,9 @@ void CDirectoryCache::ClearSubPaths(const std::string& strPath)
 
 void CDirectoryCache::AddFile(const std::string& strFile)
 {
+  // the listing in the index doesn't have the new file
+  CDirectoryIndex::ClearFile(strFile);
+
   CSingleLock lock (m_cs);
 
   // Get rid of any URL options, else the compare may be wrong
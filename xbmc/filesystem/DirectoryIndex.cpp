@@ -0,0 +1,361 @@
+/*
+ *  Copyright (C) 2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DirectoryIndex.h"
+#include "Directory.h"
+#include "DirectoryCache.h"
+#include "File.h"
+#include "FileItem.h"
+#include "GUIUserMessages.h"
+#include "ServiceBroker.h"
+#include "URL.h"
+#include "dbwrappers/dataset.h"
+#include "guilib/GUIComponent.h"
+#include "guilib/GUIMessage.h"
+#include "guilib/GUIWindowManager.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "utils/Crc32.h"
+#include "utils/JobManager.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/Variant.h"
+
+#include <algorithm>
+#include <inttypes.h>
+#include <set>
+#include <vector>
+
+using namespace XFILE;
+
+namespace
+{
+  // folders with a revalidation in flight
+  CCriticalSection revalidateSection;
+  std::set<std::string> revalidating;
+}
+
+CDirectoryIndex::CDirectoryIndex() = default;
+
+CDirectoryIndex::~CDirectoryIndex() = default;
+
+bool CDirectoryIndex::Open()
+{
+  return CDatabase::Open();
+}
+
+void CDirectoryIndex::CreateTables()
+{
+  CLog::Log(LOGINFO, "create folder table");
+  m_pDS->exec("CREATE TABLE folder (idFolder integer primary key, path text, folderTime integer, fingerprint text, validated text)");
+
+  CLog::Log(LOGINFO, "create entry table");
+  m_pDS->exec("CREATE TABLE entry (idFolder integer, path text, label text, isFolder bool, hidden bool, size integer, dateTime text, mimeType text)");
+}
+
+void CDirectoryIndex::CreateAnalytics()
+{
+  CLog::Log(LOGINFO, "%s - creating indices", __FUNCTION__);
+  m_pDS->exec("CREATE UNIQUE INDEX idxFolder ON folder(path)");
+  m_pDS->exec("CREATE INDEX idxEntry ON entry(idFolder)");
+  m_pDS->exec("CREATE TRIGGER deleteFolder AFTER DELETE ON folder FOR EACH ROW BEGIN DELETE FROM entry WHERE idFolder=old.idFolder; END");
+}
+
+bool CDirectoryIndex::IsIndexed(const CURL& url)
+{
+  if (!g_advancedSettings.m_bDirectoryIndex)
+    return false;
+
+  // listings with explicit credentials keep them in the item paths
+  if (!url.GetUserName().empty())
+    return false;
+
+  return url.IsProtocol("nfs") ||
+         url.IsProtocol("ftp") || url.IsProtocol("ftps") ||
+         url.IsProtocol("dav") || url.IsProtocol("davs");
+}
+
+bool CDirectoryIndex::GetDirectory(const CURL& realURL, int flags, bool allowStale, CFileItemList& items)
+{
+  CDirectoryIndex index;
+  if (!index.Open())
+    return false;
+
+  time_t folderTime;
+  CDateTime validated;
+  if (!index.GetDirectory(realURL.Get(), items, folderTime, validated))
+    return false;
+
+  const int age = (CDateTime::GetCurrentDateTime() - validated).GetSecondsTotal();
+  if (age >= 0 && age < g_advancedSettings.m_iDirectoryIndexRefresh)
+    return true;
+
+  if (allowStale)
+  {
+    CLog::Log(LOGDEBUG, "CDirectoryIndex: serving %s listed %i s ago, revalidating", realURL.GetRedacted().c_str(), age);
+    index.Close();
+    Revalidate(realURL, flags);
+    return true;
+  }
+
+  // a changed folder gets a new mtime, which is a lot cheaper to check than
+  // listing it again
+  if (folderTime != 0 && GetFolderTime(realURL) == folderTime)
+  {
+    index.SetValidated(realURL.Get());
+    return true;
+  }
+
+  items.Clear();
+  return false;
+}
+
+void CDirectoryIndex::StoreDirectory(const CURL& realURL, const CFileItemList& items)
+{
+  std::shared_ptr<CFileItemList> listing(new CFileItemList);
+  listing->Copy(items);
+
+  CJobManager::GetInstance().Submit([realURL, listing]() {
+    const time_t folderTime = GetFolderTime(realURL);
+
+    CDirectoryIndex index;
+    bool changed;
+    if (index.Open())
+      index.SetDirectory(realURL.Get(), folderTime, *listing, changed);
+  }, CJob::PRIORITY_LOW);
+}
+
+void CDirectoryIndex::Revalidate(const CURL& realURL, int flags)
+{
+  const std::string storedPath = GetStoredPath(realURL.Get());
+  {
+    CSingleLock lock(revalidateSection);
+    if (!revalidating.insert(storedPath).second)
+      return;
+  }
+
+  CJobManager::GetInstance().Submit([realURL, flags, storedPath]() {
+    CDirectoryIndex index;
+    CFileItemList items;
+    time_t folderTime;
+    CDateTime validated;
+    if (index.Open() && index.GetDirectory(realURL.Get(), items, folderTime, validated))
+    {
+      const time_t currentTime = GetFolderTime(realURL);
+      if (folderTime != 0 && currentTime == folderTime)
+        index.SetValidated(realURL.Get());
+      else
+      {
+        // list the folder as is, bypassing both caches
+        CDirectory::CHints hints;
+        hints.flags = (flags & ~(DIR_FLAG_NO_FILE_INFO | DIR_FLAG_ALLOW_PROMPT)) |
+                      DIR_FLAG_BYPASS_CACHE | DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_GET_HIDDEN;
+        items.Clear();
+        bool changed = false;
+        if (CDirectory::GetDirectory(realURL, items, hints) &&
+            index.SetDirectory(realURL.Get(), currentTime, items, changed) && changed)
+        {
+          CLog::Log(LOGDEBUG, "CDirectoryIndex: %s changed", realURL.GetRedacted().c_str());
+          g_directoryCache.ClearDirectory(realURL.Get());
+
+          CGUIMessage message(GUI_MSG_NOTIFY_ALL, 0, 0, GUI_MSG_UPDATE_PATH);
+          message.SetStringParam(realURL.Get());
+          CServiceBroker::GetGUI()->GetWindowManager().SendThreadMessage(message);
+        }
+      }
+    }
+
+    CSingleLock lock(revalidateSection);
+    revalidating.erase(storedPath);
+  }, CJob::PRIORITY_LOW);
+}
+
+void CDirectoryIndex::ClearFile(const std::string& strFile)
+{
+  const CURL url(strFile);
+  if (!IsIndexed(url))
+    return;
+
+  std::string folder(url.GetWithoutOptions());
+  URIUtils::RemoveSlashAtEnd(folder);
+  folder = URIUtils::GetDirectory(folder);
+
+  CDirectoryIndex index;
+  if (index.Open())
+    index.ClearDirectory(folder);
+}
+
+std::string CDirectoryIndex::GetFingerprint(const CFileItemList& items)
+{
+  uint64_t size = 0;
+  CDateTime newest;
+  std::vector<std::string> paths;
+  paths.reserve(items.Size());
+  for (int i = 0; i < items.Size(); ++i)
+  {
+    const CFileItemPtr item = items[i];
+    size += item->m_dwSize;
+    if (item->m_dateTime.IsValid() && (!newest.IsValid() || item->m_dateTime > newest))
+      newest = item->m_dateTime;
+    paths.emplace_back(item->GetPath());
+  }
+
+  // a rename keeps count, size and dates. servers don't list in a fixed order.
+  std::sort(paths.begin(), paths.end());
+  Crc32 crc;
+  for (const auto& path : paths)
+    crc.Compute(path.c_str(), path.size() + 1);
+
+  return StringUtils::Format("%i:%" PRIu64 ":%s:%08x", items.Size(), size,
+                             newest.IsValid() ? newest.GetAsDBDateTime().c_str() : "",
+                             static_cast<uint32_t>(crc));
+}
+
+bool CDirectoryIndex::GetDirectory(const std::string& strPath, CFileItemList& items, time_t& folderTime, CDateTime& validated)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    const std::string storedPath = GetStoredPath(strPath);
+    std::string sql = PrepareSQL("SELECT idFolder, folderTime, validated FROM folder WHERE path='%s'", storedPath.c_str());
+    if (!m_pDS->query(sql))
+      return false;
+    if (m_pDS->num_rows() == 0)
+    {
+      m_pDS->close();
+      return false;
+    }
+    const int idFolder = m_pDS->fv(0).get_asInt();
+    folderTime = static_cast<time_t>(m_pDS->fv(1).get_asInt64());
+    validated.SetFromDBDateTime(m_pDS->fv(2).get_asString());
+    m_pDS->close();
+
+    sql = PrepareSQL("SELECT path, label, isFolder, hidden, size, dateTime, mimeType FROM entry WHERE idFolder=%i", idFolder);
+    if (!m_pDS->query(sql))
+      return false;
+
+    while (!m_pDS->eof())
+    {
+      CFileItemPtr item(new CFileItem(m_pDS->fv(1).get_asString()));
+      item->SetPath(m_pDS->fv(0).get_asString());
+      item->m_bIsFolder = m_pDS->fv(2).get_asBool();
+      if (m_pDS->fv(3).get_asBool())
+        item->SetProperty("file:hidden", true);
+      item->m_dwSize = m_pDS->fv(4).get_asInt64();
+      const std::string dateTime = m_pDS->fv(5).get_asString();
+      if (!dateTime.empty())
+        item->m_dateTime.SetFromDBDateTime(dateTime);
+      item->SetMimeType(m_pDS->fv(6).get_asString());
+      items.Add(item);
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s, failed on path '%s'", __FUNCTION__, CURL::GetRedacted(strPath).c_str());
+  }
+  return false;
+}
+
+bool CDirectoryIndex::SetDirectory(const std::string& strPath, time_t folderTime, const CFileItemList& items, bool& changed)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    const std::string storedPath = GetStoredPath(strPath);
+    const std::string fingerprint = GetFingerprint(items);
+    const std::string validated = CDateTime::GetCurrentDateTime().GetAsDBDateTime();
+
+    BeginTransaction();
+
+    std::string sql = PrepareSQL("SELECT idFolder, folderTime, fingerprint FROM folder WHERE path='%s'", storedPath.c_str());
+    m_pDS->query(sql);
+    const bool exists = m_pDS->num_rows() > 0;
+    int idFolder = exists ? m_pDS->fv(0).get_asInt() : -1;
+    changed = !exists || fingerprint != m_pDS->fv(2).get_asString();
+    const bool timeChanged = !exists || folderTime != static_cast<time_t>(m_pDS->fv(1).get_asInt64());
+    m_pDS->close();
+
+    if (!changed && !timeChanged)
+    { // same entries, only remember we checked
+      m_pDS->exec(PrepareSQL("UPDATE folder SET validated='%s' WHERE idFolder=%i", validated.c_str(), idFolder));
+      CommitTransaction();
+      return true;
+    }
+
+    if (exists)
+    {
+      m_pDS->exec(PrepareSQL("UPDATE folder SET folderTime=%" PRId64 ", fingerprint='%s', validated='%s' WHERE idFolder=%i",
+                             static_cast<int64_t>(folderTime), fingerprint.c_str(), validated.c_str(), idFolder));
+      m_pDS->exec(PrepareSQL("DELETE FROM entry WHERE idFolder=%i", idFolder));
+    }
+    else
+    {
+      m_pDS->exec(PrepareSQL("INSERT INTO folder (path, folderTime, fingerprint, validated) VALUES ('%s', %" PRId64 ", '%s', '%s')",
+                             storedPath.c_str(), static_cast<int64_t>(folderTime), fingerprint.c_str(), validated.c_str()));
+      idFolder = static_cast<int>(m_pDS->lastinsertid());
+    }
+
+    for (int i = 0; i < items.Size(); ++i)
+    {
+      const CFileItemPtr item = items[i];
+      m_pDS->exec(PrepareSQL("INSERT INTO entry (idFolder, path, label, isFolder, hidden, size, dateTime, mimeType) "
+                             "VALUES (%i, '%s', '%s', %i, %i, %" PRId64 ", '%s', '%s')",
+                             idFolder, item->GetPath().c_str(), item->GetLabel().c_str(),
+                             item->m_bIsFolder ? 1 : 0, item->GetProperty("file:hidden").asBoolean() ? 1 : 0,
+                             item->m_dwSize,
+                             item->m_dateTime.IsValid() ? item->m_dateTime.GetAsDBDateTime().c_str() : "",
+                             item->GetMimeType().c_str()));
+    }
+
+    CommitTransaction();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s, failed on path '%s'", __FUNCTION__, CURL::GetRedacted(strPath).c_str());
+    RollbackTransaction();
+  }
+  return false;
+}
+
+bool CDirectoryIndex::SetValidated(const std::string& strPath)
+{
+  return ExecuteQuery(PrepareSQL("UPDATE folder SET validated='%s' WHERE path='%s'",
+                                 CDateTime::GetCurrentDateTime().GetAsDBDateTime().c_str(),
+                                 GetStoredPath(strPath).c_str()));
+}
+
+bool CDirectoryIndex::ClearDirectory(const std::string& strPath)
+{
+  return ExecuteQuery(PrepareSQL("DELETE FROM folder WHERE path='%s'", GetStoredPath(strPath).c_str()));
+}
+
+std::string CDirectoryIndex::GetStoredPath(const std::string& strPath)
+{
+  // same as the directory cache, options would break the comparison
+  std::string storedPath = CURL(strPath).GetWithoutOptions();
+  URIUtils::RemoveSlashAtEnd(storedPath);
+  return storedPath;
+}
+
+time_t CDirectoryIndex::GetFolderTime(const CURL& realURL)
+{
+  struct __stat64 buffer;
+  if (CFile::Stat(realURL, &buffer) == 0)
+    return buffer.st_mtime;
+  return 0;
+}
@@ -0,0 +1,94 @@
+/*
+ *  Copyright (C) 2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "dbwrappers/Database.h"
+#include "XBDateTime.h"
+
+#include <string>
+
+class CFileItemList;
+class CURL;
+
+namespace XFILE
+{
+  /*!
+   \brief Persistent index of the listings of network folders.
+
+   Listing a folder over NFS, FTP or WebDAV means a round trip per folder and
+   often one per file. The in-memory CDirectoryCache is lost on restart, so
+   browsing and library scans walk the same folders again every time.
+
+   The index keeps the raw listing of each folder together with the mtime of
+   the folder and a fingerprint of its entries. A folder that was validated
+   within the refresh interval is served from the index without touching the
+   network. Older listings are served stale while browsing and revalidated in
+   the background. Library scans compare the mtime of the folder instead and
+   only list it again if it changed.
+
+   Enabled with <network><directoryindex> in advancedsettings.xml, the refresh
+   interval is <directoryindexrefresh> in seconds.
+   */
+  class CDirectoryIndex : public CDatabase
+  {
+  public:
+    CDirectoryIndex();
+    ~CDirectoryIndex() override;
+    bool Open() override;
+
+    /*!
+     \brief Whether listings of the given folder are kept in the index
+     */
+    static bool IsIndexed(const CURL& url);
+
+    /*!
+     \brief Serve the listing of a folder from the index if it's up to date
+     \param realURL the folder, after path substitution
+     \param flags the directory flags of the request
+     \param allowStale serve an out of date listing and revalidate it in the background
+     \param items the listing
+     \return false if the folder has to be listed
+     */
+    static bool GetDirectory(const CURL& realURL, int flags, bool allowStale, CFileItemList& items);
+
+    /*!
+     \brief Store a listing in the background
+     \param realURL the folder, after path substitution
+     \param items the listing, with file info
+     */
+    static void StoreDirectory(const CURL& realURL, const CFileItemList& items);
+
+    /*!
+     \brief Drop the listing of the folder of a file we changed
+     */
+    static void ClearFile(const std::string& strFile);
+
+    /*!
+     \brief Fingerprint of the entries of a listing: entry count, total size,
+     newest date and a checksum of the entry paths
+     */
+    static std::string GetFingerprint(const CFileItemList& items);
+
+    bool GetDirectory(const std::string& strPath, CFileItemList& items, time_t& folderTime, CDateTime& validated);
+    bool SetDirectory(const std::string& strPath, time_t folderTime, const CFileItemList& items, bool& changed);
+    bool SetValidated(const std::string& strPath);
+    bool ClearDirectory(const std::string& strPath);
+
+  protected:
+    void CreateTables() override;
+    void CreateAnalytics() override;
+    int GetSchemaVersion() const override { return 1; }
+    const char *GetBaseDBName() const override { return "DirectoryIndex"; }
+
+  private:
+    static std::string GetStoredPath(const std::string& strPath);
+    static time_t GetFolderTime(const CURL& realURL);
+    static void Revalidate(const CURL& realURL, int flags);
+  };
+}
@@ -129,6 +129,7 @@ bool CPluginDirectory::StartScript(const std::string& strPath, bool retrievingDi
   // reset our wait event, and grab a new handle
   m_fetchComplete.Reset();
   int handle = CScriptInvocationManager::GetInstance().GetReusablePluginHandle(m_addon->LibPath());
+  bool reusedHandle = handle >= 0;
 
   if (handle < 0)
     handle = getNewHandle(this);
@@ -164,11 +165,14 @@ bool CPluginDirectory::StartScript(const std::string& strPath, bool retrievingDi
   if (m_addon->ExtraInfo().find("reuselanguageinvoker") != m_addon->ExtraInfo().end())
     reuseLanguageInvoker = m_addon->ExtraInfo().at("reuselanguageinvoker") == "true";
 
+  unsigned int startTime = XbmcThreads::SystemClockMillis();
   int id = CScriptInvocationManager::GetInstance().ExecuteAsync(file, m_addon, argv, reuseLanguageInvoker, handle);
   if (id >= 0)
   { // wait for our script to finish
     std::string scriptName = m_addon->Name();
     success = WaitOnScriptResult(file, id, scriptName, retrievingDir);
+    CLog::Log(LOGDEBUG, "%s - plugin %s returned %d items in %u ms%s", __FUNCTION__, m_addon->Name().c_str(),
+              m_listItems->Size(), XbmcThreads::SystemClockMillis() - startTime, reusedHandle ? " (reused interpreter)" : "");
   }
   else
     CLog::Log(LOGERROR, "Unable to run plugin %s", m_addon->Name().c_str());
@@ -45,8 +45,9 @@ namespace XFILE
     if (!urlOrig.IsProtocol("zip"))
       urlZip = URIUtils::CreateArchivePath("zip", urlOrig);
 
+    // only the entries below the requested directory are of interest
     std::vector<SZipEntry> zipEntries;
-    if (!g_ZipManager.GetZipList(urlZip, zipEntries))
+    if (!g_ZipManager.GetZipList(urlZip, urlZip.GetFileName(), zipEntries))
       return false;
 
     // prepare the ZIP entries for directorization
@@ -18,6 +18,9 @@
 #pragma comment(lib, "zlib.lib")
 #endif
 #define ZIP_CACHE_LIMIT 4*1024*1024
+// distance between inflate checkpoints in uncompressed data, a checkpoint
+// holds a 32k window, so an entry up to ZIP_CACHE_LIMIT needs at most 256k
+#define ZIP_CHECKPOINT_SPACING 512*1024
 
 using namespace XFILE;
 
@@ -27,6 +30,7 @@ CZipFile::CZipFile()
   m_szStartOfStringBuffer = NULL;
   m_iDataInStringBuffer = 0;
   m_bCached = false;
+  m_bCheckpoints = false;
   m_iRead = -1;
 }
 
@@ -75,7 +79,11 @@ bool CZipFile::Open(const CURL&url)
     return false;
   }
   mFile.Seek(mZipItem.offset,SEEK_SET);
-  return InitDecompress();
+  if (!InitDecompress())
+    return false;
+
+  m_bCheckpoints = true;
+  return true;
 }
 
 bool CZipFile::InitDecompress()
@@ -85,6 +93,8 @@ bool CZipFile::InitDecompress()
   m_iZipFilePos = 0;
   m_iAvailBuffer = 0;
   m_bFlush = false;
+  m_bCheckpoints = false;
+  m_checkpoints.clear();
   m_ZStream.zalloc = Z_NULL;
   m_ZStream.zfree = Z_NULL;
   m_ZStream.opaque = Z_NULL;
@@ -168,58 +178,33 @@ int64_t CZipFile::Seek(int64_t iFilePosition, int iWhence)
         return m_iFilePos; // mp3reader does this lots-of-times
       if (iFilePosition > mZipItem.usize || iFilePosition < 0)
         return -1;
-      // read until position in 128k blocks.. only way to do it due to format.
       // can't start in the middle of data since then we'd have no clue where
-      // we are in uncompressed data..
-      if (iFilePosition < m_iFilePos)
+      // we are in uncompressed data.. restart from the closest checkpoint
+      // when seeking backward or when it is ahead of the current position
       {
-        m_iFilePos = 0;
-        m_iZipFilePos = 0;
-        inflateEnd(&m_ZStream);
-        inflateInit2(&m_ZStream,-MAX_WBITS); // simply restart zlib
-        mFile.Seek(mZipItem.offset,SEEK_SET);
-        m_ZStream.next_in = (Bytef*)m_szBuffer;
-        m_ZStream.avail_in = 0;
-        m_ZStream.total_out = 0;
-        while (m_iFilePos < iFilePosition)
+        const InflateCheckpoint* checkpoint = GetCheckpoint(iFilePosition);
+        if (iFilePosition < m_iFilePos || (checkpoint && checkpoint->out > m_iFilePos))
         {
-          unsigned int iToRead = (iFilePosition - m_iFilePos)>blockSize ? blockSize : (int)(iFilePosition - m_iFilePos);
-          if (Read(buf.get(),iToRead) != iToRead)
+          if (!RestoreCheckpoint(checkpoint))
             return -1;
         }
-        return m_iFilePos;
       }
-      else // seek forward
-        return Seek(iFilePosition-m_iFilePos,SEEK_CUR);
-      break;
-
-    case SEEK_CUR:
-      if (iFilePosition < 0)
-        return Seek(m_iFilePos+iFilePosition,SEEK_SET); // can't rewind stream
-      // read until requested position, drop data
-      if (m_iFilePos+iFilePosition > mZipItem.usize)
-        return -1;
-      iFilePosition += m_iFilePos;
+      // read until position in 128k blocks
       while (m_iFilePos < iFilePosition)
       {
         unsigned int iToRead = (iFilePosition - m_iFilePos)>blockSize ? blockSize : (int)(iFilePosition - m_iFilePos);
-        if (Read(buf.get(), iToRead) != iToRead)
+        if (Read(buf.get(),iToRead) != iToRead)
           return -1;
       }
       return m_iFilePos;
       break;
 
-    case SEEK_END:
-      // now this is a nasty bastard, possibly takes lotsoftime
-      // uncompress, minding m_ZStream.total_out
+    case SEEK_CUR:
+      return Seek(m_iFilePos+iFilePosition,SEEK_SET);
+      break;
 
-      while( (int)m_ZStream.total_out < mZipItem.usize+iFilePosition)
-      {
-        unsigned int iToRead = (mZipItem.usize + iFilePosition - m_ZStream.total_out > blockSize) ? blockSize : (int)(mZipItem.usize + iFilePosition - m_ZStream.total_out);
-        if (Read(buf.get(), iToRead) != iToRead)
-          return -1;
-      }
-      return m_iFilePos;
+    case SEEK_END:
+      return Seek(mZipItem.usize+iFilePosition,SEEK_SET);
       break;
     default:
       return -1;
@@ -296,13 +281,15 @@ ssize_t CZipFile::Read(void* lpBuf, size_t uiBufSize)
   {
     uLong iDecompressed = 0;
     uLong prevOut = m_ZStream.total_out;
-    while ((iDecompressed < uiBufSize) && ((m_iZipFilePos < mZipItem.csize) || (m_bFlush)))
+    // inflate stops at every block boundary (Z_BLOCK), so there may be input
+    // left after all compressed data has been read
+    while ((iDecompressed < uiBufSize) && ((m_iZipFilePos < mZipItem.csize) || (m_ZStream.avail_in > 0) || (m_bFlush)))
     {
       m_ZStream.next_out = (Bytef*)(lpBuf)+iDecompressed;
       m_ZStream.avail_out = static_cast<uInt>(uiBufSize-iDecompressed);
       if (m_bFlush) // need to flush buffer !
       {
-        int iMessage = inflate(&m_ZStream,Z_SYNC_FLUSH);
+        int iMessage = inflate(&m_ZStream,Z_BLOCK);
         m_bFlush = ((iMessage == Z_OK) && (m_ZStream.avail_out == 0))?true:false;
         if (!m_ZStream.avail_out) // flush filled buffer, get out of here
         {
@@ -320,7 +307,7 @@ ssize_t CZipFile::Read(void* lpBuf, size_t uiBufSize)
         }
       }
 
-      int iMessage = inflate(&m_ZStream,Z_SYNC_FLUSH);
+      int iMessage = inflate(&m_ZStream,Z_BLOCK);
       if (iMessage < 0)
       {
         Close();
@@ -330,6 +317,13 @@ ssize_t CZipFile::Read(void* lpBuf, size_t uiBufSize)
       m_bFlush = ((iMessage == Z_OK) && (m_ZStream.avail_out == 0))?true:false; // more info in input buffer
 
       iDecompressed = m_ZStream.total_out-prevOut;
+
+      if (iMessage == Z_STREAM_END)
+        break;
+
+      // end of a block that isn't the last one
+      if ((m_ZStream.data_type & 128) && !(m_ZStream.data_type & 64))
+        AddCheckpoint(m_iFilePos + iDecompressed);
     }
     m_iFilePos += iDecompressed;
     return static_cast<unsigned int>(iDecompressed);
@@ -378,6 +372,82 @@ bool CZipFile::FillBuffer()
   return true;
 }
 
+void CZipFile::AddCheckpoint(int64_t out)
+{
+  if (!m_bCheckpoints)
+    return;
+
+  // checkpoints are only added while inflating data past the last one
+  int64_t lastOut = m_checkpoints.empty() ? 0 : m_checkpoints.back().out;
+  if (out < lastOut + ZIP_CHECKPOINT_SPACING)
+    return;
+
+  InflateCheckpoint checkpoint;
+  checkpoint.in = m_iZipFilePos - m_ZStream.avail_in;
+  checkpoint.bits = m_ZStream.data_type & 7;
+  checkpoint.out = out;
+  checkpoint.window.resize(1 << MAX_WBITS);
+
+  uInt windowSize = static_cast<uInt>(checkpoint.window.size());
+  if (inflateGetDictionary(&m_ZStream, checkpoint.window.data(), &windowSize) != Z_OK)
+    return;
+  checkpoint.window.resize(windowSize);
+
+  m_checkpoints.push_back(std::move(checkpoint));
+}
+
+const CZipFile::InflateCheckpoint* CZipFile::GetCheckpoint(int64_t iFilePosition) const
+{
+  const InflateCheckpoint* result = nullptr;
+  for (const auto& checkpoint : m_checkpoints)
+  {
+    if (checkpoint.out > iFilePosition)
+      break;
+    result = &checkpoint;
+  }
+  return result;
+}
+
+bool CZipFile::RestoreCheckpoint(const InflateCheckpoint* checkpoint)
+{
+  // no checkpoint simply restarts zlib at the start of the entry
+  int64_t in = 0;
+  if (checkpoint)
+    in = checkpoint->in - (checkpoint->bits ? 1 : 0);
+
+  inflateEnd(&m_ZStream);
+  if (inflateInit2(&m_ZStream,-MAX_WBITS) != Z_OK)
+  {
+    CLog::Log(LOGERROR,"FileZip: error initializing zlib!");
+    return false;
+  }
+  m_ZStream.next_in = (Bytef*)m_szBuffer;
+  m_ZStream.avail_in = 0;
+  m_ZStream.total_out = 0;
+  m_bFlush = false;
+
+  if (mFile.Seek(mZipItem.offset+in,SEEK_SET) < 0)
+    return false;
+  m_iZipFilePos = in;
+  m_iFilePos = 0;
+
+  if (checkpoint)
+  {
+    if (checkpoint->bits)
+    {
+      unsigned char byte;
+      if (mFile.Read(&byte, 1) != 1)
+        return false;
+      m_iZipFilePos++;
+      inflatePrime(&m_ZStream, checkpoint->bits, byte >> (8 - checkpoint->bits));
+    }
+    inflateSetDictionary(&m_ZStream, checkpoint->window.data(), static_cast<uInt>(checkpoint->window.size()));
+    m_iFilePos = checkpoint->out;
+  }
+
+  return true;
+}
+
 void CZipFile::DestroyBuffer(void* lpBuffer, int iBufSize)
 {
   if (!m_bFlush)
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "IFile.h"
+#include <vector>
 #include <zlib.h>
 #include "File.h"
 #include "ZipManager.h"
@@ -39,9 +40,27 @@ namespace XFILE
     static bool DecompressGzip(const std::string& in, std::string& out);
 
   private:
+    /*!
+     \brief State of the inflater at a deflate block boundary.
+
+     Inflating can be restarted from a checkpoint with the window of the
+     preceding 32k of uncompressed data, which keeps seeking in deflated
+     entries from inflating all data from the start of the entry.
+     */
+    struct InflateCheckpoint
+    {
+      int64_t in; // compressed bytes consumed
+      int bits; // bits of the byte before in that are part of the next block
+      int64_t out; // position in uncompressed data
+      std::vector<unsigned char> window;
+    };
+
     bool InitDecompress();
     bool FillBuffer();
     void DestroyBuffer(void* lpBuffer, int iBufSize);
+    void AddCheckpoint(int64_t out);
+    const InflateCheckpoint* GetCheckpoint(int64_t iFilePosition) const;
+    bool RestoreCheckpoint(const InflateCheckpoint* checkpoint);
     CFile mFile;
     SZipEntry mZipItem;
     int64_t m_iFilePos; // position in _uncompressed_ data read
@@ -55,6 +74,8 @@ namespace XFILE
     int m_iRead;
     bool m_bFlush;
     bool m_bCached;
+    bool m_bCheckpoints; // only entries read from the archive can be restarted
+    std::vector<InflateCheckpoint> m_checkpoints;
   };
 }
 
@@ -14,10 +14,12 @@
 #include "File.h"
 #include "URL.h"
 #include "platform/linux/PlatformDefs.h"
+#include "threads/SingleLock.h"
 #include "utils/CharsetConverter.h"
 #include "utils/EndianSwap.h"
 #include "utils/log.h"
 #include "utils/RegExp.h"
+#include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 
 using namespace XFILE;
@@ -30,30 +32,107 @@ CZipManager::~CZipManager() = default;
 
 bool CZipManager::GetZipList(const CURL& url, std::vector<SZipEntry>& items)
 {
-  struct __stat64 m_StatData = {};
+  CSingleLock lock(m_critSection);
+
+  const ZipArchive* archive = GetArchive(url, true);
+  if (!archive)
+    return false;
+
+  items = archive->entries;
+  return true;
+}
+
+bool CZipManager::GetZipList(const CURL& url, const std::string& path, std::vector<SZipEntry>& items)
+{
+  CSingleLock lock(m_critSection);
+
+  const ZipArchive* archive = GetArchive(url, true);
+  if (!archive)
+    return false;
+
+  std::string prefix(path);
+  StringUtils::Replace(prefix, '\\', '/');
+  if (!prefix.empty() && prefix.back() != '/')
+    prefix += '/';
+
+  // all entries below the directory are adjacent in the sorted names
+  auto it = std::lower_bound(archive->sortedNames.begin(), archive->sortedNames.end(), prefix,
+    [](const std::pair<std::string, size_t>& entry, const std::string& prefix)
+    {
+      return entry.first < prefix;
+    });
+
+  std::vector<size_t> indices;
+  for (; it != archive->sortedNames.end() && StringUtils::StartsWith(it->first, prefix); ++it)
+    indices.push_back(it->second);
+
+  // keep the central directory order
+  std::sort(indices.begin(), indices.end());
+
+  items.clear();
+  items.reserve(indices.size());
+  for (size_t index : indices)
+    items.push_back(archive->entries[index]);
 
+  return true;
+}
+
+const CZipManager::ZipArchive* CZipManager::GetArchive(const CURL& url, bool checkModified)
+{
   std::string strFile = url.GetHostName();
 
+  std::map<std::string, ZipArchive>::iterator it = mZipMap.find(strFile);
+  if (it != mZipMap.end() && !checkModified)
+    return &it->second;
+
+  struct __stat64 m_StatData = {};
+
   if (CFile::Stat(strFile,&m_StatData))
   {
     CLog::Log(LOGDEBUG,"CZipManager::GetZipList: failed to stat file %s", url.GetRedacted().c_str());
-    return false;
+    return nullptr;
   }
 
-  std::map<std::string, std::vector<SZipEntry> >::iterator it = mZipMap.find(strFile);
   if (it != mZipMap.end()) // already listed, just return it if not changed, else release and reread
   {
-    std::map<std::string,int64_t>::iterator it2=mZipDate.find(strFile);
+    if (m_StatData.st_mtime == it->second.mtime)
+      return &it->second;
 
-    if (m_StatData.st_mtime == it2->second)
-    {
-      items = it->second;
-      return true;
-    }
     mZipMap.erase(it);
-    mZipDate.erase(it2);
   }
 
+  ZipArchive archive;
+  archive.mtime = m_StatData.st_mtime;
+  if (!ReadCentralDirectory(strFile, archive.entries))
+    return nullptr;
+
+  BuildIndex(archive);
+
+  return &(mZipMap[strFile] = std::move(archive));
+}
+
+void CZipManager::BuildIndex(ZipArchive& archive)
+{
+  archive.nameIndex.reserve(archive.entries.size());
+  archive.sortedNames.reserve(archive.entries.size());
+
+  for (size_t i = 0; i < archive.entries.size(); i++)
+  {
+    const char* name = archive.entries[i].name;
+
+    // the first of several entries with the same name wins, like a linear search would
+    archive.nameIndex.emplace(name, i);
+
+    std::string normalizedName(name);
+    StringUtils::Replace(normalizedName, '\\', '/');
+    archive.sortedNames.emplace_back(std::move(normalizedName), i);
+  }
+
+  std::sort(archive.sortedNames.begin(), archive.sortedNames.end());
+}
+
+bool CZipManager::ReadCentralDirectory(const std::string& strFile, std::vector<SZipEntry>& items)
+{
   CFile mFile;
   if (!mFile.Open(strFile))
   {
@@ -74,10 +153,6 @@ bool CZipManager::GetZipList(const CURL& url, std::vector<SZipEntry>& items)
   if (Endian_SwapLE32(hdr) == ZIP_SPLIT_ARCHIVE_HEADER)
     CLog::LogF(LOGWARNING, "ZIP split archive header found. Trying to process as a single archive..");
 
-  // push date for update detection
-  mZipDate.insert(make_pair(strFile,m_StatData.st_mtime));
-
-
   // Look for end of central directory record
   // Zipfile comment may be up to 65535 bytes
   // End of central directory record is 22 bytes (ECDREC_SIZE)
@@ -211,36 +286,24 @@ bool CZipManager::GetZipList(const CURL& url, std::vector<SZipEntry>& items)
 
   }
 
-  mZipMap.insert(make_pair(strFile,items));
   mFile.Close();
   return true;
 }
 
 bool CZipManager::GetZipEntry(const CURL& url, SZipEntry& item)
 {
-  std::string strFile = url.GetHostName();
+  CSingleLock lock(m_critSection);
 
-  std::map<std::string, std::vector<SZipEntry> >::iterator it = mZipMap.find(strFile);
-  std::vector<SZipEntry> items;
-  if (it == mZipMap.end()) // we need to list the zip
-  {
-    GetZipList(url,items);
-  }
-  else
-  {
-    items = it->second;
-  }
+  const ZipArchive* archive = GetArchive(url, false);
+  if (!archive)
+    return false;
 
-  std::string strFileName = url.GetFileName();
-  for (std::vector<SZipEntry>::iterator it2=items.begin();it2 != items.end();++it2)
-  {
-    if (std::string(it2->name) == strFileName)
-    {
-      memcpy(&item,&(*it2),sizeof(SZipEntry));
-      return true;
-    }
-  }
-  return false;
+  auto it = archive->nameIndex.find(url.GetFileName());
+  if (it == archive->nameIndex.end())
+    return false;
+
+  item = archive->entries[it->second];
+  return true;
 }
 
 bool CZipManager::ExtractArchive(const std::string& strArchive, const std::string& strPath)
@@ -308,13 +371,7 @@ void CZipManager::readCHeader(const char* buffer, SZipEntry& info)
 void CZipManager::release(const std::string& strPath)
 {
   CURL url(strPath);
-  std::map<std::string, std::vector<SZipEntry> >::iterator it= mZipMap.find(url.GetHostName());
-  if (it != mZipMap.end())
-  {
-    std::map<std::string,int64_t>::iterator it2=mZipDate.find(url.GetHostName());
-    mZipMap.erase(it);
-    mZipDate.erase(it2);
-  }
-}
-
 
+  CSingleLock lock(m_critSection);
+  mZipMap.erase(url.GetHostName());
+}
@@ -18,8 +18,12 @@
 #define CHDR_SIZE 46
 #define ECDREC_SIZE 22
 
+#include "threads/CriticalSection.h"
+
 #include <memory.h>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include <map>
 
@@ -93,6 +97,13 @@ public:
   ~CZipManager();
 
   bool GetZipList(const CURL& url, std::vector<SZipEntry>& items);
+  /*!
+   \brief Get the entries of an archive below a directory
+   \param url the archive
+   \param path directory inside the archive, entries below it are returned
+   \param items the entries, in central directory order
+   */
+  bool GetZipList(const CURL& url, const std::string& path, std::vector<SZipEntry>& items);
   bool GetZipEntry(const CURL& url, SZipEntry& item);
   bool ExtractArchive(const std::string& strArchive, const std::string& strPath);
   bool ExtractArchive(const CURL& archive, const std::string& strPath);
@@ -100,8 +111,22 @@ public:
   static void readHeader(const char* buffer, SZipEntry& info);
   static void readCHeader(const char* buffer, SZipEntry& info);
 private:
-  std::map<std::string,std::vector<SZipEntry> > mZipMap;
-  std::map<std::string,int64_t> mZipDate;
+  struct ZipArchive
+  {
+    int64_t mtime = 0;
+    std::vector<SZipEntry> entries;
+    // entry name -> index in entries
+    std::unordered_map<std::string, size_t> nameIndex;
+    // entry names with '/' separators, sorted for directory lookups
+    std::vector<std::pair<std::string, size_t>> sortedNames;
+  };
+
+  const ZipArchive* GetArchive(const CURL& url, bool checkModified);
+  static bool ReadCentralDirectory(const std::string& strFile, std::vector<SZipEntry>& items);
+  static void BuildIndex(ZipArchive& archive);
+
+  std::map<std::string, ZipArchive> mZipMap;
+  CCriticalSection m_critSection;
 };
 
 extern CZipManager g_ZipManager;
@@ -9,6 +9,7 @@
 #include "ServiceBroker.h"
 #include "filesystem/Directory.h"
 #include "filesystem/File.h"
+#include "filesystem/ZipManager.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "FileItem.h"
@@ -17,6 +18,7 @@
 #include "URL.h"
 
 #include <errno.h>
+#include <zlib.h>
 
 #include "gtest/gtest.h"
 
@@ -206,3 +208,122 @@ TEST_F(TestZipFile, CorruptedFile)
   file->Close();
   XBMC_DELETETEMPFILE(file);
 }
+
+namespace
+{
+  void AppendLE(std::string& out, uint32_t value, int bytes)
+  {
+    for (int i = 0; i < bytes; i++)
+      out += static_cast<char>((value >> (8 * i)) & 0xff);
+  }
+
+  // Builds a zip archive holding a single deflated entry
+  std::string CreateDeflatedZip(const std::string& name, const std::string& data)
+  {
+    std::string compressed(compressBound(data.size()), '\0');
+    z_stream strm = {};
+    deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+    strm.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    strm.avail_in = data.size();
+    strm.next_out = reinterpret_cast<Bytef*>(&compressed[0]);
+    strm.avail_out = compressed.size();
+    deflate(&strm, Z_FINISH);
+    compressed.resize(strm.total_out);
+    deflateEnd(&strm);
+
+    uint32_t crc = crc32(0, reinterpret_cast<const Bytef*>(data.data()), data.size());
+
+    std::string zip;
+    AppendLE(zip, ZIP_LOCAL_HEADER, 4);
+    AppendLE(zip, 20, 2); // version
+    AppendLE(zip, 0, 2); // flags
+    AppendLE(zip, 8, 2); // method
+    AppendLE(zip, 0, 4); // mod time and date
+    AppendLE(zip, crc, 4);
+    AppendLE(zip, compressed.size(), 4);
+    AppendLE(zip, data.size(), 4);
+    AppendLE(zip, name.size(), 2);
+    AppendLE(zip, 0, 2); // extra field length
+    zip += name;
+    zip += compressed;
+
+    uint32_t cdirOffset = zip.size();
+    AppendLE(zip, ZIP_CENTRAL_HEADER, 4);
+    AppendLE(zip, 20, 2); // version made by
+    AppendLE(zip, 20, 2); // version
+    AppendLE(zip, 0, 2); // flags
+    AppendLE(zip, 8, 2); // method
+    AppendLE(zip, 0, 4); // mod time and date
+    AppendLE(zip, crc, 4);
+    AppendLE(zip, compressed.size(), 4);
+    AppendLE(zip, data.size(), 4);
+    AppendLE(zip, name.size(), 2);
+    AppendLE(zip, 0, 2); // extra field length
+    AppendLE(zip, 0, 2); // comment length
+    AppendLE(zip, 0, 2); // disk number start
+    AppendLE(zip, 0, 2); // internal attributes
+    AppendLE(zip, 0, 4); // external attributes
+    AppendLE(zip, 0, 4); // local header offset
+    zip += name;
+    uint32_t cdirSize = zip.size() - cdirOffset;
+
+    AppendLE(zip, ZIP_END_CENTRAL_HEADER, 4);
+    AppendLE(zip, 0, 4); // disk numbers
+    AppendLE(zip, 1, 2);
+    AppendLE(zip, 1, 2);
+    AppendLE(zip, cdirSize, 4);
+    AppendLE(zip, cdirOffset, 4);
+    AppendLE(zip, 0, 2); // comment length
+
+    return zip;
+  }
+}
+
+TEST_F(TestZipFile, SeekDeflated)
+{
+  // large enough for several inflate checkpoints, small enough to be read
+  // from the archive instead of a cached copy
+  std::string data;
+  uint32_t value = 1;
+  while (data.size() < 3 * 1024 * 1024)
+  {
+    value = value * 1664525 + 1013904223;
+    data += StringUtils::Format("%08x %u\n", value, static_cast<unsigned int>(data.size()));
+  }
+
+  XFILE::CFile* zipFile = XBMC_CREATETEMPFILE(".zip");
+  ASSERT_TRUE(zipFile != NULL);
+  std::string zip = CreateDeflatedZip("data.txt", data);
+  ASSERT_EQ(static_cast<ssize_t>(zip.size()), zipFile->Write(zip.data(), zip.size()));
+  zipFile->Close();
+
+  CURL zipUrl = URIUtils::CreateArchivePath("zip", CURL(XBMC_TEMPFILEPATH(zipFile)), "data.txt");
+
+  XFILE::CFile file;
+  ASSERT_TRUE(file.Open(zipUrl));
+  EXPECT_EQ(static_cast<int64_t>(data.size()), file.GetLength());
+
+  // read through once to create the checkpoints
+  std::string read;
+  char buf[65536];
+  ssize_t size;
+  while ((size = file.Read(buf, sizeof(buf))) > 0)
+    read.append(buf, size);
+  EXPECT_TRUE(read == data);
+
+  // seek backward and forward in steps that aren't aligned to anything
+  const int64_t positions[] = { 2900000, 100, 1500007, 2500011, 700003, 0, 3000017, 1048576 };
+  for (int64_t position : positions)
+  {
+    ASSERT_EQ(position, file.Seek(position, SEEK_SET));
+    ASSERT_EQ(static_cast<ssize_t>(sizeof(buf)), file.Read(buf, sizeof(buf)));
+    EXPECT_TRUE(memcmp(data.data() + position, buf, sizeof(buf)) == 0) << "at position " << position;
+  }
+
+  EXPECT_EQ(static_cast<int64_t>(data.size()) - 10, file.Seek(-10, SEEK_END));
+  ASSERT_EQ(10, file.Read(buf, sizeof(buf)));
+  EXPECT_TRUE(memcmp(data.data() + data.size() - 10, buf, 10) == 0);
+
+  file.Close();
+  XBMC_DELETETEMPFILE(zipFile);
+}
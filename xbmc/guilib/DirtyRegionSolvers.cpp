@@ -54,10 +54,13 @@ void CGreedyDirtyRegionSolver::Solve(const CDirtyRegionList &input, CDirtyRegion
       float temporaryCost = m_costPerArea * (temporaryUnion.Area() - output[j].Area());
       if (temporaryCost < possibleUnionCost)
       {
-        //! @todo if the temporaryCost is 0 then we could skip checking the other regions since there exist no better solution
         possibleUnionRegion = temporaryUnion;
         possibleUnionNbr    = j;
         possibleUnionCost   = temporaryCost;
+
+        // the region is already covered, there exists no better solution
+        if (temporaryCost <= 0.0f)
+          break;
       }
     }
 
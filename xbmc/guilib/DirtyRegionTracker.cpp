@@ -51,8 +51,21 @@ void CDirtyRegionTracker::SelectAlgorithm()
 
 void CDirtyRegionTracker::MarkDirtyRegion(const CDirtyRegion &region)
 {
-  if (!region.IsEmpty())
-    m_markedRegions.push_back(region);
+  if (region.IsEmpty())
+    return;
+
+  // Animating controls mark the same region every frame, refresh the existing
+  // one instead of piling up copies for the solver to merge again
+  for (auto& marked : m_markedRegions)
+  {
+    if (marked == region)
+    {
+      marked = region;
+      return;
+    }
+  }
+
+  m_markedRegions.push_back(region);
 }
 
 const CDirtyRegionList &CDirtyRegionTracker::GetMarkedRegions() const
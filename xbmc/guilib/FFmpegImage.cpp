@@ -139,7 +139,7 @@ bool CFFmpegImage::LoadImageFromMemory(unsigned char* buffer, unsigned int bufSi
                                       unsigned int width, unsigned int height)
 {
 
-  if (!Initialize(buffer, bufSize))
+  if (!Initialize(buffer, bufSize, GetJpegLowres(buffer, bufSize, width, height)))
   {
     //log
     return false;
@@ -151,7 +151,60 @@ bool CFFmpegImage::LoadImageFromMemory(unsigned char* buffer, unsigned int bufSi
   return !(m_pFrame == nullptr);
 }
 
-bool CFFmpegImage::Initialize(unsigned char* buffer, size_t bufSize)
+int CFFmpegImage::GetJpegLowres(const unsigned char* buffer, size_t bufSize, unsigned int width, unsigned int height)
+{
+  if (width == 0 || height == 0 || bufSize < 4 || buffer[0] != 0xFF || buffer[1] != 0xD8)
+    return 0;
+
+  // Walk the markers up to the frame header for the image size
+  unsigned int imageWidth = 0;
+  unsigned int imageHeight = 0;
+  size_t pos = 2;
+  while (pos + 4 <= bufSize)
+  {
+    if (buffer[pos] != 0xFF)
+      return 0;
+    const unsigned char marker = buffer[pos + 1];
+    if (marker == 0xFF)
+    { // fill byte
+      pos++;
+      continue;
+    }
+    if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD8))
+    { // markers without payload
+      pos += 2;
+      continue;
+    }
+    if (marker == 0xDA || marker == 0xD9)
+      return 0;
+
+    const size_t length = (buffer[pos + 2] << 8) | buffer[pos + 3];
+    if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC)
+    {
+      if (pos + 9 > bufSize)
+        return 0;
+      imageHeight = (buffer[pos + 5] << 8) | buffer[pos + 6];
+      imageWidth = (buffer[pos + 7] << 8) | buffer[pos + 8];
+      break;
+    }
+    pos += 2 + length;
+  }
+
+  if (imageWidth == 0 || imageHeight == 0)
+    return 0;
+
+  // The decoder scales by 1/2^lowres in the DCT domain. Keep the decoded image
+  // at least as large as the requested size, whichever way the EXIF orientation
+  // turns it.
+  const float scale = std::min(std::max((float)imageWidth / width, (float)imageHeight / height),
+                               std::max((float)imageHeight / width, (float)imageWidth / height));
+  int lowres = 0;
+  while (lowres < 3 && (1 << (lowres + 1)) <= scale)
+    lowres++;
+  return lowres;
+}
+
+bool CFFmpegImage::Initialize(unsigned char* buffer, size_t bufSize, int lowres /* = 0 */)
 {
   int bufferSize = 4096;
   uint8_t* fbuffer = (uint8_t*)av_malloc(bufferSize + AV_INPUT_BUFFER_PADDING_SIZE);
@@ -246,6 +299,9 @@ bool CFFmpegImage::Initialize(unsigned char* buffer, size_t bufSize)
     return false;
   }
 
+  if (lowres > 0 && codec && codec->id == AV_CODEC_ID_MJPEG)
+    m_codec_ctx->lowres = std::min(lowres, static_cast<int>(codec->max_lowres));
+
   if (avcodec_open2(m_codec_ctx, codec, NULL) < 0)
   {
     avformat_close_input(&m_fctx);
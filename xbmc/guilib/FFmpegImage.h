@@ -69,12 +69,17 @@ public:
                                   unsigned int &bufferoutSize) override;
   void ReleaseThumbnailBuffer() override;
 
-  bool Initialize(unsigned char* buffer, size_t bufSize);
+  /*!
+   \brief Open the image in the buffer for decoding
+   \param lowres scale JPEG images down by 1/2^lowres while decoding
+   */
+  bool Initialize(unsigned char* buffer, size_t bufSize, int lowres = 0);
 
   std::shared_ptr<Frame> ReadFrame();
 
 private:
   static void FreeIOCtx(AVIOContext** ioctx);
+  static int GetJpegLowres(const unsigned char* buffer, size_t bufSize, unsigned int width, unsigned int height);
   AVFrame* ExtractFrame();
   bool DecodeFrame(AVFrame* m_pFrame, unsigned int width, unsigned int height, unsigned int pitch, unsigned char * const pixels);
   static int EncodeFFmpegFrame(AVCodecContext *avctx, AVPacket *pkt, int *got_packet, AVFrame *frame);
@@ -11,6 +11,8 @@
 #include "utils/TimeUtils.h"
 #include "utils/StringUtils.h"
 
+#include <algorithm>
+
 bool CGUIControlProfiler::m_bIsRunning = false;
 
 CGUIControlProfilerItem::CGUIControlProfilerItem(CGUIControlProfiler *pProfiler, CGUIControlProfilerItem *pParent, CGUIControl *pControl)
@@ -240,6 +242,21 @@ void CGUIControlProfiler::Start(void)
   m_bIsRunning = true;
   m_pLastItem = NULL;
   m_ItemHead.Reset(this);
+  m_layoutCount = 0;
+  m_layoutCacheHits = 0;
+  m_layoutTime = 0;
+  m_layoutMaxFrameTime = 0;
+  m_layoutFrameTime = 0;
+}
+
+void CGUIControlProfiler::AddTextLayout(bool cached, int64_t duration)
+{
+  unsigned int time = (unsigned int)(m_fPerfScale * duration);
+  m_layoutCount++;
+  if (cached)
+    m_layoutCacheHits++;
+  m_layoutTime += time;
+  m_layoutFrameTime += time;
 }
 
 void CGUIControlProfiler::BeginVisibility(CGUIControl *pControl)
@@ -296,6 +313,9 @@ CGUIControlProfilerItem *CGUIControlProfiler::FindOrAddControl(CGUIControl *pCon
 
 void CGUIControlProfiler::EndFrame(void)
 {
+  m_layoutMaxFrameTime = std::max(m_layoutMaxFrameTime, m_layoutFrameTime);
+  m_layoutFrameTime = 0;
+
   m_iFrameCount++;
   if (m_iFrameCount >= m_iMaxFrameCount)
   {
@@ -328,6 +348,18 @@ bool CGUIControlProfiler::SaveResults(void)
   root->SetAttribute("timeunit", "ms");
   doc.LinkEndChild(root);
 
+  TiXmlElement *xmlLayout = new TiXmlElement("textlayout");
+  // Note time is stored in 1/100 milliseconds but reported in ms
+  xmlLayout->SetAttribute("count", static_cast<int>(m_layoutCount));
+  xmlLayout->SetAttribute("cachehits", static_cast<int>(m_layoutCacheHits));
+  if (m_layoutCount)
+    xmlLayout->SetAttribute("hitrate", StringUtils::Format("%.1f%%", 100.0f * m_layoutCacheHits / m_layoutCount).c_str());
+  xmlLayout->SetAttribute("time", StringUtils::Format("%.2f", m_layoutTime / 100.0f).c_str());
+  if (m_iFrameCount)
+    xmlLayout->SetAttribute("timeperframe", StringUtils::Format("%.2f", m_layoutTime / 100.0f / m_iFrameCount).c_str());
+  xmlLayout->SetAttribute("maxframetime", StringUtils::Format("%.2f", m_layoutMaxFrameTime / 100.0f).c_str());
+  root->LinkEndChild(xmlLayout);
+
   m_ItemHead.SaveToXML(root);
   return doc.SaveFile(m_strOutputFile);
 }
@@ -57,6 +57,7 @@ public:
   void EndVisibility(CGUIControl *pControl);
   void BeginRender(CGUIControl *pControl);
   void EndRender(CGUIControl *pControl);
+  void AddTextLayout(bool cached, int64_t duration);
   int GetMaxFrameCount(void) const { return m_iMaxFrameCount; };
   void SetMaxFrameCount(int iMaxFrameCount) { m_iMaxFrameCount = iMaxFrameCount; };
   void SetOutputFile(const std::string &strOutputFile) { m_strOutputFile = strOutputFile; };
@@ -79,6 +80,13 @@ private:
   std::string m_strOutputFile;
   int m_iMaxFrameCount = 200;
   int m_iFrameCount = 0;
+
+  // text layout statistics
+  unsigned int m_layoutCount = 0;
+  unsigned int m_layoutCacheHits = 0;
+  unsigned int m_layoutTime = 0;
+  unsigned int m_layoutMaxFrameTime = 0;
+  unsigned int m_layoutFrameTime = 0;
 };
 
 #define GUIPROFILER_VISIBILITY_BEGIN(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().BeginVisibility(x); }
@@ -8,6 +8,7 @@
 
 #include "GUIFont.h"
 #include "GUIFontTTF.h"
+#include "GUITextLayoutCache.h"
 #include "windowing/GraphicContext.h"
 
 #include "threads/SingleLock.h"
@@ -68,6 +69,9 @@ CGUIFont::CGUIFont(const std::string& strFontName, uint32_t style, UTILS::Color
 
 CGUIFont::~CGUIFont()
 {
+  // cached layouts refer to this font
+  g_textLayoutCache.Clear();
+
   if (m_font)
     m_font->RemoveReference();
 }
@@ -225,6 +229,13 @@ bool CGUIFont::ClippedRegionIsEmpty(float x, float y, float width, uint32_t alig
   return !CServiceBroker::GetWinSystem()->GetGfxContext().SetClipRegion(x, y, width, m_font->GetTextHeight(1, 2) * CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleY());
 }
 
+void CGUIFont::PrepareText(const vecText &text)
+{
+  if (!m_font) return;
+  CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
+  m_font->PrepareText(text);
+}
+
 float CGUIFont::GetTextWidth( const vecText &text )
 {
   if (!m_font) return 0;
@@ -279,6 +290,7 @@ void CGUIFont::SetFont(CGUIFontTTFBase *font)
 {
   if (m_font == font)
     return; // no need to update the font if we already have it
+  g_textLayoutCache.Clear();
   if (m_font)
     m_font->RemoveReference();
   m_font = font;
@@ -126,6 +126,11 @@ public:
 
   bool UpdateScrollInfo(const vecText &text, CScrollInfo &scrollInfo);
 
+  /*!
+   \brief Cache the glyphs of a text ahead of measuring and drawing it
+   */
+  void PrepareText(const vecText &text);
+
   float GetTextWidth( const vecText &text );
   float GetCharWidth( character_t ch );
   float GetTextHeight(int numLines) const;
@@ -19,11 +19,16 @@
 #include "windowing/WinSystem.h"
 #include "URL.h"
 #include "filesystem/File.h"
+#include "threads/Condition.h"
+#include "threads/SingleLock.h"
 #include "threads/SystemClock.h"
+#include "utils/JobManager.h"
 
+#include <algorithm>
 #include <math.h>
 #include <memory>
 #include <queue>
+#include <unordered_set>
 
 // stuff for freetype
 #include <ft2build.h>
@@ -46,9 +51,21 @@
 #endif
 
 #define CHARS_PER_TEXTURE_LINE 20 // number of characters to cache per texture line
-#define CHAR_CHUNK    64      // 64 chars allocated at a time (1024 bytes)
 #define GLYPH_STRENGTH_BOLD 24
 #define GLYPH_STRENGTH_LIGHT -48
+#define MIN_PARALLEL_GLYPHS 32  // fewer new glyphs are rasterised on demand
+#define MAX_GLYPH_RASTERIZERS 3 // number of job workers rasterising glyphs in parallel
+
+namespace
+{
+  FT_Pos GetBorderStrength(FT_Face face)
+  {
+    FT_Pos strength = FT_MulFix(face->units_per_EM, face->size->metrics.y_scale) / 12;
+    if (strength < 128)
+      strength = 128;
+    return strength;
+  }
+}
 
 
 class CFreeTypeLibrary
@@ -102,20 +119,26 @@ public:
       return NULL;
 #endif // ! TARGET_WINDOWS
 
-    unsigned int ydpi = 72; // 72 points to the inch is the freetype default
-    unsigned int xdpi = (unsigned int)MathUtils::round_int(ydpi * aspect);
+    return SetCharSize(face, size, aspect);
+  };
 
-    // we set our screen res currently to 96dpi in both directions (windows default)
-    // we cache our characters (for rendering speed) so it's probably
-    // not a good idea to allow free scaling of fonts - rather, just
-    // scaling to pixel ratio on screen perhaps?
-    if (FT_Set_Char_Size( face, 0, (int)(size*64 + 0.5f), xdpi, ydpi ))
+  // FreeType only reads the memory of a face, so a font file that was loaded
+  // for another face can be shared as long as it outlives this face
+  FT_Face GetFont(const XUTILS::auto_buffer& memoryBuf, float size, float aspect)
+  {
+    if (!m_library)
+      FT_Init_FreeType(&m_library);
+    if (!m_library)
     {
-      FT_Done_Face(face);
+      CLog::Log(LOGERROR, "Unable to initialize freetype library");
       return NULL;
     }
 
-    return face;
+    FT_Face face;
+    if (FT_New_Memory_Face(m_library, (const FT_Byte*)memoryBuf.get(), memoryBuf.size(), 0, &face) != 0)
+      return NULL;
+
+    return SetCharSize(face, size, aspect);
   };
 
   FT_Stroker GetStroker()
@@ -143,17 +166,131 @@ public:
   }
 
 private:
+  static FT_Face SetCharSize(FT_Face face, float size, float aspect)
+  {
+    unsigned int ydpi = 72; // 72 points to the inch is the freetype default
+    unsigned int xdpi = (unsigned int)MathUtils::round_int(ydpi * aspect);
+
+    // we set our screen res currently to 96dpi in both directions (windows default)
+    // we cache our characters (for rendering speed) so it's probably
+    // not a good idea to allow free scaling of fonts - rather, just
+    // scaling to pixel ratio on screen perhaps?
+    if (FT_Set_Char_Size( face, 0, (int)(size*64 + 0.5f), xdpi, ydpi ))
+    {
+      FT_Done_Face(face);
+      return NULL;
+    }
+
+    return face;
+  }
+
   FT_Library   m_library;
 };
 
 XBMC_GLOBAL_REF(CFreeTypeLibrary, g_freeTypeLibrary); // our freetype library
 #define g_freeTypeLibrary XBMC_GLOBAL_USE(CFreeTypeLibrary)
 
+/*!
+ \brief A face that is only used by one job worker at a time.
+
+ FreeType faces must not be used from several threads, so every rasteriser
+ opens the font in a library of its own. A font file that was read into memory
+ is shared with the font instead of being read again.
+ */
+class CGlyphRasterizer
+{
+public:
+  CGlyphRasterizer() = default;
+
+  ~CGlyphRasterizer()
+  {
+    if (m_stroker)
+      CFreeTypeLibrary::ReleaseStroker(m_stroker);
+    if (m_face)
+      CFreeTypeLibrary::ReleaseFont(m_face);
+  }
+
+  bool Load(const std::string &filename, const XUTILS::auto_buffer &fontFileInMemory,
+            float height, float aspect, bool border)
+  {
+    if (fontFileInMemory.size() > 0)
+      m_face = m_library.GetFont(fontFileInMemory, height, aspect);
+    else
+      m_face = m_library.GetFont(filename, height, aspect, m_fontFileInMemory);
+    if (!m_face)
+      return false;
+
+    if (border)
+    {
+      m_stroker = m_library.GetStroker();
+      if (m_stroker)
+        FT_Stroker_Set(m_stroker, GetBorderStrength(m_face), FT_STROKER_LINECAP_ROUND, FT_STROKER_LINEJOIN_ROUND, 0);
+    }
+    return true;
+  }
+
+  FT_Face GetFace() const { return m_face; }
+  FT_Stroker GetStroker() const { return m_stroker; }
+
+private:
+  CFreeTypeLibrary m_library;
+  XUTILS::auto_buffer m_fontFileInMemory;
+  FT_Face m_face = nullptr;
+  FT_Stroker m_stroker = nullptr;
+};
+
+/*!
+ \brief Hands out the chunks of a batch of glyphs to the calling thread and
+ the job workers.
+
+ A chunk is rasterised by whoever claims it first, so the calling thread never
+ waits for a job that hasn't started yet. Jobs that start late find their
+ chunk taken and don't touch the glyphs anymore.
+ */
+class CGlyphBatch
+{
+public:
+  explicit CGlyphBatch(size_t chunkCount) : m_chunks(chunkCount, State::PENDING) {}
+
+  bool Claim(size_t chunk)
+  {
+    CSingleLock lock(m_critSection);
+    if (m_chunks[chunk] != State::PENDING)
+      return false;
+    m_chunks[chunk] = State::RUNNING;
+    return true;
+  }
+
+  void Finish(size_t chunk)
+  {
+    CSingleLock lock(m_critSection);
+    m_chunks[chunk] = State::DONE;
+    m_chunkDone.notifyAll();
+  }
+
+  void Wait()
+  {
+    CSingleLock lock(m_critSection);
+    while (std::any_of(m_chunks.begin(), m_chunks.end(), [](State state) { return state != State::DONE; }))
+      m_chunkDone.wait(lock);
+  }
+
+private:
+  enum class State
+  {
+    PENDING,
+    RUNNING,
+    DONE
+  };
+
+  CCriticalSection m_critSection;
+  XbmcThreads::ConditionVariable m_chunkDone;
+  std::vector<State> m_chunks;
+};
+
 CGUIFontTTFBase::CGUIFontTTFBase(const std::string& strFileName) : m_staticCache(*this), m_dynamicCache(*this)
 {
   m_texture = NULL;
-  m_char = NULL;
-  m_maxChars = 0;
   m_nestedBeginCount = 0;
 
   m_vertex.reserve(4*1024);
@@ -165,11 +302,11 @@ CGUIFontTTFBase::CGUIFontTTFBase(const std::string& strFileName) : m_staticCache
   m_referenceCount = 0;
   m_originX = m_originY = 0.0f;
   m_cellBaseLine = m_cellHeight = 0;
-  m_numChars = 0;
   m_posX = m_posY = 0;
   m_textureHeight = m_textureWidth = 0;
   m_textureScaleX = m_textureScaleY = 0.0;
   m_ellipsesWidth = m_height = 0.0f;
+  m_aspect = 1.0f;
   m_color = 0;
   m_nTexture = 0;
 
@@ -202,11 +339,8 @@ void CGUIFontTTFBase::ClearCharacterCache()
   DeleteHardwareTexture();
 
   m_texture = NULL;
-  delete[] m_char;
-  m_char = new Character[CHAR_CHUNK];
+  m_char.clear();
   memset(m_charquick, 0, sizeof(m_charquick));
-  m_numChars = 0;
-  m_maxChars = CHAR_CHUNK;
   // set the posX and posY so that our texture will be created on first character write.
   m_posX = m_textureWidth;
   m_posY = -(int)GetTextureLineHeight();
@@ -217,11 +351,8 @@ void CGUIFontTTFBase::Clear()
 {
   delete(m_texture);
   m_texture = NULL;
-  delete[] m_char;
+  m_char.clear();
   memset(m_charquick, 0, sizeof(m_charquick));
-  m_char = NULL;
-  m_maxChars = 0;
-  m_numChars = 0;
   m_posX = 0;
   m_posY = 0;
   m_nestedBeginCount = 0;
@@ -232,6 +363,7 @@ void CGUIFontTTFBase::Clear()
   if (m_stroker)
     g_freeTypeLibrary.ReleaseStroker(m_stroker);
   m_stroker = NULL;
+  m_rasterizers.clear();
 
   m_vertexTrans.clear();
   m_vertex.clear();
@@ -276,9 +408,7 @@ bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float a
      add on the strength of any border - the non-bordered font needs
      aligning with the bordered font by utilising GetTextBaseLine()
      */
-    FT_Pos strength = FT_MulFix( m_face->units_per_EM, m_face->size->metrics.y_scale) / 12;
-    if (strength < 128)
-      strength = 128;
+    FT_Pos strength = GetBorderStrength(m_face);
 
     cellDescender -= strength;
     cellAscender  += strength;
@@ -297,14 +427,12 @@ bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float a
   m_cellHeight   = cellAscender - cellDescender;
 
   m_height = height;
+  m_aspect = aspect;
 
   delete(m_texture);
   m_texture = NULL;
-  delete[] m_char;
-  m_char = NULL;
-
-  m_maxChars = 0;
-  m_numChars = 0;
+  m_char.clear();
+  memset(m_charquick, 0, sizeof(m_charquick));
 
   m_strFilename = strFilename;
 
@@ -619,49 +747,21 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
   // letters are stored based on style and letter
   character_t ch = (style << 16) | letter;
 
-  int low = 0;
-  int high = m_numChars - 1;
-  while (low <= high)
-  {
-    int mid = (low + high) >> 1;
-    if (ch > m_char[mid].letterAndStyle)
-      low = mid + 1;
-    else if (ch < m_char[mid].letterAndStyle)
-      high = mid - 1;
-    else
-      return &m_char[mid];
-  }
-  // if we get to here, then low is where we should insert the new character
-
-  // increase the size of the buffer if we need it
-  if (m_numChars >= m_maxChars)
-  { // need to increase the size of the buffer
-    Character *newTable = new Character[m_maxChars + CHAR_CHUNK];
-    if (m_char)
-    {
-      memcpy(newTable, m_char, low * sizeof(Character));
-      memcpy(newTable + low + 1, m_char + low, (m_numChars - low) * sizeof(Character));
-      delete[] m_char;
-    }
-    m_char = newTable;
-    m_maxChars += CHAR_CHUNK;
+  auto it = m_char.find(ch);
+  if (it != m_char.end())
+    return &it->second;
 
-  }
-  else
-  { // just move the data along as necessary
-    memmove(m_char + low + 1, m_char + low, (m_numChars - low) * sizeof(Character));
-  }
   // render the character to our texture
   // must End() as we can't render text to our texture during a Begin(), End() block
+  Character character;
   unsigned int nestedBeginCount = m_nestedBeginCount;
   m_nestedBeginCount = 1;
   if (nestedBeginCount) End();
-  if (!CacheCharacter(letter, style, m_char + low))
+  if (!CacheCharacter(letter, style, &character))
   { // unable to cache character - try clearing them all out and starting over
-    CLog::Log(LOGDEBUG, "%s: Unable to cache character.  Clearing character cache of %i characters", __FUNCTION__, m_numChars);
+    CLog::Log(LOGDEBUG, "%s: Unable to cache character.  Clearing character cache of %i characters", __FUNCTION__, static_cast<int>(m_char.size()));
     ClearCharacterCache();
-    low = 0;
-    if (!CacheCharacter(letter, style, m_char + low))
+    if (!CacheCharacter(letter, style, &character))
     {
       CLog::Log(LOGERROR, "%s: Unable to cache character (out of memory?)", __FUNCTION__);
       if (nestedBeginCount) Begin();
@@ -672,70 +772,202 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
   if (nestedBeginCount) Begin();
   m_nestedBeginCount = nestedBeginCount;
 
-  // fixup quick access
-  memset(m_charquick, 0, sizeof(m_charquick));
-  for(int i=0;i<m_numChars;i++)
+  // elements of the map don't move, so the quick access table stays valid
+  Character *cached = &m_char.emplace(ch, character).first->second;
+  if (letter < 255)
+    m_charquick[(style << 8) | letter] = cached;
+
+  return cached;
+}
+
+void CGUIFontTTFBase::PrepareText(const vecText &text)
+{
+  if (!m_face)
+    return;
+
+  std::vector<RasterizedGlyph> glyphs;
+  std::unordered_set<character_t> seen;
+  for (character_t chr : text)
   {
-    if ((m_char[i].letterAndStyle & 0xffff) < 255)
+    wchar_t letter = (wchar_t)(chr & 0xffff);
+    character_t style = (chr & 0x7000000) >> 24;
+    if (letter == L'\r')
+      continue;
+
+    character_t ch = (style << 16) | letter;
+    if (m_char.find(ch) == m_char.end() && seen.insert(ch).second)
     {
-      character_t ch = ((m_char[i].letterAndStyle & 0xffff0000) >> 8) | (m_char[i].letterAndStyle & 0xff);
-      m_charquick[ch] = m_char+i;
+      glyphs.emplace_back();
+      glyphs.back().letterAndStyle = ch;
     }
   }
 
-  return m_char + low;
+  // a few glyphs are cheaper to rasterise on demand
+  if (glyphs.size() < MIN_PARALLEL_GLYPHS)
+    return;
+
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  RasterizeGlyphs(glyphs);
+  unsigned int rasterized = XbmcThreads::SystemClockMillis();
+
+  // must End() as we can't render text to our texture during a Begin(), End() block
+  unsigned int nestedBeginCount = m_nestedBeginCount;
+  m_nestedBeginCount = 1;
+  if (nestedBeginCount) End();
+
+  for (const RasterizedGlyph &glyph : glyphs)
+  {
+    // glyphs that fail here are retried on demand, which clears the cache if needed
+    Character character;
+    if (!glyph.valid || !PlaceGlyph(glyph, &character))
+      continue;
+
+    Character *cached = &m_char.emplace(glyph.letterAndStyle, character).first->second;
+    wchar_t letter = (wchar_t)(glyph.letterAndStyle & 0xffff);
+    if (letter < 255)
+      m_charquick[((glyph.letterAndStyle & 0xffff0000) >> 8) | letter] = cached;
+  }
+
+  if (nestedBeginCount) Begin();
+  m_nestedBeginCount = nestedBeginCount;
+
+  CLog::Log(LOGDEBUG, "%s: Rasterised %u glyphs of %s with %u workers in %u ms, caching took %u ms", __FUNCTION__,
+            static_cast<unsigned int>(glyphs.size()), m_strFilename.c_str(),
+            static_cast<unsigned int>(m_rasterizers.size()), rasterized - start,
+            XbmcThreads::SystemClockMillis() - rasterized);
+}
+
+void CGUIFontTTFBase::RasterizeGlyphs(std::vector<RasterizedGlyph> &glyphs)
+{
+  while (m_rasterizers.size() < MAX_GLYPH_RASTERIZERS)
+  {
+    std::unique_ptr<CGlyphRasterizer> rasterizer(new CGlyphRasterizer);
+    if (!rasterizer->Load(m_strFilename, m_fontFileInMemory, m_height, m_aspect, m_stroker != NULL))
+      break;
+    m_rasterizers.push_back(std::move(rasterizer));
+  }
+
+  // chunk 0 belongs to the calling thread, the others to the job workers
+  const size_t chunkCount = m_rasterizers.size() + 1;
+  const size_t chunkSize = (glyphs.size() + chunkCount - 1) / chunkCount;
+  std::shared_ptr<CGlyphBatch> batch = std::make_shared<CGlyphBatch>(chunkCount);
+
+  auto chunkBegin = [&glyphs, chunkSize](size_t chunk)
+  {
+    return glyphs.data() + std::min(chunk * chunkSize, glyphs.size());
+  };
+
+  for (size_t chunk = 1; chunk < chunkCount; ++chunk)
+  {
+    CGlyphRasterizer *rasterizer = m_rasterizers[chunk - 1].get();
+    RasterizedGlyph *begin = chunkBegin(chunk);
+    RasterizedGlyph *end = chunkBegin(chunk + 1);
+    CJobManager::GetInstance().Submit([batch, chunk, rasterizer, begin, end]()
+    {
+      if (!batch->Claim(chunk))
+        return;
+      for (RasterizedGlyph *glyph = begin; glyph != end; ++glyph)
+        glyph->valid = RasterizeGlyph(rasterizer->GetFace(), rasterizer->GetStroker(), glyph->letterAndStyle, *glyph);
+      batch->Finish(chunk);
+    }, CJob::PRIORITY_HIGH);
+  }
+
+  // rasterise our own chunk, then take over the chunks whose jobs didn't start yet
+  for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+  {
+    if (!batch->Claim(chunk))
+      continue;
+    for (RasterizedGlyph *glyph = chunkBegin(chunk); glyph != chunkBegin(chunk + 1); ++glyph)
+      glyph->valid = RasterizeGlyph(m_face, m_stroker, glyph->letterAndStyle, *glyph);
+    batch->Finish(chunk);
+  }
+
+  batch->Wait();
 }
 
 bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *ch)
 {
-  int glyph_index = FT_Get_Char_Index( m_face, letter );
+  RasterizedGlyph glyph;
+  if (!RasterizeGlyph(m_face, m_stroker, (style << 16) | letter, glyph))
+    return false;
+
+  return PlaceGlyph(glyph, ch);
+}
+
+bool CGUIFontTTFBase::RasterizeGlyph(FT_Face face, FT_Stroker stroker, character_t letterAndStyle, RasterizedGlyph &result)
+{
+  wchar_t letter = (wchar_t)(letterAndStyle & 0xffff);
+  uint32_t style = letterAndStyle >> 16;
+
+  int glyph_index = FT_Get_Char_Index( face, letter );
 
   FT_Glyph glyph = NULL;
-  if (FT_Load_Glyph( m_face, glyph_index, FT_LOAD_TARGET_LIGHT ))
+  if (FT_Load_Glyph( face, glyph_index, FT_LOAD_TARGET_LIGHT ))
   {
     CLog::Log(LOGDEBUG, "%s Failed to load glyph %x", __FUNCTION__, static_cast<uint32_t>(letter));
     return false;
   }
   // make bold if applicable
   if (style & FONT_STYLE_BOLD)
-    SetGlyphStrength(m_face->glyph, GLYPH_STRENGTH_BOLD);
+    SetGlyphStrength(face->glyph, GLYPH_STRENGTH_BOLD);
   // and italics if applicable
   if (style & FONT_STYLE_ITALICS)
-    ObliqueGlyph(m_face->glyph);
+    ObliqueGlyph(face->glyph);
   // and light if applicable
   if (style & FONT_STYLE_LIGHT)
-    SetGlyphStrength(m_face->glyph, GLYPH_STRENGTH_LIGHT);
+    SetGlyphStrength(face->glyph, GLYPH_STRENGTH_LIGHT);
   // grab the glyph
-  if (FT_Get_Glyph(m_face->glyph, &glyph))
+  if (FT_Get_Glyph(face->glyph, &glyph))
   {
     CLog::Log(LOGDEBUG, "%s Failed to get glyph %x", __FUNCTION__, static_cast<uint32_t>(letter));
     return false;
   }
-  if (m_stroker)
-    FT_Glyph_StrokeBorder(&glyph, m_stroker, 0, 1);
+  if (stroker)
+    FT_Glyph_StrokeBorder(&glyph, stroker, 0, 1);
   // render the glyph
   if (FT_Glyph_To_Bitmap(&glyph, FT_RENDER_MODE_NORMAL, NULL, 1))
   {
     CLog::Log(LOGDEBUG, "%s Failed to render glyph %x to a bitmap", __FUNCTION__, static_cast<uint32_t>(letter));
+    FT_Done_Glyph(glyph);
     return false;
   }
   FT_BitmapGlyph bitGlyph = (FT_BitmapGlyph)glyph;
-  FT_Bitmap bitmap = bitGlyph->bitmap;
-  bool isEmptyGlyph = (bitmap.width == 0 || bitmap.rows == 0);
+  const FT_Bitmap &bitmap = bitGlyph->bitmap;
+
+  result.letterAndStyle = letterAndStyle;
+  result.left = bitGlyph->left;
+  result.top = bitGlyph->top;
+  result.width = bitmap.width;
+  result.rows = bitmap.rows;
+  result.advance = (float)MathUtils::round_int( (float)face->glyph->advance.x / 64 );
+
+  // copy the pixels without the row padding
+  result.pixels.resize(result.width * result.rows);
+  for (unsigned int y = 0; y < result.rows; y++)
+    memcpy(result.pixels.data() + y * result.width, bitmap.buffer + y * bitmap.pitch, result.width);
+
+  // free the glyph
+  FT_Done_Glyph(glyph);
+
+  return true;
+}
+
+bool CGUIFontTTFBase::PlaceGlyph(const RasterizedGlyph &glyph, Character *ch)
+{
+  bool isEmptyGlyph = (glyph.width == 0 || glyph.rows == 0);
 
   if (!isEmptyGlyph)
   {
-    if (bitGlyph->left < 0)
-      m_posX += -bitGlyph->left;
+    if (glyph.left < 0)
+      m_posX += -glyph.left;
 
     // check we have enough room for the character.
-    // cast-fest is here to avoid warnings due to freeetype version differences (signedness of width).
-    if (static_cast<int>(m_posX + bitGlyph->left + bitmap.width) > static_cast<int>(m_textureWidth))
+    if (static_cast<int>(m_posX + glyph.left + glyph.width) > static_cast<int>(m_textureWidth))
     { // no space - gotta drop to the next line (which means creating a new texture and copying it across)
       m_posX = 0;
       m_posY += GetTextureLineHeight();
-      if (bitGlyph->left < 0)
-        m_posX += -bitGlyph->left;
+      if (glyph.left < 0)
+        m_posX += -glyph.left;
 
       if(m_posY + GetTextureLineHeight() >= m_textureHeight)
       {
@@ -745,7 +977,6 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
         if (newHeight > m_renderSystem->GetMaxTextureSize())
         {
           CLog::Log(LOGDEBUG, "%s: New cache texture is too large (%u > %u pixels long)", __FUNCTION__, newHeight, m_renderSystem->GetMaxTextureSize());
-          FT_Done_Glyph(glyph);
           return false;
         }
 
@@ -753,7 +984,6 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
         newTexture = ReallocTexture(newHeight);
         if(newTexture == NULL)
         {
-          FT_Done_Glyph(glyph);
           CLog::Log(LOGDEBUG, "%s: Failed to allocate new texture of height %u", __FUNCTION__, newHeight);
           return false;
         }
@@ -763,37 +993,44 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
 
     if(m_texture == NULL)
     {
-      FT_Done_Glyph(glyph);
       CLog::Log(LOGDEBUG, "%s: no texture to cache character to", __FUNCTION__);
       return false;
     }
   }
   // set the character in our table
-  ch->letterAndStyle = (style << 16) | letter;
-  ch->offsetX = (short)bitGlyph->left;
-  ch->offsetY = (short)m_cellBaseLine - bitGlyph->top;
+  ch->letterAndStyle = glyph.letterAndStyle;
+  ch->offsetX = (short)glyph.left;
+  ch->offsetY = (short)m_cellBaseLine - glyph.top;
   ch->left = isEmptyGlyph ? 0 : ((float)m_posX + ch->offsetX);
   ch->top = isEmptyGlyph ? 0 : ((float)m_posY + ch->offsetY);
-  ch->right = ch->left + bitmap.width;
-  ch->bottom = ch->top + bitmap.rows;
-  ch->advance = (float)MathUtils::round_int( (float)m_face->glyph->advance.x / 64 );
+  ch->right = ch->left + glyph.width;
+  ch->bottom = ch->top + glyph.rows;
+  ch->advance = glyph.advance;
 
   // we need only render if we actually have some pixels
   if (!isEmptyGlyph)
   {
+    // the texture backends take the bitmap as FreeType glyph
+    FT_BitmapGlyphRec bitGlyph;
+    memset(&bitGlyph, 0, sizeof(bitGlyph));
+    bitGlyph.left = glyph.left;
+    bitGlyph.top = glyph.top;
+    bitGlyph.bitmap.width = glyph.width;
+    bitGlyph.bitmap.rows = glyph.rows;
+    bitGlyph.bitmap.pitch = glyph.width;
+    bitGlyph.bitmap.buffer = const_cast<unsigned char*>(glyph.pixels.data());
+    bitGlyph.bitmap.num_grays = 256;
+    bitGlyph.bitmap.pixel_mode = FT_PIXEL_MODE_GRAY;
+
     // ensure our rect will stay inside the texture (it *should* but we need to be certain)
     unsigned int x1 = std::max(m_posX + ch->offsetX, 0);
     unsigned int y1 = std::max(m_posY + ch->offsetY, 0);
-    unsigned int x2 = std::min(x1 + bitmap.width, m_textureWidth);
-    unsigned int y2 = std::min(y1 + bitmap.rows, m_textureHeight);
-    CopyCharToTexture(bitGlyph, x1, y1, x2, y2);
+    unsigned int x2 = std::min(x1 + glyph.width, m_textureWidth);
+    unsigned int y2 = std::min(y1 + glyph.rows, m_textureHeight);
+    CopyCharToTexture(&bitGlyph, x1, y1, x2, y2);
 
     m_posX += spacing_between_characters_in_texture + (unsigned short)std::max(ch->right - ch->left + ch->offsetX, ch->advance);
   }
-  m_numChars++;
-
-  // free the glyph
-  FT_Done_Glyph(glyph);
 
   return true;
 }
@@ -969,8 +1206,8 @@ void CGUIFontTTFBase::SetGlyphStrength(FT_GlyphSlot slot, int glyphStrength)
     return;
 
   /* some reasonable strength */
-  FT_Pos strength = FT_MulFix( m_face->units_per_EM,
-                    m_face->size->metrics.y_scale ) / glyphStrength;
+  FT_Pos strength = FT_MulFix( slot->face->units_per_EM,
+                    slot->face->size->metrics.y_scale ) / glyphStrength;
 
   FT_BBox bbox_before, bbox_after;
   FT_Outline_Get_CBox( &slot->outline, &bbox_before );
@@ -8,8 +8,10 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <stdint.h>
+#include <unordered_map>
 #include <vector>
 
 #include "utils/auto_buffer.h"
@@ -27,6 +29,7 @@ using namespace DirectX::PackedVector;
 constexpr size_t LOOKUPTABLE_SIZE = 256 * 8;
 
 class CBaseTexture;
+class CGlyphRasterizer;
 class CRenderSystemBase;
 
 struct FT_FaceRec_;
@@ -93,9 +96,34 @@ protected:
     float advance;
     character_t letterAndStyle;
   };
+
+  /*!
+   \brief A glyph rendered by FreeType, not yet placed into the texture
+   */
+  struct RasterizedGlyph
+  {
+    character_t letterAndStyle = 0;
+    bool valid = false;
+    int left = 0;                // offset of the bitmap from the pen position
+    int top = 0;
+    unsigned int width = 0;
+    unsigned int rows = 0;
+    float advance = 0.0f;
+    std::vector<uint8_t> pixels; // 8bit alpha, width * rows
+  };
+
   void AddReference();
   void RemoveReference();
 
+  /*!
+   \brief Cache the glyphs of a text before it is measured or drawn.
+
+   Glyphs that are not cached yet are otherwise rasterised one by one as
+   they are looked up. When a text needs many new glyphs at once (e.g. CJK
+   text), they are rasterised in parallel on job workers instead.
+   */
+  void PrepareText(const vecText &text);
+
   float GetTextWidthInternal(vecText::const_iterator start, vecText::const_iterator end);
   float GetCharWidthInternal(character_t ch);
   float GetTextHeight(float lineSpacing, int numLines) const;
@@ -112,6 +140,9 @@ protected:
   // Stuff for pre-rendering for speed
   inline Character *GetCharacter(character_t letter);
   bool CacheCharacter(wchar_t letter, uint32_t style, Character *ch);
+  static bool RasterizeGlyph(FT_Face face, FT_Stroker stroker, character_t letterAndStyle, RasterizedGlyph &glyph);
+  void RasterizeGlyphs(std::vector<RasterizedGlyph> &glyphs);
+  bool PlaceGlyph(const RasterizedGlyph &glyph, Character *ch);
   void RenderCharacter(float posX, float posY, const Character *ch, UTILS::Color color, bool roundX, std::vector<SVertex> &vertices);
   void ClearCharacterCache();
 
@@ -120,7 +151,7 @@ protected:
   virtual void DeleteHardwareTexture() = 0;
 
   // modifying glyphs
-  void SetGlyphStrength(FT_GlyphSlot slot, int glyphStrength);
+  static void SetGlyphStrength(FT_GlyphSlot slot, int glyphStrength);
   static void ObliqueGlyph(FT_GlyphSlot slot);
 
   CBaseTexture* m_texture;        // texture that holds our rendered characters (8bit alpha only)
@@ -138,10 +169,8 @@ protected:
 
   UTILS::Color m_color;
 
-  Character *m_char;                 // our characters
+  std::unordered_map<character_t, Character> m_char; // our characters, keyed by style and letter
   Character *m_charquick[LOOKUPTABLE_SIZE];     // ascii chars (7 styles) here
-  int m_maxChars;                    // size of character array (can be incremented)
-  int m_numChars;                    // the current number of cached characters
 
   float m_ellipsesWidth;               // this is used every character (width of '.')
 
@@ -153,6 +182,10 @@ protected:
   // freetype stuff
   FT_Face    m_face;
   FT_Stroker m_stroker;
+  float m_aspect;
+
+  // faces of our own for rasterising glyphs on job workers
+  std::vector<std::unique_ptr<CGlyphRasterizer>> m_rasterizers;
 
   float m_originX;
   float m_originY;
@@ -175,7 +208,7 @@ protected:
   float    m_textureScaleY;
 
   std::string m_strFileName;
-  XUTILS::auto_buffer m_fontFileInMemory; // used only in some cases, see CFreeTypeLibrary::GetFont()
+  XUTILS::auto_buffer m_fontFileInMemory; // used only in some cases, see CFreeTypeLibrary::GetFont(), shared with m_rasterizers
 
   CGUIFontCache<CGUIFontCacheStaticPosition, CGUIFontCacheStaticValue> m_staticCache;
   CGUIFontCache<CGUIFontCacheDynamicPosition, CGUIFontCacheDynamicValue> m_dynamicCache;
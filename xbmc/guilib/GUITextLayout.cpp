@@ -7,11 +7,14 @@
  */
 
 #include "GUITextLayout.h"
+#include "GUITextLayoutCache.h"
 #include "GUIFont.h"
 #include "GUIControl.h"
+#include "GUIControlProfiler.h"
 #include "GUIColorManager.h"
 #include "utils/CharsetConverter.h"
 #include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
 
 CGUIString::CGUIString(iString start, iString end, bool carriageReturn)
 {
@@ -207,9 +210,7 @@ bool CGUITextLayout::Update(const std::string &text, float maxWidth, bool forceU
 
   m_lastUtf8Text = text;
   m_lastUpdateW = false;
-  std::wstring utf16;
-  g_charsetConverter.utf8ToW(text, utf16, false);
-  UpdateCommon(utf16, maxWidth, forceLTRReadingOrder);
+  UpdateCached(text, L"", true, maxWidth, forceLTRReadingOrder);
   return true;
 }
 
@@ -220,10 +221,67 @@ bool CGUITextLayout::UpdateW(const std::wstring &text, float maxWidth /*= 0*/, b
 
   m_lastText = text;
   m_lastUpdateW = true;
-  UpdateCommon(text, maxWidth, forceLTRReadingOrder);
+  UpdateCached("", text, false, maxWidth, forceLTRReadingOrder);
   return true;
 }
 
+void CGUITextLayout::UpdateCached(const std::string &utf8Text, const std::wstring &text, bool isUtf8, float maxWidth, bool forceLTRReadingOrder)
+{
+  int64_t start = CurrentHostCounter();
+
+  CGUITextLayoutCache &cache = g_textLayoutCache;
+  CGUITextLayoutCache::Key key;
+  CGUITextLayoutCache::Layout layout;
+  bool cached = false;
+
+  if (m_font)
+  {
+    key.utf8Text = utf8Text;
+    key.text = text;
+    key.isUtf8 = isUtf8;
+    key.font = m_font;
+    key.textColor = m_textColor;
+    key.maxWidth = maxWidth;
+    key.maxHeight = m_maxHeight;
+    key.wrap = m_wrap;
+    key.forceLTRReadingOrder = forceLTRReadingOrder;
+    key.scaleX = CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleX();
+    key.scaleY = CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleY();
+    cached = cache.Lookup(key, layout);
+  }
+
+  if (cached)
+  {
+    m_lines.swap(layout.lines);
+    m_colors.swap(layout.colors);
+    m_textWidth = layout.textWidth;
+    m_textHeight = layout.textHeight;
+  }
+  else
+  {
+    if (isUtf8)
+    {
+      std::wstring utf16;
+      g_charsetConverter.utf8ToW(utf8Text, utf16, false);
+      UpdateCommon(utf16, maxWidth, forceLTRReadingOrder);
+    }
+    else
+      UpdateCommon(text, maxWidth, forceLTRReadingOrder);
+
+    if (m_font)
+    {
+      layout.lines = m_lines;
+      layout.colors = m_colors;
+      layout.textWidth = m_textWidth;
+      layout.textHeight = m_textHeight;
+      cache.Store(key, layout);
+    }
+  }
+
+  if (CGUIControlProfiler::IsRunning())
+    CGUIControlProfiler::Instance().AddTextLayout(cached, CurrentHostCounter() - start);
+}
+
 void CGUITextLayout::UpdateCommon(const std::wstring &text, float maxWidth, bool forceLTRReadingOrder)
 {
   // parse the text for style information
@@ -241,6 +299,12 @@ void CGUITextLayout::UpdateStyled(const vecText &text, const std::vector<UTILS::
   m_lines.clear();
   m_colors = colors;
 
+  // cache the glyphs in one go before measuring the text
+  if (m_font)
+    m_font->PrepareText(text);
+  if (m_borderFont)
+    m_borderFont->PrepareText(text);
+
   // if we need to wrap the text, then do so
   if (m_wrap && maxWidth > 0)
     WrapText(text, maxWidth);
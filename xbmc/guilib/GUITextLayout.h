@@ -111,6 +111,7 @@ protected:
   static std::wstring BidiFlip(const std::wstring &text, bool forceLTRReadingOrder);
   void CalcTextExtent();
   void UpdateCommon(const std::wstring &text, float maxWidth, bool forceLTRReadingOrder);
+  void UpdateCached(const std::string &utf8Text, const std::wstring &text, bool isUtf8, float maxWidth, bool forceLTRReadingOrder);
 
   /*! \brief Returns the text, utf8 encoded
    \return utf8 text
@@ -0,0 +1,111 @@
+/*
+ *  Copyright (C) 2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "GUITextLayoutCache.h"
+#include "threads/SingleLock.h"
+
+#include <functional>
+#include <iterator>
+
+#define MAX_CACHED_CHARACTERS (256 * 1024) // characters held by all entries
+#define MAX_ENTRY_CHARACTERS  (16 * 1024)  // longer texts (e.g. textboxes) aren't cached
+
+namespace
+{
+  inline void HashCombine(size_t &seed, size_t value)
+  {
+    seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  }
+}
+
+bool CGUITextLayoutCache::Key::operator==(const Key &other) const
+{
+  return isUtf8 == other.isUtf8 &&
+         font == other.font &&
+         textColor == other.textColor &&
+         maxWidth == other.maxWidth &&
+         maxHeight == other.maxHeight &&
+         wrap == other.wrap &&
+         forceLTRReadingOrder == other.forceLTRReadingOrder &&
+         scaleX == other.scaleX &&
+         scaleY == other.scaleY &&
+         utf8Text == other.utf8Text &&
+         text == other.text;
+}
+
+size_t CGUITextLayoutCache::KeyHash::operator()(const Key &key) const
+{
+  size_t seed = key.isUtf8 ? std::hash<std::string>()(key.utf8Text) : std::hash<std::wstring>()(key.text);
+  HashCombine(seed, std::hash<const CGUIFont*>()(key.font));
+  HashCombine(seed, std::hash<UTILS::Color>()(key.textColor));
+  HashCombine(seed, std::hash<float>()(key.maxWidth));
+  HashCombine(seed, std::hash<float>()(key.maxHeight));
+  HashCombine(seed, (key.wrap ? 1 : 0) | (key.forceLTRReadingOrder ? 2 : 0));
+  HashCombine(seed, std::hash<float>()(key.scaleX));
+  HashCombine(seed, std::hash<float>()(key.scaleY));
+  return seed;
+}
+
+bool CGUITextLayoutCache::Lookup(const Key &key, Layout &layout)
+{
+  CSingleLock lock(m_critSection);
+
+  auto it = m_index.find(key);
+  if (it == m_index.end())
+    return false;
+
+  // move to the front of the LRU list, iterators stay valid
+  m_entries.splice(m_entries.begin(), m_entries, it->second);
+
+  layout = it->second->layout;
+  return true;
+}
+
+void CGUITextLayoutCache::Store(const Key &key, const Layout &layout)
+{
+  const size_t characters = CountCharacters(layout) + key.utf8Text.size() + key.text.size();
+  if (characters > MAX_ENTRY_CHARACTERS)
+    return;
+
+  CSingleLock lock(m_critSection);
+
+  auto it = m_index.find(key);
+  if (it != m_index.end())
+    Remove(it->second);
+
+  while (!m_entries.empty() && m_characters + characters > MAX_CACHED_CHARACTERS)
+    Remove(std::prev(m_entries.end()));
+
+  m_entries.push_front(Entry{ key, layout, characters });
+  m_index[key] = m_entries.begin();
+  m_characters += characters;
+}
+
+void CGUITextLayoutCache::Clear()
+{
+  CSingleLock lock(m_critSection);
+
+  m_index.clear();
+  m_entries.clear();
+  m_characters = 0;
+}
+
+size_t CGUITextLayoutCache::CountCharacters(const Layout &layout)
+{
+  size_t characters = 0;
+  for (const CGUIString &line : layout.lines)
+    characters += line.m_text.size();
+  return characters;
+}
+
+void CGUITextLayoutCache::Remove(std::list<Entry>::iterator entry)
+{
+  m_characters -= entry->characters;
+  m_index.erase(entry->key);
+  m_entries.erase(entry);
+}
@@ -0,0 +1,105 @@
+/*
+ *  Copyright (C) 2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "GUITextLayout.h"
+#include "threads/CriticalSection.h"
+#include "utils/Color.h"
+#include "utils/GlobalsHandling.h"
+
+#include <list>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class CGUIFont;
+
+/*!
+ \ingroup textures
+ \brief Cache of parsed, wrapped and bidi transformed text shared by all text layouts.
+
+ Lists relayout the same labels over and over while scrolling. The cache maps
+ everything the layout of a text depends on to the resulting lines, so only
+ the first layout pays for the charset conversion, style parsing, wrapping
+ and bidi processing.
+
+ Entries refer to fonts by pointer, so the cache is cleared whenever a font is
+ destroyed or replaced. The cache is bounded by the number of characters it
+ holds, the least recently used entries are dropped first.
+ */
+class CGUITextLayoutCache
+{
+public:
+  struct Key
+  {
+    std::string utf8Text;  //!< text of Update(), empty for UpdateW()
+    std::wstring text;     //!< text of UpdateW()
+    bool isUtf8;
+    const CGUIFont *font;
+    UTILS::Color textColor;
+    float maxWidth;
+    float maxHeight;
+    bool wrap;
+    bool forceLTRReadingOrder;
+    float scaleX;          //!< the GUI scale the text is measured with
+    float scaleY;
+
+    bool operator==(const Key &other) const;
+  };
+
+  struct Layout
+  {
+    std::vector<CGUIString> lines;
+    std::vector<UTILS::Color> colors;
+    float textWidth = 0.0f;
+    float textHeight = 0.0f;
+  };
+
+  CGUITextLayoutCache() = default;
+
+  /*!
+   \brief Look up the layout of a text.
+   \return true if the layout was cached.
+   */
+  bool Lookup(const Key &key, Layout &layout);
+
+  void Store(const Key &key, const Layout &layout);
+
+  void Clear();
+
+private:
+  CGUITextLayoutCache(const CGUITextLayoutCache&) = delete;
+  CGUITextLayoutCache& operator=(const CGUITextLayoutCache&) = delete;
+
+  struct KeyHash
+  {
+    size_t operator()(const Key &key) const;
+  };
+
+  struct Entry
+  {
+    Key key;
+    Layout layout;
+    size_t characters;
+  };
+
+  static size_t CountCharacters(const Layout &layout);
+  void Remove(std::list<Entry>::iterator entry);
+
+  // most recently used first
+  std::list<Entry> m_entries;
+  std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> m_index;
+  size_t m_characters = 0;
+
+  CCriticalSection m_critSection;
+};
+
+XBMC_GLOBAL_REF(CGUITextLayoutCache, g_textLayoutCache);
+#define g_textLayoutCache XBMC_GLOBAL_USE(CGUITextLayoutCache)
@@ -24,6 +24,8 @@
 #include "input/Key.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/TraceProfiler.h"
 
 #include "windows/GUIWindowHome.h"
 #include "events/windows/GUIWindowEventLog.h"
@@ -151,6 +153,8 @@
 #include "games/dialogs/osd/DialogGameVideoRotation.h"
 #include "games/dialogs/osd/DialogGameVolume.h"
 
+#include <algorithm>
+
 using namespace KODI;
 using namespace PVR;
 using namespace PERIPHERALS;
@@ -1108,8 +1112,11 @@ bool RenderOrderSortFunction(CGUIWindow *first, CGUIWindow *second)
 void CGUIWindowManager::Process(unsigned int currentTime)
 {
   assert(g_application.IsCurrentThread());
+  KODI_TRACE_SCOPE("frame", "CGUIWindowManager::Process");
   CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
 
+  const int64_t startTime = CurrentHostCounter();
+
   m_dirtyregions.clear();
 
   CGUIWindow* pWindow = GetWindow(GetActiveWindow());
@@ -1126,6 +1133,34 @@ void CGUIWindowManager::Process(unsigned int currentTime)
 
   for (CDirtyRegionList::iterator itr = m_dirtyregions.begin(); itr != m_dirtyregions.end(); ++itr)
     m_tracker.MarkDirtyRegion(*itr);
+
+  UpdateProcessStats(currentTime, CurrentHostCounter() - startTime);
+}
+
+void CGUIWindowManager::UpdateProcessStats(unsigned int currentTime, int64_t duration)
+{
+  const int64_t durationUs = duration * 1000000 / CurrentHostFrequency();
+
+  KODI_TRACE_COUNTER("frame", "process_us", durationUs);
+  KODI_TRACE_COUNTER("frame", "dirty_regions", m_dirtyregions.size());
+
+  m_processStats.frames++;
+  m_processStats.totalUs += durationUs;
+  m_processStats.maxUs = std::max(m_processStats.maxUs, durationUs);
+  m_processStats.dirtyRegions += m_dirtyregions.size();
+
+  if (m_processStats.startTime == 0)
+    m_processStats.startTime = currentTime;
+  else if (currentTime - m_processStats.startTime >= PROCESS_STATS_INTERVAL)
+  {
+    CLog::LogFC(LOGDEBUG, LOGGUI, "Process pass over %u frames: average %.1f us, max %lld us, %.1f dirty regions per frame",
+              m_processStats.frames,
+              static_cast<double>(m_processStats.totalUs) / m_processStats.frames,
+              static_cast<long long>(m_processStats.maxUs),
+              static_cast<double>(m_processStats.dirtyRegions) / m_processStats.frames);
+    m_processStats = ProcessStats();
+    m_processStats.startTime = currentTime;
+  }
 }
 
 void CGUIWindowManager::MarkDirty()
@@ -1189,6 +1224,7 @@ void CGUIWindowManager::RenderEx() const
 bool CGUIWindowManager::Render()
 {
   assert(g_application.IsCurrentThread());
+  KODI_TRACE_SCOPE("frame", "CGUIWindowManager::Render");
   CSingleExit lock(CServiceBroker::GetWinSystem()->GetGfxContext());
 
   CDirtyRegionList dirtyRegions = m_tracker.GetDirtyRegions();
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <list>
+#include <stdint.h>
 #include <utility>
 #include <unordered_map>
 #include <vector>
@@ -249,6 +250,8 @@ private:
 
   bool HandleAction(const CAction &action) const;
 
+  void UpdateProcessStats(unsigned int currentTime, int64_t duration);
+
   std::unordered_map<int, CGUIWindow*> m_mapWindows;
   std::vector<CGUIWindow*> m_vecCustomWindows;
   std::vector<CGUIWindow*> m_activeDialogs;
@@ -268,4 +271,15 @@ private:
 
   CDirtyRegionList m_dirtyregions;
   CDirtyRegionTracker m_tracker;
+
+  // Process pass timings, logged every PROCESS_STATS_INTERVAL ms by the GUI log component
+  static const unsigned int PROCESS_STATS_INTERVAL = 10000;
+  struct ProcessStats
+  {
+    unsigned int startTime = 0;
+    unsigned int frames = 0;
+    int64_t totalUs = 0;
+    int64_t maxUs = 0;
+    size_t dirtyRegions = 0;
+  } m_processStats;
 };
@@ -7,6 +7,7 @@
  */
 
 #include "LocalizeStrings.h"
+#include "LocalizeStringsCache.h"
 #include "addons/LanguageResource.h"
 #include "utils/CharsetConverter.h"
 #include "utils/log.h"
@@ -16,6 +17,7 @@
 #include "filesystem/Directory.h"
 #include "threads/SharedSection.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "utils/StringUtils.h"
 
 
@@ -63,50 +65,29 @@ static bool LoadXML(const std::string &filename, std::map<uint32_t, LocStr>& str
   return true;
 }
 
-/*! \brief Tries to load ids and strings from a strings.po file to the `strings` map.
- * It should only be called from the LoadStr2Mem function to have a fallback.
- \param pathname The directory name, where we look for the strings file.
- \param strings [out] The resulting strings map.
- \param encoding Encoding of the strings. For PO files we only use utf-8.
- \param offset An offset value to place strings from the id value.
- \param bSourceLanguage If we are loading the source English strings.po.
- \return false if no strings.po file was loaded.
+/*! \brief Parses all id based entries of a strings.po file.
+ \param filename The strings.po file to parse.
+ \param entries [out] The id based entries of the file, in file order.
+ \param bSourceLanguage If we are parsing the source English strings.po, which has no msgstr.
+ \return false if the file could not be loaded.
  */
-static bool LoadPO(const std::string &filename, std::map<uint32_t, LocStr>& strings,
-    std::string &encoding, uint32_t offset = 0 , bool bSourceLanguage = false)
+static bool ParsePO(const std::string &filename, std::vector<CompiledStringEntry>& entries, bool bSourceLanguage)
 {
   CPODocument PODoc;
   if (!PODoc.LoadFile(filename))
     return false;
 
-  int counter = 0;
-
   while ((PODoc.GetNextEntry()))
   {
-    uint32_t id;
     if (PODoc.GetEntryType() == ID_FOUND)
     {
-      bool bStrInMem = strings.find((id = PODoc.GetEntryID()) + offset) != strings.end();
+      CompiledStringEntry entry;
+      entry.id = PODoc.GetEntryID();
       PODoc.ParseEntry(bSourceLanguage);
-
-      if (bSourceLanguage && !PODoc.GetMsgid().empty())
-      {
-        if (bStrInMem && (strings[id + offset].strOriginal.empty() ||
-                          PODoc.GetMsgid() == strings[id + offset].strOriginal))
-          continue;
-        else if (bStrInMem)
-          CLog::Log(LOGDEBUG,
-              "POParser: id:%i was recently re-used in the English string file, which is not yet "
-                  "changed in the translated file. Using the English string instead", id);
-        strings[id + offset].strTranslated = PODoc.GetMsgid();
-        counter++;
-      }
-      else if (!bSourceLanguage && !bStrInMem && !PODoc.GetMsgstr().empty())
-      {
-        strings[id + offset].strTranslated = PODoc.GetMsgstr();
-        strings[id + offset].strOriginal = PODoc.GetMsgid();
-        counter++;
-      }
+      entry.msgid = PODoc.GetMsgid();
+      if (!bSourceLanguage)
+        entry.msgstr = PODoc.GetMsgstr();
+      entries.push_back(std::move(entry));
     }
     else if (PODoc.GetEntryType() == MSGID_FOUND)
     {
@@ -123,7 +104,62 @@ static bool LoadPO(const std::string &filename, std::map<uint32_t, LocStr>& stri
     }
   }
 
-  CLog::Log(LOGDEBUG, "LocalizeStrings: loaded %i strings from file %s", counter, filename.c_str());
+  return true;
+}
+
+/*! \brief Tries to load ids and strings from a strings.po file to the `strings` map.
+ * It should only be called from the LoadStr2Mem function to have a fallback.
+ * The compiled string table from CLocalizeStringsCache is used if it is up to date,
+ * otherwise the PO file is parsed and the compiled table is refreshed.
+ \param pathname The directory name, where we look for the strings file.
+ \param strings [out] The resulting strings map.
+ \param encoding Encoding of the strings. For PO files we only use utf-8.
+ \param offset An offset value to place strings from the id value.
+ \param bSourceLanguage If we are loading the source English strings.po.
+ \return false if no strings.po file was loaded.
+ */
+static bool LoadPO(const std::string &filename, std::map<uint32_t, LocStr>& strings,
+    std::string &encoding, uint32_t offset = 0 , bool bSourceLanguage = false)
+{
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  std::vector<CompiledStringEntry> entries;
+  bool cached = CLocalizeStringsCache::Load(filename, entries);
+  if (!cached)
+  {
+    if (!ParsePO(filename, entries, bSourceLanguage))
+      return false;
+    CLocalizeStringsCache::Save(filename, entries);
+  }
+
+  int counter = 0;
+
+  for (const auto& entry : entries)
+  {
+    uint32_t id = entry.id;
+    bool bStrInMem = strings.find(id + offset) != strings.end();
+
+    if (bSourceLanguage && !entry.msgid.empty())
+    {
+      if (bStrInMem && (strings[id + offset].strOriginal.empty() ||
+                        entry.msgid == strings[id + offset].strOriginal))
+        continue;
+      else if (bStrInMem)
+        CLog::Log(LOGDEBUG,
+            "POParser: id:%i was recently re-used in the English string file, which is not yet "
+                "changed in the translated file. Using the English string instead", id);
+      strings[id + offset].strTranslated = entry.msgid;
+      counter++;
+    }
+    else if (!bSourceLanguage && !bStrInMem && !entry.msgstr.empty())
+    {
+      strings[id + offset].strTranslated = entry.msgstr;
+      strings[id + offset].strOriginal = entry.msgid;
+      counter++;
+    }
+  }
+
+  CLog::Log(LOGDEBUG, "LocalizeStrings: loaded %i strings from %s file %s in %u ms", counter,
+            cached ? "compiled" : "PO", filename.c_str(), XbmcThreads::SystemClockMillis() - start);
   return true;
 }
 
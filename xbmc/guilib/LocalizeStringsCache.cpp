@@ -0,0 +1,250 @@
+/*
+ *  Copyright (C) 2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "LocalizeStringsCache.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "utils/auto_buffer.h"
+#include "utils/Crc32.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+
+#include <algorithm>
+#include <cstring>
+
+#define STRINGS_CACHE_FOLDER "special://masterprofile/Cache/strings/"
+#define STRINGS_CACHE_MAGIC "KSTB"
+#define STRINGS_CACHE_VERSION 2
+#define STRINGS_CACHE_NO_ENTRY 0xFFFFFFFF
+// a file whose id range is much wider than its entry count is not compiled,
+// e.g. a single stray id far away from the block of the add-on
+#define STRINGS_CACHE_MAX_SPARSE_SLOTS 1024
+
+namespace
+{
+
+/*
+ * Layout of a compiled table:
+ *
+ *   CacheHeader
+ *   char path[pathSize]          full path of the source file, the file name is only a hash of it
+ *   uint32_t offsets[2 * slots]  msgid/msgstr offsets into the blob for id firstId + slot
+ *   char blob[blobSize]          uint32_t length + utf-8 bytes per string
+ *
+ * All values are stored in host byte order, the cache is never shared between machines.
+ */
+struct CacheHeader
+{
+  char magic[4];
+  uint32_t version;
+  uint32_t pathSize;
+  uint32_t blobCrc;
+  int64_t sourceTime;
+  int64_t sourceSize;
+  uint32_t firstId;
+  uint32_t slots;
+  uint32_t entries;
+  uint32_t blobSize;
+};
+
+uint32_t AppendString(std::string& blob, const std::string& str)
+{
+  uint32_t offset = static_cast<uint32_t>(blob.size());
+  uint32_t length = static_cast<uint32_t>(str.size());
+  blob.append(reinterpret_cast<const char*>(&length), sizeof(length));
+  blob.append(str);
+  return offset;
+}
+
+bool ReadString(const char* blob, uint32_t blobSize, uint32_t offset, std::string& str)
+{
+  if (offset == STRINGS_CACHE_NO_ENTRY)
+  {
+    str.clear();
+    return true;
+  }
+
+  uint32_t length;
+  if (offset > blobSize || blobSize - offset < sizeof(length))
+    return false;
+  memcpy(&length, blob + offset, sizeof(length));
+  offset += sizeof(length);
+  if (blobSize - offset < length)
+    return false;
+
+  str.assign(blob + offset, length);
+  return true;
+}
+
+} // unnamed namespace
+
+std::string CLocalizeStringsCache::GetCacheFile(const std::string& poFile)
+{
+  return StringUtils::Format("%s%08x.bin", STRINGS_CACHE_FOLDER, Crc32::Compute(poFile));
+}
+
+bool CLocalizeStringsCache::GetSourceInfo(const std::string& poFile, int64_t& mtime, int64_t& size)
+{
+  struct __stat64 st;
+  if (XFILE::CFile::Stat(poFile, &st) != 0)
+    return false;
+
+  mtime = static_cast<int64_t>(st.st_mtime);
+  size = static_cast<int64_t>(st.st_size);
+  return true;
+}
+
+bool CLocalizeStringsCache::Load(const std::string& poFile, std::vector<CompiledStringEntry>& entries)
+{
+  int64_t sourceTime, sourceSize;
+  if (!GetSourceInfo(poFile, sourceTime, sourceSize))
+    return false;
+
+  const std::string cacheFile = GetCacheFile(poFile);
+  if (!XFILE::CFile::Exists(cacheFile))
+    return false;
+
+  XFILE::CFile file;
+  XUTILS::auto_buffer buffer;
+  if (file.LoadFile(cacheFile, buffer) < static_cast<ssize_t>(sizeof(CacheHeader)))
+    return false;
+
+  CacheHeader header;
+  memcpy(&header, buffer.get(), sizeof(header));
+  if (memcmp(header.magic, STRINGS_CACHE_MAGIC, sizeof(header.magic)) != 0 ||
+      header.version != STRINGS_CACHE_VERSION ||
+      header.pathSize != poFile.size() ||
+      header.sourceTime != sourceTime ||
+      header.sourceSize != sourceSize)
+    return false;
+
+  const size_t offsetsSize = static_cast<size_t>(header.slots) * 2 * sizeof(uint32_t);
+  if (buffer.size() != sizeof(header) + header.pathSize + offsetsSize + header.blobSize)
+  {
+    CLog::Log(LOGDEBUG, "CLocalizeStringsCache: ignoring truncated cache file %s for %s", cacheFile.c_str(), poFile.c_str());
+    return false;
+  }
+
+  // two source paths may share a cache file name, only the full path identifies the source
+  const char* path = buffer.get() + sizeof(header);
+  if (poFile.compare(0, std::string::npos, path, header.pathSize) != 0)
+    return false;
+
+  const char* offsets = path + header.pathSize;
+  const char* blob = offsets + offsetsSize;
+
+  Crc32 crc;
+  crc.Compute(blob, header.blobSize);
+  if (static_cast<uint32_t>(crc) != header.blobCrc)
+  {
+    CLog::Log(LOGDEBUG, "CLocalizeStringsCache: ignoring corrupt cache file %s for %s", cacheFile.c_str(), poFile.c_str());
+    return false;
+  }
+
+  std::vector<CompiledStringEntry> result;
+  result.reserve(header.entries);
+  for (uint32_t slot = 0; slot < header.slots; ++slot)
+  {
+    uint32_t slotOffsets[2];
+    memcpy(slotOffsets, offsets + slot * sizeof(slotOffsets), sizeof(slotOffsets));
+    if (slotOffsets[0] == STRINGS_CACHE_NO_ENTRY && slotOffsets[1] == STRINGS_CACHE_NO_ENTRY)
+      continue;
+
+    CompiledStringEntry entry;
+    entry.id = header.firstId + slot;
+    if (!ReadString(blob, header.blobSize, slotOffsets[0], entry.msgid) ||
+        !ReadString(blob, header.blobSize, slotOffsets[1], entry.msgstr))
+      return false;
+    result.push_back(std::move(entry));
+  }
+
+  entries = std::move(result);
+  return true;
+}
+
+bool CLocalizeStringsCache::Save(const std::string& poFile, const std::vector<CompiledStringEntry>& entries)
+{
+  CacheHeader header = {};
+  memcpy(header.magic, STRINGS_CACHE_MAGIC, sizeof(header.magic));
+  header.version = STRINGS_CACHE_VERSION;
+  header.pathSize = static_cast<uint32_t>(poFile.size());
+  if (!GetSourceInfo(poFile, header.sourceTime, header.sourceSize))
+    return false;
+
+  // the dense offset table covers the id range of this file only, PO files
+  // use contiguous id blocks so the table stays small
+  uint32_t lastId = 0;
+  header.firstId = STRINGS_CACHE_NO_ENTRY;
+  for (const auto& entry : entries)
+  {
+    header.firstId = std::min(header.firstId, entry.id);
+    lastId = std::max(lastId, entry.id);
+  }
+  const uint64_t slots = entries.empty() ? 0 : static_cast<uint64_t>(lastId) - header.firstId + 1;
+
+  // a sparse file stays uncached and is parsed on every load
+  if (slots > entries.size() + STRINGS_CACHE_MAX_SPARSE_SLOTS)
+  {
+    CLog::Log(LOGDEBUG, "CLocalizeStringsCache: not caching %s, %u entries spread over ids %u-%u",
+              poFile.c_str(), static_cast<unsigned int>(entries.size()), header.firstId, lastId);
+    const std::string cacheFile = GetCacheFile(poFile);
+    if (XFILE::CFile::Exists(cacheFile))
+      XFILE::CFile::Delete(cacheFile);
+    return false;
+  }
+  header.slots = static_cast<uint32_t>(slots);
+
+  std::vector<uint32_t> offsets(static_cast<size_t>(header.slots) * 2, STRINGS_CACHE_NO_ENTRY);
+  std::string blob;
+  for (const auto& entry : entries)
+  {
+    const size_t slot = entry.id - header.firstId;
+    // the first occurrence of an id wins, like it does when parsing the file
+    if (offsets[slot * 2] != STRINGS_CACHE_NO_ENTRY || offsets[slot * 2 + 1] != STRINGS_CACHE_NO_ENTRY)
+      continue;
+    if (!entry.msgid.empty())
+      offsets[slot * 2] = AppendString(blob, entry.msgid);
+    if (!entry.msgstr.empty())
+      offsets[slot * 2 + 1] = AppendString(blob, entry.msgstr);
+    if (!entry.msgid.empty() || !entry.msgstr.empty())
+      header.entries++;
+  }
+  header.blobSize = static_cast<uint32_t>(blob.size());
+
+  Crc32 crc;
+  crc.Compute(blob.c_str(), blob.size());
+  header.blobCrc = crc;
+
+  if (!XFILE::CDirectory::Exists(STRINGS_CACHE_FOLDER))
+  {
+    XFILE::CDirectory::Create(URIUtils::GetParentPath(STRINGS_CACHE_FOLDER));
+    if (!XFILE::CDirectory::Create(STRINGS_CACHE_FOLDER))
+      return false;
+  }
+
+  const std::string cacheFile = GetCacheFile(poFile);
+  XFILE::CFile file;
+  if (!file.OpenForWrite(cacheFile, true))
+  {
+    CLog::Log(LOGDEBUG, "CLocalizeStringsCache: unable to write cache file %s", cacheFile.c_str());
+    return false;
+  }
+
+  const size_t offsetsSize = offsets.size() * sizeof(uint32_t);
+  bool ok = file.Write(&header, sizeof(header)) == static_cast<ssize_t>(sizeof(header)) &&
+            (poFile.empty() || file.Write(poFile.c_str(), poFile.size()) == static_cast<ssize_t>(poFile.size())) &&
+            (offsetsSize == 0 || file.Write(offsets.data(), offsetsSize) == static_cast<ssize_t>(offsetsSize)) &&
+            (blob.empty() || file.Write(blob.c_str(), blob.size()) == static_cast<ssize_t>(blob.size()));
+  file.Close();
+
+  if (!ok)
+    XFILE::CFile::Delete(cacheFile);
+
+  return ok;
+}
@@ -0,0 +1,58 @@
+/*
+ *  Copyright (C) 2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/*!
+ \ingroup strings
+ \brief A single id based entry of a strings.po file.
+ */
+struct CompiledStringEntry
+{
+  uint32_t id;
+  std::string msgid;
+  std::string msgstr;
+};
+
+/*!
+ \ingroup strings
+ \brief Binary cache of compiled strings.po files.
+
+ Parsing the PO text files of the core language, the skin and every add-on is
+ a large part of the language loading time. This cache keeps a compiled copy
+ of each parsed PO file in the userdata folder. The compiled table is id indexed:
+ a dense offset array covering the id range of the file, followed by a string blob,
+ so an entry can be located without any parsing. A cached table is only used while
+ the full path, modification time and size of its source file are unchanged. Files
+ whose ids are spread too sparsely for a dense table are not cached.
+ */
+class CLocalizeStringsCache
+{
+public:
+  /*! \brief Loads the compiled table of the given PO file.
+   \param poFile path of the source strings.po file.
+   \param entries [out] the entries of the file, ordered by id.
+   \return false if there is no valid compiled table for the current source file.
+   */
+  static bool Load(const std::string& poFile, std::vector<CompiledStringEntry>& entries);
+
+  /*! \brief Stores a compiled table for the given PO file.
+   \param poFile path of the source strings.po file.
+   \param entries the entries parsed from the source file.
+   \return true if the compiled table was written.
+   */
+  static bool Save(const std::string& poFile, const std::vector<CompiledStringEntry>& entries);
+
+private:
+  static std::string GetCacheFile(const std::string& poFile);
+  static bool GetSourceInfo(const std::string& poFile, int64_t& mtime, int64_t& size);
+};
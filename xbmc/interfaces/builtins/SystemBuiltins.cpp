@@ -9,7 +9,9 @@
 #include "SystemBuiltins.h"
 
 #include "messaging/ApplicationMessenger.h"
+#include "utils/log.h"
 #include "utils/StringUtils.h"
+#include "utils/TraceProfiler.h"
 
 using namespace KODI::MESSAGING;
 
@@ -130,6 +132,39 @@ static int Suspend(const std::vector<std::string>& params)
   return 0;
 }
 
+/*! \brief Start recording a performance trace.
+ *  \param params (ignored)
+ */
+static int StartTrace(const std::vector<std::string>& params)
+{
+  if (!CTraceProfiler::IsAvailable())
+  {
+    CLog::Log(LOGERROR, "StartTrace: Kodi was built without trace profiler support");
+    return -1;
+  }
+
+  CTraceProfiler::GetInstance().Start();
+
+  return 0;
+}
+
+/*! \brief Stop recording a performance trace and write it to a file.
+ *  \param params The parameters.
+ *  \details params[0] = The file to write (optional, a new file in special://temp/ by default).
+ */
+static int StopTrace(const std::vector<std::string>& params)
+{
+  if (!CTraceProfiler::GetInstance().Stop())
+  {
+    CLog::Log(LOGERROR, "StopTrace: tracing is not running");
+    return -1;
+  }
+
+  if (params.empty() ? CTraceProfiler::GetInstance().Export().empty() : !CTraceProfiler::GetInstance().Export(params[0]))
+    return -1;
+
+  return 0;
+}
 
 // Note: For new Texts with comma add a "\" before!!! Is used for table text.
 //
@@ -215,6 +250,17 @@ static int Suspend(const std::vector<std::string>& params)
 ///     Execute shell commands and freezes Kodi until shell is closed
 ///     @param[in] exec                  The path to the executable
 ///   }
+///   \table_row2_l{
+///     <b>`System.StartTrace`</b>
+///     ,
+///     Starts recording a performance trace (only available if Kodi was built with ENABLE_TRACE_PROFILER)
+///   }
+///   \table_row2_l{
+///     <b>`System.StopTrace[(file)]`</b>
+///     ,
+///     Stops recording the performance trace and writes it in Chrome trace format
+///     @param[in] file                  The file to write (optional\, defaults to a new special://temp/kodi-trace-YYYYMMDD_HHMMSS.json)
+///   }
 /// \table_end
 ///
 
@@ -234,6 +280,8 @@ CBuiltins::CommandMap CSystemBuiltins::GetOperations() const
            {"shutdown",            {"Shutdown the system", 0, Shutdown}},
            {"suspend",             {"Suspends the system", 0, Suspend}},
            {"system.exec",         {"Execute shell commands", 1, Exec<0>}},
-           {"system.execwait",     {"Execute shell commands and freezes Kodi until shell is closed", 1, Exec<1>}}
+           {"system.execwait",     {"Execute shell commands and freezes Kodi until shell is closed", 1, Exec<1>}},
+           {"system.starttrace",   {"Start recording a performance trace", 0, StartTrace}},
+           {"system.stoptrace",    {"Stop recording a performance trace", 0, StopTrace}}
          };
 }
@@ -27,6 +27,7 @@ public:
   const std::string &GetScript() const { return m_script; };
   LanguageInvokerPtr GetInvoker() const { return m_invoker; };
   bool Reuseable(const std::string &script) const { return !m_bStop && m_reusable && GetState() == InvokerStateScriptDone && m_script == script; };
+  bool IsBusy() const { return !m_bStop && m_reusable && GetState() < InvokerStateStopping; };
   virtual void Release();
 
 protected:
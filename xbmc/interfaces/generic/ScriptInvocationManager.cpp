@@ -8,6 +8,7 @@
 
 #include "ScriptInvocationManager.h"
 
+#include <algorithm>
 #include <cerrno>
 #include <utility>
 #include <vector>
@@ -16,7 +17,9 @@
 #include "interfaces/generic/ILanguageInvocationHandler.h"
 #include "interfaces/generic/ILanguageInvoker.h"
 #include "interfaces/generic/LanguageInvokerThread.h"
+#include "settings/AdvancedSettings.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/log.h"
@@ -77,8 +80,8 @@ void CScriptInvocationManager::Uninitialize()
   // execute Process() once more to handle the remaining scripts
   Process();
 
-  // it is safe to relese early, thread must be in m_scripts too
-  m_lastInvokerThread = nullptr;
+  // it is safe to relese early, threads must be in m_scripts too
+  m_reusableInvokerThreads.clear();
 
   // make sure all scripts are done
   std::vector<LanguageInvokerThread> tempList;
@@ -180,17 +183,55 @@ bool CScriptInvocationManager::HasLanguageInvoker(const std::string &script) con
   return it != m_invocationHandlers.end() && it->second != NULL;
 }
 
-int CScriptInvocationManager::GetReusablePluginHandle(const std::string &script)
+CLanguageInvokerThreadPtr CScriptInvocationManager::getReusableInvokerThread(const std::string &script)
 {
-  CSingleLock lock(m_critSection);
+  ReusableInvokerThreadMap::iterator it = m_reusableInvokerThreads.find(script);
+  if (it == m_reusableInvokerThreads.end())
+    return nullptr;
 
-  if (m_lastInvokerThread)
+  if (it->second.thread->Reuseable(script))
+    return it->second.thread;
+
+  // keep invokers which are still running the script, they return to the pool when done
+  if (!it->second.thread->IsBusy())
   {
-    if (m_lastInvokerThread->Reuseable(script))
-      return m_lastPluginHandle;
-    m_lastInvokerThread->Release();
-    m_lastInvokerThread = nullptr;
+    it->second.thread->Release();
+    m_reusableInvokerThreads.erase(it);
   }
+  return nullptr;
+}
+
+bool CScriptInvocationManager::reserveReusableInvokerThread()
+{
+  const size_t poolSize = static_cast<size_t>(std::max(g_advancedSettings.m_pythonInvokerPoolSize, 1));
+  while (m_reusableInvokerThreads.size() >= poolSize)
+  {
+    // release the least recently used idle invoker
+    ReusableInvokerThreadMap::iterator oldest = m_reusableInvokerThreads.end();
+    for (ReusableInvokerThreadMap::iterator it = m_reusableInvokerThreads.begin(); it != m_reusableInvokerThreads.end(); ++it)
+    {
+      if (it->second.thread->IsBusy())
+        continue;
+      if (oldest == m_reusableInvokerThreads.end() || it->second.lastUsed < oldest->second.lastUsed)
+        oldest = it;
+    }
+
+    if (oldest == m_reusableInvokerThreads.end())
+      return false;
+
+    CLog::Log(LOGDEBUG, "%s - Releasing pooled LanguageInvokerThread %d for script %s", __FUNCTION__, oldest->second.thread->GetId(), oldest->first.c_str());
+    oldest->second.thread->Release();
+    m_reusableInvokerThreads.erase(oldest);
+  }
+  return true;
+}
+
+int CScriptInvocationManager::GetReusablePluginHandle(const std::string &script)
+{
+  CSingleLock lock(m_critSection);
+
+  if (getReusableInvokerThread(script))
+    return m_reusableInvokerThreads[script].pluginHandle;
   return -1;
 }
 
@@ -198,16 +239,13 @@ LanguageInvokerPtr CScriptInvocationManager::GetLanguageInvoker(const std::strin
 {
   CSingleLock lock(m_critSection);
 
-  if (m_lastInvokerThread)
+  CLanguageInvokerThreadPtr invokerThread = getReusableInvokerThread(script);
+  if (invokerThread)
   {
-    if (m_lastInvokerThread->Reuseable(script))
-    {
-      CLog::Log(LOGDEBUG, "%s - Reusing LanguageInvokerThread %d for script %s", __FUNCTION__, m_lastInvokerThread->GetId(), script.c_str());
-      m_lastInvokerThread->GetInvoker()->Reset();
-      return m_lastInvokerThread->GetInvoker();
-    }
-    m_lastInvokerThread->Release();
-    m_lastInvokerThread = nullptr;
+    CLog::Log(LOGDEBUG, "%s - Reusing LanguageInvokerThread %d for script %s", __FUNCTION__, invokerThread->GetId(), script.c_str());
+    invokerThread->GetInvoker()->Reset();
+    m_reusableInvokerThreads[script].lastUsed = XbmcThreads::SystemClockMillis();
+    return invokerThread->GetInvoker();
   }
 
   std::string extension = URIUtils::GetExtension(script);
@@ -257,34 +295,42 @@ int CScriptInvocationManager::ExecuteAsync(const std::string &script,
 
   CSingleLock lock(m_critSection);
 
-  if (m_lastInvokerThread && m_lastInvokerThread->GetInvoker() == languageInvoker)
+  ReusableInvokerThreadMap::iterator pooled = m_reusableInvokerThreads.find(script);
+  if (pooled != m_reusableInvokerThreads.end() && pooled->second.thread->GetInvoker() == languageInvoker)
   {
     if (addon != NULL)
-      m_lastInvokerThread->SetAddon(addon);
+      pooled->second.thread->SetAddon(addon);
 
-    // After we leave the lock, m_lastInvokerThread can be released -> copy!
-    CLanguageInvokerThreadPtr invokerThread = m_lastInvokerThread;
+    // After we leave the lock, the pooled thread can be released -> copy!
+    CLanguageInvokerThreadPtr invokerThread = pooled->second.thread;
     lock.Leave();
     invokerThread->Execute(script, arguments);
 
     return invokerThread->GetId();
   }
 
-  m_lastInvokerThread = CLanguageInvokerThreadPtr(new CLanguageInvokerThread(languageInvoker, this, reuseable));
-  if (m_lastInvokerThread == NULL)
+  // only pool the new invoker if there's room and no other invoker of the script is pooled
+  if (reuseable)
+    reuseable = pooled == m_reusableInvokerThreads.end() && reserveReusableInvokerThread();
+
+  CLanguageInvokerThreadPtr invokerThread = CLanguageInvokerThreadPtr(new CLanguageInvokerThread(languageInvoker, this, reuseable));
+  if (invokerThread == NULL)
     return -1;
 
   if (addon != NULL)
-    m_lastInvokerThread->SetAddon(addon);
+    invokerThread->SetAddon(addon);
 
-  m_lastInvokerThread->SetId(m_nextId++);
-  m_lastPluginHandle = pluginHandle;
+  invokerThread->SetId(m_nextId++);
+
+  if (reuseable)
+  {
+    ReusableInvokerThread reusableThread = { invokerThread, pluginHandle, XbmcThreads::SystemClockMillis() };
+    m_reusableInvokerThreads[script] = reusableThread;
+  }
 
-  LanguageInvokerThread thread = { m_lastInvokerThread, script, false };
-  m_scripts.insert(std::make_pair(m_lastInvokerThread->GetId(), thread));
-  m_scriptPaths.insert(std::make_pair(script, m_lastInvokerThread->GetId()));
-  // After we leave the lock, m_lastInvokerThread can be released -> copy!
-  CLanguageInvokerThreadPtr invokerThread = m_lastInvokerThread;
+  LanguageInvokerThread thread = { invokerThread, script, false };
+  m_scripts.insert(std::make_pair(invokerThread->GetId(), thread));
+  m_scriptPaths.insert(std::make_pair(script, invokerThread->GetId()));
   lock.Leave();
   invokerThread->Execute(script, arguments);
 
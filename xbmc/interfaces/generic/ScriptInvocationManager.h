@@ -35,7 +35,7 @@ public:
   LanguageInvokerPtr GetLanguageInvoker(const std::string &script);
 
   /*!
-  * \brief Returns addon_handle if last reusable invoker is ready to use.
+  * \brief Returns addon_handle if a pooled reusable invoker for the script is ready to use.
   */
   int GetReusablePluginHandle(const std::string &script);
 
@@ -137,12 +137,30 @@ private:
   typedef std::map<int, LanguageInvokerThread> LanguageInvokerThreadMap;
   typedef std::map<std::string, ILanguageInvocationHandler*> LanguageInvocationHandlerMap;
 
+  typedef struct {
+    CLanguageInvokerThreadPtr thread;
+    int pluginHandle;
+    unsigned int lastUsed;
+  } ReusableInvokerThread;
+  typedef std::map<std::string, ReusableInvokerThread> ReusableInvokerThreadMap;
+
   LanguageInvokerThread getInvokerThread(int scriptId) const;
 
+  /*!
+  * \brief Returns the pooled invoker thread of the script if it can run the script again.
+  * Pooled threads which can't be reused anymore are released.
+  */
+  CLanguageInvokerThreadPtr getReusableInvokerThread(const std::string &script);
+
+  /*!
+  * \brief Makes room for another pooled invoker thread.
+  * \return false if the pool is full of busy invoker threads.
+  */
+  bool reserveReusableInvokerThread();
+
   LanguageInvocationHandlerMap m_invocationHandlers;
   LanguageInvokerThreadMap m_scripts;
-  CLanguageInvokerThreadPtr m_lastInvokerThread;
-  int m_lastPluginHandle;
+  ReusableInvokerThreadMap m_reusableInvokerThreads;
 
   std::map<std::string, int> m_scriptPaths;
   int m_nextId = 0;
@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <stdint.h>
+
 namespace JSONRPC
 {
   class IClient
@@ -17,5 +19,15 @@ namespace JSONRPC
     virtual int GetPermissionFlags() = 0;
     virtual int GetAnnouncementFlags() = 0;
     virtual bool SetAnnouncementFlags(int flags) = 0;
+
+    /*!
+     \brief Get how notifications are batched for the client
+     \param window ms notifications are collected for before they are sent as one batch, 0 if they aren't batched
+     \param queueSize max number of notifications in a batch, older ones are dropped
+     \param dropped number of notifications dropped so far
+     \return false if the client can't batch notifications
+     */
+    virtual bool GetNotificationBatching(int &window, int &queueSize, uint64_t &dropped) { return false; }
+    virtual bool SetNotificationBatching(int window, int queueSize) { return false; }
   };
 }
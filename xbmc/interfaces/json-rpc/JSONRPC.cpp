@@ -99,6 +99,8 @@ void CJSONRPC::Initialize()
   for (unsigned int index = 0; index < size; index++)
     CJSONServiceDescription::AddNotification(JSONRPC_SERVICE_NOTIFICATIONS[index]);
 
+  CJSONServiceDescription::ResolveReferences();
+
   m_initialized = true;
   CLog::Log(LOGINFO, "JSONRPC v%s: Successfully initialized", CJSONServiceDescription::GetVersion());
 }
@@ -161,6 +163,15 @@ JSONRPC_STATUS CJSONRPC::GetConfiguration(const std::string &method, ITransportL
   for (int i = 1; i <= ANNOUNCE_ALL; i *= 2)
     result["notifications"][AnnouncementFlagToString((AnnouncementFlag)i)] = (flags & i) == i;
 
+  int window, queueSize;
+  uint64_t dropped;
+  if (client->GetNotificationBatching(window, queueSize, dropped))
+  {
+    result["batching"]["window"] = window;
+    result["batching"]["queuesize"] = queueSize;
+    result["batching"]["dropped"] = dropped;
+  }
+
   return OK;
 }
 
@@ -204,6 +215,23 @@ JSONRPC_STATUS CJSONRPC::SetConfiguration(const std::string &method, ITransportL
   if (!client->SetAnnouncementFlags(flags))
     return BadPermission;
 
+  if (parameterObject.isMember("batching"))
+  {
+    int window, queueSize;
+    uint64_t dropped;
+    if (!client->GetNotificationBatching(window, queueSize, dropped))
+      return BadPermission;
+
+    const CVariant &batching = parameterObject["batching"];
+    if (batching["window"].isInteger())
+      window = static_cast<int>(batching["window"].asInteger());
+    if (batching["queuesize"].isInteger())
+      queueSize = static_cast<int>(batching["queuesize"].asInteger());
+
+    if (!client->SetNotificationBatching(window, queueSize))
+      return InvalidParams;
+  }
+
   return GetConfiguration(method, transport, client, parameterObject, result);
 }
 
@@ -229,28 +257,31 @@ std::string CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer
 
   CLog::Log(LOGDEBUG, LOGJSONRPC, "JSONRPC: Incoming request: %s", inputString.c_str());
 
-  if (CJSONVariantParser::Parse(inputString, inputroot) && !inputroot.isNull())
+  // The calls of a batch are handled as they are parsed, the whole batch is
+  // never held in memory
+  unsigned int batchCalls = 0;
+  auto handleBatchCall = [&](CVariant& request)
+  {
+    batchCalls++;
+    CVariant response;
+    if (HandleMethodCall(request, response, transport, client))
+    {
+      outputroot.append(std::move(response));
+      hasResponse = true;
+    }
+    return true;
+  };
+
+  if (CJSONVariantParser::Parse(inputString, inputroot, handleBatchCall) && !inputroot.isNull())
   {
     if (inputroot.isArray())
     {
-      if (inputroot.size() <= 0)
+      if (batchCalls == 0)
       {
         CLog::Log(LOGERROR, "JSONRPC: Empty batch call\n");
         BuildResponse(inputroot, InvalidRequest, CVariant(), outputroot);
         hasResponse = true;
       }
-      else
-      {
-        for (CVariant::const_iterator_array itr = inputroot.begin_array(); itr != inputroot.end_array(); itr++)
-        {
-          CVariant response;
-          if (HandleMethodCall(*itr, response, transport, client))
-          {
-            outputroot.append(response);
-            hasResponse = true;
-          }
-        }
-      }
     }
     else
       hasResponse = HandleMethodCall(inputroot, outputroot, transport, client);
@@ -191,6 +191,8 @@ JsonRpcMethodMap CJSONServiceDescription::m_methodMaps[] = {
   { "System.Suspend",                               CSystemOperations::Suspend },
   { "System.Hibernate",                             CSystemOperations::Hibernate },
   { "System.Reboot",                                CSystemOperations::Reboot },
+  { "System.StartTrace",                            CSystemOperations::StartTrace },
+  { "System.StopTrace",                             CSystemOperations::StopTrace },
 
 // Input operations
   { "Input.SendText",                               CInputOperations::SendText },
@@ -628,14 +630,28 @@ bool JSONSchemaTypeDefinition::Parse(const CVariant &value, bool isParameter /*
 
 JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &outputValue, CVariant &errorData)
 {
-  if (!name.empty())
-    errorData["name"] = name;
-  SchemaValueTypeToJson(type, errorData["type"]);
-  std::string errorMessage;
-
   if (referencedType != NULL && !referencedTypeSet)
     Set(referencedType);
 
+  // The error data is only filled in for values that don't match, so
+  // checking a valid value doesn't allocate anything for it. An extended
+  // type that failed already put its own name and type in there.
+  JSONRPC_STATUS status = checkValue(value, outputValue, errorData);
+  if (status != OK)
+  {
+    if (!name.empty() && !errorData.isMember("name"))
+      errorData["name"] = name;
+    if (!errorData.isMember("type"))
+      SchemaValueTypeToJson(type, errorData["type"]);
+  }
+
+  return status;
+}
+
+JSONRPC_STATUS JSONSchemaTypeDefinition::checkValue(const CVariant &value, CVariant &outputValue, CVariant &errorData) const
+{
+  std::string errorMessage;
+
   // Let's check the type of the provided parameter
   if (!IsType(value, type))
   {
@@ -721,10 +737,12 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
       for (unsigned int arrayIndex = 0; arrayIndex < value.size(); arrayIndex++)
       {
         CVariant temp;
-        JSONRPC_STATUS status = itemType->Check(value[arrayIndex], temp, errorData["property"]);
-        outputValue.push_back(temp);
+        CVariant propertyError;
+        JSONRPC_STATUS status = itemType->Check(value[arrayIndex], temp, propertyError);
+        outputValue.push_back(std::move(temp));
         if (status != OK)
         {
+          errorData["property"] = std::move(propertyError);
           CLog::Log(LOGDEBUG, "JSONRPC: Array element at index %u does not match in type %s", arrayIndex, name.c_str());
           errorMessage = StringUtils::Format("array element at index %u does not match", arrayIndex);
           errorData["message"] = errorMessage.c_str();
@@ -757,9 +775,11 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
       unsigned int arrayIndex;
       for (arrayIndex = 0; arrayIndex < std::min(items.size(), (size_t)value.size()); arrayIndex++)
       {
-        JSONRPC_STATUS status = items.at(arrayIndex)->Check(value[arrayIndex], outputValue[arrayIndex], errorData["property"]);
+        CVariant propertyError;
+        JSONRPC_STATUS status = items.at(arrayIndex)->Check(value[arrayIndex], outputValue[arrayIndex], propertyError);
         if (status != OK)
         {
+          errorData["property"] = std::move(propertyError);
           CLog::Log(LOGDEBUG, "JSONRPC: Array element at index %u does not match with items schema in type %s", arrayIndex, name.c_str());
           return status;
         }
@@ -827,9 +847,11 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
     {
       if (value.isMember(propertiesIterator->second->name))
       {
-        JSONRPC_STATUS status = propertiesIterator->second->Check(value[propertiesIterator->second->name], outputValue[propertiesIterator->second->name], errorData["property"]);
+        CVariant propertyError;
+        JSONRPC_STATUS status = propertiesIterator->second->Check(value[propertiesIterator->second->name], outputValue[propertiesIterator->second->name], propertyError);
         if (status != OK)
         {
+          errorData["property"] = std::move(propertyError);
           CLog::Log(LOGDEBUG, "JSONRPC: Invalid property \"%s\" in type %s", propertiesIterator->second->name.c_str(), name.c_str());
           return status;
         }
@@ -865,13 +887,15 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
           // object
           if (additionalProperties->type == AnyValue)
           {
-            outputValue[iter->first] = value[iter->first];
+            outputValue[iter->first] = iter->second;
             continue;
           }
 
-          JSONRPC_STATUS status = additionalProperties->Check(value[iter->first], outputValue[iter->first], errorData["property"]);
+          CVariant propertyError;
+          JSONRPC_STATUS status = additionalProperties->Check(iter->second, outputValue[iter->first], propertyError);
           if (status != OK)
           {
+            errorData["property"] = std::move(propertyError);
             CLog::Log(LOGDEBUG, "JSONRPC: Invalid additional property \"%s\" in type %s", iter->first.c_str(), name.c_str());
             return status;
           }
@@ -1165,6 +1189,32 @@ void JSONSchemaTypeDefinition::Set(const JSONSchemaTypeDefinitionPtr typeDefinit
   referencedTypeSet = true;
 }
 
+void JSONSchemaTypeDefinition::ResolveReferences(std::set<const JSONSchemaTypeDefinition*> &resolved)
+{
+  // Types can reference themselves (e.g. filter rules)
+  if (!resolved.insert(this).second)
+    return;
+
+  if (referencedType != NULL && !referencedTypeSet)
+  {
+    referencedType->ResolveReferences(resolved);
+    Set(referencedType);
+  }
+
+  for (const auto &extendedType : extends)
+    extendedType->ResolveReferences(resolved);
+  for (const auto &unionType : unionTypes)
+    unionType->ResolveReferences(resolved);
+  for (const auto &itemType : items)
+    itemType->ResolveReferences(resolved);
+  for (const auto &itemType : additionalItems)
+    itemType->ResolveReferences(resolved);
+  for (JSONSchemaTypeDefinition::CJsonSchemaPropertiesMap::JSONSchemaPropertiesIterator it = properties.begin(); it != properties.end(); ++it)
+    it->second->ResolveReferences(resolved);
+  if (additionalProperties != NULL)
+    additionalProperties->ResolveReferences(resolved);
+}
+
 JSONSchemaTypeDefinition::CJsonSchemaPropertiesMap::CJsonSchemaPropertiesMap() :
    m_propertiesmap(std::map<std::string, JSONSchemaTypeDefinitionPtr>())
 {
@@ -1354,13 +1404,17 @@ JSONRPC_STATUS JsonRpcMethod::checkParameter(const CVariant &requestParameters,
   // Let's check if the parameter has been provided
   if (ParameterExists(requestParameters, type->name, position))
   {
-    // Get the parameter
-    CVariant parameterValue = GetParameter(requestParameters, type->name, position);
+    // Get the parameter without copying it
+    const CVariant &parameterValue = IsValueMember(requestParameters, type->name) ? requestParameters[type->name] : requestParameters[position];
 
     // Evaluate the type of the parameter
-    JSONRPC_STATUS status = type->Check(parameterValue, outputParameters[type->name], errorData["stack"]);
+    CVariant parameterError;
+    JSONRPC_STATUS status = type->Check(parameterValue, outputParameters[type->name], parameterError);
     if (status != OK)
+    {
+      errorData["stack"] = std::move(parameterError);
       return status;
+    }
 
     // The parameter was present and valid
     handled++;
@@ -1870,6 +1924,19 @@ JSONRPC_STATUS CJSONServiceDescription::CheckCall(const char* const method, cons
   return MethodNotFound;
 }
 
+void CJSONServiceDescription::ResolveReferences()
+{
+  std::set<const JSONSchemaTypeDefinition*> resolved;
+  for (const auto &type : m_types)
+    type.second->ResolveReferences(resolved);
+
+  for (CJsonRpcMethodMap::JsonRpcMethodIterator method = m_actionMap.begin(); method != m_actionMap.end(); ++method)
+  {
+    for (const auto &parameter : method->second.parameters)
+      parameter->ResolveReferences(resolved);
+  }
+}
+
 JSONSchemaTypeDefinitionPtr CJSONServiceDescription::GetType(const std::string &identification)
 {
   std::map<std::string, JSONSchemaTypeDefinitionPtr>::iterator iter = m_types.find(identification);
@@ -12,6 +12,7 @@
 #include <vector>
 #include <limits>
 #include <memory>
+#include <set>
 
 #include "JSONUtils.h"
 #include "utils/Variant.h"
@@ -40,6 +41,7 @@ namespace JSONRPC
     JSONRPC_STATUS Check(const CVariant &value, CVariant &outputValue, CVariant &errorData);
     void Print(bool isParameter, bool isGlobal, bool printDefault, bool printDescriptions, CVariant &output) const;
     void Set(const JSONSchemaTypeDefinitionPtr typeDefinition);
+    void ResolveReferences(std::set<const JSONSchemaTypeDefinition*> &resolved);
 
     std::string missingReference;
 
@@ -211,6 +213,9 @@ namespace JSONRPC
      \brief Type definition for additional properties
      */
     JSONSchemaTypeDefinitionPtr additionalProperties;
+
+  private:
+    JSONRPC_STATUS checkValue(const CVariant &value, CVariant &outputValue, CVariant &errorData) const;
   };
 
   /*!
@@ -382,6 +387,13 @@ namespace JSONRPC
 
     static JSONSchemaTypeDefinitionPtr GetType(const std::string &identification);
 
+    /*!
+     \brief Resolves the referenced types of all types and
+     method parameters once all of them have been added, so
+     checking a call doesn't have to do it
+     */
+    static void ResolveReferences();
+
     static void Cleanup();
 
   private:
@@ -9,6 +9,7 @@
 #include "SystemOperations.h"
 #include "messaging/ApplicationMessenger.h"
 #include "interfaces/builtins/Builtins.h"
+#include "utils/TraceProfiler.h"
 #include "utils/Variant.h"
 #include "powermanagement/PowerManager.h"
 #include "ServiceBroker.h"
@@ -84,6 +85,29 @@ JSONRPC_STATUS CSystemOperations::Reboot(const std::string &method, ITransportLa
     return FailedToExecute;
 }
 
+JSONRPC_STATUS CSystemOperations::StartTrace(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  if (!CTraceProfiler::IsAvailable())
+    return FailedToExecute;
+
+  CTraceProfiler::GetInstance().Start();
+  return ACK;
+}
+
+JSONRPC_STATUS CSystemOperations::StopTrace(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  if (!CTraceProfiler::GetInstance().Stop())
+    return FailedToExecute;
+
+  // callers can't choose the file, it's always a new one in special://temp/
+  const std::string file = CTraceProfiler::GetInstance().Export();
+  if (file.empty())
+    return FailedToExecute;
+
+  result = file;
+  return OK;
+}
+
 JSONRPC_STATUS CSystemOperations::GetPropertyValue(int permissions, const std::string &property, CVariant &result)
 {
   if (property == "canshutdown")
@@ -28,6 +28,7 @@
 #include "interfaces/python/swig.h"
 #include "interfaces/python/XBPython.h"
 #include "threads/SingleLock.h"
+#include "utils/auto_buffer.h"
 #if defined(TARGET_WINDOWS)
 #include "utils/CharsetConverter.h"
 #endif // defined(TARGET_WINDOWS)
@@ -161,6 +162,7 @@ bool CPythonInvoker::execute(const std::string &script, const std::vector<std::s
 
   // get the global lock
   PyEval_AcquireLock();
+  bool reused = m_threadState != NULL;
   if (!m_threadState)
   {
     m_threadState = Py_NewInterpreter();
@@ -289,12 +291,12 @@ bool CPythonInvoker::execute(const std::string &script, const std::vector<std::s
         return false;
       }
 #endif
-      //! @bug libpython isn't const correct
-      PyObject* file = PyFile_FromString(const_cast<char*>(nativeFilename.c_str()), const_cast<char*>("r"));
-      FILE *fp = PyFile_AsFile(file);
-
-      if (fp != NULL)
+      // a reused interpreter runs the script again, so only compile it once
+      PyObject* code = reused ? static_cast<PyObject*>(getCompiledScript(nativeFilename)) : NULL;
+      if (code != NULL)
       {
+        // stop() may release the cached code object while the script runs
+        Py_INCREF(code);
         PyObject *f = PyString_FromString(nativeFilename.c_str());
         PyDict_SetItemString(moduleDict, "__file__", f);
 
@@ -303,10 +305,31 @@ bool CPythonInvoker::execute(const std::string &script, const std::vector<std::s
         Py_DECREF(f);
         setState(InvokerStateRunning);
         XBMCAddon::Python::PyContext pycontext; // this is a guard class that marks this callstack as being in a python context
-        executeScript(fp, nativeFilename, module, moduleDict);
+        PyObject* result = PyEval_EvalCode(reinterpret_cast<PyCodeObject*>(code), moduleDict, moduleDict);
+        Py_XDECREF(result);
+        Py_DECREF(code);
       }
       else
-        CLog::Log(LOGERROR, "CPythonInvoker(%d, %s): %s not found!", GetId(), m_sourceFile.c_str(), m_sourceFile.c_str());
+      {
+        //! @bug libpython isn't const correct
+        PyObject* file = PyFile_FromString(const_cast<char*>(nativeFilename.c_str()), const_cast<char*>("r"));
+        FILE *fp = PyFile_AsFile(file);
+
+        if (fp != NULL)
+        {
+          PyObject *f = PyString_FromString(nativeFilename.c_str());
+          PyDict_SetItemString(moduleDict, "__file__", f);
+
+          onPythonModuleInitialization(moduleDict);
+
+          Py_DECREF(f);
+          setState(InvokerStateRunning);
+          XBMCAddon::Python::PyContext pycontext; // this is a guard class that marks this callstack as being in a python context
+          executeScript(fp, nativeFilename, module, moduleDict);
+        }
+        else
+          CLog::Log(LOGERROR, "CPythonInvoker(%d, %s): %s not found!", GetId(), m_sourceFile.c_str(), m_sourceFile.c_str());
+      }
     }
     catch (const XbmcCommons::Exception& e)
     {
@@ -405,6 +428,49 @@ bool CPythonInvoker::execute(const std::string &script, const std::vector<std::s
   return true;
 }
 
+void* CPythonInvoker::getCompiledScript(const std::string& nativeFilename)
+{
+  struct __stat64 st;
+  if (XFILE::CFile::Stat(m_sourceFile, &st) != 0)
+    return NULL;
+
+  // the size catches edits within the mtime resolution
+  if (m_compiledScript != NULL && m_compiledScriptTime == static_cast<int64_t>(st.st_mtime) &&
+      m_compiledScriptSize == static_cast<int64_t>(st.st_size))
+    return m_compiledScript;
+
+  releaseCompiledScript();
+
+  // read the source ourselves instead of handing a FILE* to python
+  XFILE::CFile file;
+  XUTILS::auto_buffer buffer;
+  if (file.LoadFile(m_sourceFile, buffer) <= 0)
+    return NULL;
+
+  std::string source(buffer.get(), buffer.size());
+  PyObject* code = Py_CompileString(source.c_str(), nativeFilename.c_str(), Py_file_input);
+  if (code == NULL)
+  {
+    // let the regular execution path report the error
+    PyErr_Clear();
+    return NULL;
+  }
+
+  CLog::Log(LOGDEBUG, "CPythonInvoker(%d, %s): caching compiled script", GetId(), m_sourceFile.c_str());
+  m_compiledScript = code;
+  m_compiledScriptTime = static_cast<int64_t>(st.st_mtime);
+  m_compiledScriptSize = static_cast<int64_t>(st.st_size);
+  return m_compiledScript;
+}
+
+// must be called with the interpreter's thread state swapped in
+void CPythonInvoker::releaseCompiledScript()
+{
+  PyObject* code = static_cast<PyObject*>(m_compiledScript);
+  Py_XDECREF(code);
+  m_compiledScript = NULL;
+}
+
 void CPythonInvoker::executeScript(void *fp, const std::string &script, void *module, void *moduleDict)
 {
   if (fp == NULL || script.empty() || module == NULL || moduleDict == NULL)
@@ -493,6 +559,7 @@ bool CPythonInvoker::stop(bool abort)
         state->async_exc = PyExc_SystemExit;
         Py_XINCREF(state->async_exc);
       }
+      releaseCompiledScript();
       PyThreadState_Swap(old);
 
       // If a dialog entered its doModal(), we need to wake it to see the exception
@@ -521,6 +588,8 @@ void CPythonInvoker::onExecutionDone()
 
     onDeinitialization();
 
+    releaseCompiledScript();
+
     // run the gc before finishing
     //
     // if the script exited by throwing a SystemExit exception then going back
@@ -568,6 +637,8 @@ void CPythonInvoker::onExecutionFailed()
 
   CSingleLock lock(m_critical);
   m_threadState = NULL;
+  // the interpreter is gone, the code object can't be released safely anymore
+  m_compiledScript = NULL;
 
   ILanguageInvoker::onExecutionFailed();
 }
@@ -61,6 +61,9 @@ private:
   void addPath(const std::string& path); // add path in UTF-8 encoding
   void addNativePath(const std::string& path); // add path in system/Python encoding
   void getAddonModuleDeps(const ADDON::AddonPtr& addon, std::set<std::string>& paths);
+  // returns a borrowed PyObject* code object or NULL
+  void* getCompiledScript(const std::string& nativeFilename);
+  void releaseCompiledScript();
 
   std::string m_pythonPath;
   _ts *m_threadState;
@@ -70,5 +73,10 @@ private:
   XBMCAddon::AddonClass::Ref<XBMCAddon::Python::PythonLanguageHook> m_languageHook;
   bool m_systemExitThrown = false;
 
+  // compiled code of the script, kept while the interpreter is reused
+  void* m_compiledScript = nullptr; // actually a PyObject*
+  int64_t m_compiledScriptTime = 0;
+  int64_t m_compiledScriptSize = 0;
+
   static CCriticalSection s_critical;
 };
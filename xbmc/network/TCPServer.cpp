@@ -19,6 +19,7 @@
 #include "utils/log.h"
 #include "utils/Variant.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "websocket/WebSocketManager.h"
 #include "Network.h"
 
@@ -49,6 +50,8 @@ using namespace JSONRPC;
 using namespace ANNOUNCEMENT;
 
 #define RECEIVEBUFFER 1024
+#define MAX_NOTIFICATION_BATCH_WINDOW 10000
+#define DEFAULT_NOTIFICATION_BATCH_SIZE 100
 
 CTCPServer *CTCPServer::ServerInstance = NULL;
 
@@ -105,6 +108,16 @@ CTCPServer::CTCPServer(int port, bool nonlocal) : CThread("TCPServer")
   m_port = port;
   m_nonlocal = nonlocal;
   m_sdpd = NULL;
+  m_wakeupRead = INVALID_SOCKET;
+  m_wakeupWrite = INVALID_SOCKET;
+}
+
+CTCPServer::~CTCPServer()
+{
+  if (m_wakeupRead != INVALID_SOCKET)
+    closesocket(m_wakeupRead);
+  if (m_wakeupWrite != INVALID_SOCKET)
+    closesocket(m_wakeupWrite);
 }
 
 void CTCPServer::Process()
@@ -125,11 +138,31 @@ void CTCPServer::Process()
         max_fd = *it;
     }
 
+    if (m_wakeupRead != INVALID_SOCKET)
+    {
+      FD_SET(m_wakeupRead, &rfds);
+      if ((intptr_t)m_wakeupRead > (intptr_t)max_fd)
+        max_fd = m_wakeupRead;
+    }
+
+    int batchWait = -1;
     for (unsigned int i = 0; i < m_connections.size(); i++)
     {
       FD_SET(m_connections[i]->m_socket, &rfds);
       if ((intptr_t)m_connections[i]->m_socket > (intptr_t)max_fd)
         max_fd = m_connections[i]->m_socket;
+
+      int wait = m_connections[i]->FlushNotifications();
+      if (wait >= 0 && (batchWait < 0 || wait < batchWait))
+        batchWait = wait;
+    }
+
+    // Wake up in time for the next batch of notifications, a batch started
+    // during select() interrupts it through m_wakeupRead
+    if (batchWait >= 0 && batchWait < 1000)
+    {
+      to.tv_sec = 0;
+      to.tv_usec = batchWait * 1000;
     }
 
     int res = select((intptr_t)max_fd+1, &rfds, NULL, NULL, &to);
@@ -141,6 +174,12 @@ void CTCPServer::Process()
     }
     else if (res > 0)
     {
+      if (m_wakeupRead != INVALID_SOCKET && FD_ISSET(m_wakeupRead, &rfds))
+      {
+        char wakeup[16];
+        recv(m_wakeupRead, wakeup, sizeof(wakeup), 0);
+      }
+
       for (int i = m_connections.size() - 1; i >= 0; i--)
       {
         int socket = m_connections[i]->m_socket;
@@ -236,8 +275,19 @@ int CTCPServer::GetCapabilities()
 
 void CTCPServer::Announce(AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data)
 {
-  std::string str = IJSONRPCAnnouncer::AnnouncementToJSONRPC(flag, sender, message, data, g_advancedSettings.m_jsonOutputCompact);
+  if (m_connections.empty())
+    return;
+
+  // Serialise and frame the notification once for all clients
+  std::shared_ptr<CNotification> notification = std::make_shared<CNotification>();
+  notification->json = IJSONRPCAnnouncer::AnnouncementToJSONRPC(flag, sender, message, data, g_advancedSettings.m_jsonOutputCompact);
+  notification->hash = std::hash<std::string>()(notification->json);
 
+  CWebSocketFrame frame(WebSocketTextFrame, notification->json.c_str(), notification->json.size());
+  if (frame.IsValid())
+    notification->frame.assign(frame.GetFrameData(), static_cast<size_t>(frame.GetFrameLength()));
+
+  bool newBatch = false;
   for (unsigned int i = 0; i < m_connections.size(); i++)
   {
     {
@@ -246,8 +296,20 @@ void CTCPServer::Announce(AnnouncementFlag flag, const char *sender, const char
         continue;
     }
 
-    m_connections[i]->Send(str.c_str(), str.size());
+    newBatch |= m_connections[i]->Notify(notification);
   }
+
+  if (newBatch)
+    WakeUp();
+}
+
+void CTCPServer::WakeUp()
+{
+  if (m_wakeupWrite == INVALID_SOCKET)
+    return;
+
+  char wakeup = 0;
+  send(m_wakeupWrite, &wakeup, sizeof(wakeup), 0);
 }
 
 bool CTCPServer::Initialize()
@@ -256,6 +318,9 @@ bool CTCPServer::Initialize()
 
   bool started = false;
 
+  if (m_wakeupRead == INVALID_SOCKET && !InitializeWakeUp())
+    CLog::Log(LOGWARNING, "JSONRPC Server: Unable to create the wakeup sockets, batched notifications may be late");
+
   started |= InitializeBlue();
   started |= InitializeTCP();
 
@@ -460,6 +525,35 @@ bool CTCPServer::InitializeBlue()
 }
 #endif
 
+bool CTCPServer::InitializeWakeUp()
+{
+  // A connected pair of loopback UDP sockets, unlike a pipe it works with select() everywhere
+  SOCKET readFd = socket(AF_INET, SOCK_DGRAM, 0);
+  SOCKET writeFd = socket(AF_INET, SOCK_DGRAM, 0);
+
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = 0;
+  socklen_t len = sizeof(addr);
+
+  if (readFd == INVALID_SOCKET || writeFd == INVALID_SOCKET ||
+      bind(readFd, (struct sockaddr*)&addr, sizeof(addr)) < 0 ||
+      getsockname(readFd, (struct sockaddr*)&addr, &len) < 0 ||
+      connect(writeFd, (struct sockaddr*)&addr, sizeof(addr)) < 0)
+  {
+    if (readFd != INVALID_SOCKET)
+      closesocket(readFd);
+    if (writeFd != INVALID_SOCKET)
+      closesocket(writeFd);
+    return false;
+  }
+
+  m_wakeupRead = readFd;
+  m_wakeupWrite = writeFd;
+  return true;
+}
+
 bool CTCPServer::InitializeTCP()
 {
   Deinitialize();
@@ -505,6 +599,11 @@ CTCPServer::CTCPClient::CTCPClient()
   m_endBrackets = 0;
   m_beginChar = 0;
   m_endChar = 0;
+  m_batchWindow = 0;
+  m_batchQueueSize = DEFAULT_NOTIFICATION_BATCH_SIZE;
+  m_droppedNotifications = 0;
+  m_batchDropped = 0;
+  m_batchDeadline = 0;
 
   m_addrlen = sizeof(m_cliaddr);
 }
@@ -536,6 +635,142 @@ bool CTCPServer::CTCPClient::SetAnnouncementFlags(int flags)
   return true;
 }
 
+bool CTCPServer::CTCPClient::GetNotificationBatching(int &window, int &queueSize, uint64_t &dropped)
+{
+  CSingleLock lock (m_critSection);
+  window = m_batchWindow;
+  queueSize = m_batchQueueSize;
+  dropped = m_droppedNotifications;
+  return true;
+}
+
+bool CTCPServer::CTCPClient::SetNotificationBatching(int window, int queueSize)
+{
+  if (window < 0 || window > MAX_NOTIFICATION_BATCH_WINDOW || queueSize < 1)
+    return false;
+
+  {
+    CSingleLock lock (m_critSection);
+    m_batchWindow = window;
+    m_batchQueueSize = queueSize;
+    while (m_notifications.size() > static_cast<size_t>(m_batchQueueSize))
+    {
+      EraseNotification(m_notifications.begin());
+      m_droppedNotifications++;
+      m_batchDropped++;
+    }
+  }
+
+  // Notifications queued before batching was turned off are due right away
+  FlushNotifications();
+  return true;
+}
+
+void CTCPServer::CTCPClient::EraseNotification(std::deque<NotificationPtr>::iterator it)
+{
+  // must be called with m_critSection held
+  m_notificationHashes.erase(m_notificationHashes.find((*it)->hash));
+  m_notifications.erase(it);
+}
+
+bool CTCPServer::CTCPClient::Notify(const NotificationPtr &notification)
+{
+  bool queued = false;
+  bool newBatch = false;
+  {
+    CSingleLock lock (m_critSection);
+    if (m_batchWindow > 0)
+    {
+      queued = true;
+      newBatch = m_notifications.empty();
+      if (newBatch)
+        m_batchDeadline = XbmcThreads::SystemClockMillis() + m_batchWindow;
+
+      // A repeated notification replaces the queued one, so it's sent once and
+      // in the order of its latest occurrence. Most notifications aren't
+      // queued yet, they are told apart by their hash without a search.
+      if (m_notificationHashes.count(notification->hash) > 0)
+      {
+        for (auto it = m_notifications.begin(); it != m_notifications.end(); ++it)
+        {
+          if ((*it)->hash == notification->hash && (*it)->json == notification->json)
+          {
+            EraseNotification(it);
+            break;
+          }
+        }
+      }
+
+      if (m_notifications.size() >= static_cast<size_t>(m_batchQueueSize))
+      {
+        EraseNotification(m_notifications.begin());
+        m_droppedNotifications++;
+        m_batchDropped++;
+      }
+      m_notifications.push_back(notification);
+      m_notificationHashes.insert(notification->hash);
+    }
+  }
+
+  // Without batching the notification is sent right away, otherwise the batch
+  // is sent here if it's due and the server thread hasn't got to it yet
+  if (!queued)
+    SendNotification(*notification);
+  else if (!newBatch)
+    FlushNotifications();
+
+  return newBatch;
+}
+
+int CTCPServer::CTCPClient::FlushNotifications()
+{
+  std::deque<NotificationPtr> notifications;
+  unsigned int dropped;
+  {
+    CSingleLock lock (m_critSection);
+    // The next notification queued starts a batch and wakes up the server thread
+    if (m_notifications.empty())
+      return -1;
+
+    int remaining = static_cast<int>(m_batchDeadline - XbmcThreads::SystemClockMillis());
+    if (m_batchWindow > 0 && remaining > 0)
+      return remaining;
+
+    notifications.swap(m_notifications);
+    m_notificationHashes.clear();
+    dropped = m_batchDropped;
+    m_batchDropped = 0;
+  }
+
+  if (dropped > 0)
+    CLog::Log(LOGDEBUG, "JSONRPC Server: Dropped %u notifications exceeding the batch size of a client", dropped);
+
+  if (notifications.size() == 1)
+    SendNotification(*notifications.front());
+  else
+  {
+    // The batch is sent as a JSON-RPC batch of notifications
+    size_t size = 1;
+    for (const auto& notification : notifications)
+      size += notification->json.size() + 1;
+
+    std::string batch;
+    batch.reserve(size);
+    batch.push_back('[');
+    for (const auto& notification : notifications)
+    {
+      if (batch.size() > 1)
+        batch.push_back(',');
+      batch.append(notification->json);
+    }
+    batch.push_back(']');
+
+    Send(batch.c_str(), batch.size());
+  }
+
+  return -1;
+}
+
 void CTCPServer::CTCPClient::Send(const char *data, unsigned int size)
 {
   unsigned int sent = 0;
@@ -594,6 +829,11 @@ void CTCPServer::CTCPClient::Disconnect()
   }
 }
 
+void CTCPServer::CTCPClient::SendNotification(const CNotification &notification)
+{
+  Send(notification.json.c_str(), notification.json.size());
+}
+
 void CTCPServer::CTCPClient::Copy(const CTCPClient& client)
 {
   m_new               = client.m_new;
@@ -606,6 +846,13 @@ void CTCPServer::CTCPClient::Copy(const CTCPClient& client)
   m_beginChar         = client.m_beginChar;
   m_endChar           = client.m_endChar;
   m_buffer            = client.m_buffer;
+  m_batchWindow       = client.m_batchWindow;
+  m_batchQueueSize    = client.m_batchQueueSize;
+  m_droppedNotifications = client.m_droppedNotifications;
+  m_batchDropped      = client.m_batchDropped;
+  m_notifications     = client.m_notifications;
+  m_notificationHashes = client.m_notificationHashes;
+  m_batchDeadline     = client.m_batchDeadline;
 }
 
 CTCPServer::CWebSocketClient::CWebSocketClient(CWebSocket *websocket)
@@ -648,6 +895,16 @@ void CTCPServer::CWebSocketClient::Send(const char *data, unsigned int size)
   std::vector<const CWebSocketFrame *> frames = msg->GetFrames();
   for (unsigned int index = 0; index < frames.size(); index++)
     CTCPClient::Send(frames.at(index)->GetFrameData(), (unsigned int)frames.at(index)->GetFrameLength());
+
+  delete msg;
+}
+
+void CTCPServer::CWebSocketClient::SendNotification(const CNotification &notification)
+{
+  if (notification.frame.empty())
+    Send(notification.json.c_str(), notification.json.size());
+  else
+    CTCPClient::Send(notification.frame.c_str(), notification.frame.size());
 }
 
 void CTCPServer::CWebSocketClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
@@ -8,6 +8,9 @@
 
 #pragma once
 
+#include <deque>
+#include <memory>
+#include <unordered_set>
 #include <vector>
 #include <sys/socket.h>
 
@@ -39,11 +42,33 @@ namespace JSONRPC
     void Process() override;
   private:
     CTCPServer(int port, bool nonlocal);
+    ~CTCPServer() override;
     bool Initialize();
     bool InitializeBlue();
     bool InitializeTCP();
     void Deinitialize();
 
+    /*!
+     \brief Create the loopback socket pair used to interrupt select()
+     */
+    bool InitializeWakeUp();
+
+    /*!
+     \brief Interrupt select() in Process, so it picks up a new batch deadline
+     */
+    void WakeUp();
+
+    /*!
+     \brief A notification, serialised once and shared by all clients
+     */
+    struct CNotification
+    {
+      std::string json;
+      std::string frame; // json as an unmasked WebSocket text frame
+      size_t hash; // of json, to find a repeated notification quickly
+    };
+    typedef std::shared_ptr<const CNotification> NotificationPtr;
+
     class CTCPClient : public IClient
     {
     public:
@@ -57,8 +82,24 @@ namespace JSONRPC
       int GetPermissionFlags() override;
       int GetAnnouncementFlags() override;
       bool SetAnnouncementFlags(int flags) override;
+      bool GetNotificationBatching(int &window, int &queueSize, uint64_t &dropped) override;
+      bool SetNotificationBatching(int window, int queueSize) override;
+
+      /*!
+       \brief Send a notification, or queue it if the client batches them
+       \return true if the notification started a new batch, the server thread
+       has to be woken up to wait for its deadline
+       */
+      bool Notify(const NotificationPtr &notification);
+
+      /*!
+       \brief Send the queued notifications once the batching window is over
+       \return ms until the queued notifications are due, -1 if none are queued
+       */
+      int FlushNotifications();
 
       virtual void Send(const char *data, unsigned int size);
+      virtual void SendNotification(const CNotification &notification);
       virtual void PushBuffer(CTCPServer *host, const char *buffer, int length);
       virtual void Disconnect();
 
@@ -73,11 +114,20 @@ namespace JSONRPC
     protected:
       void Copy(const CTCPClient& client);
     private:
+      void EraseNotification(std::deque<NotificationPtr>::iterator it);
+
       bool m_new;
       int m_announcementflags;
       int m_beginBrackets, m_endBrackets;
       char m_beginChar, m_endChar;
       std::string m_buffer;
+      int m_batchWindow;
+      int m_batchQueueSize;
+      uint64_t m_droppedNotifications;
+      unsigned int m_batchDropped;
+      std::deque<NotificationPtr> m_notifications;
+      std::unordered_multiset<size_t> m_notificationHashes; // of m_notifications
+      unsigned int m_batchDeadline;
     };
 
     class CWebSocketClient : public CTCPClient
@@ -90,6 +140,7 @@ namespace JSONRPC
       ~CWebSocketClient() override;
 
       void Send(const char *data, unsigned int size) override;
+      void SendNotification(const CNotification &notification) override;
       void PushBuffer(CTCPServer *host, const char *buffer, int length) override;
       void Disconnect() override;
 
@@ -102,6 +153,8 @@ namespace JSONRPC
 
     std::vector<CTCPClient*> m_connections;
     std::vector<SOCKET> m_servers;
+    SOCKET m_wakeupRead; // readable when a client starts a batch
+    SOCKET m_wakeupWrite;
     int m_port;
     bool m_nonlocal;
     void* m_sdpd;
@@ -18,6 +18,7 @@
 #include "dialogs/GUIDialogMediaSource.h"
 #include "dialogs/GUIDialogProgress.h"
 #include "playlists/PlayListFactory.h"
+#include "PictureDatabase.h"
 #include "PictureInfoLoader.h"
 #include "guilib/GUIComponent.h"
 #include "guilib/GUIWindowManager.h"
@@ -41,6 +42,10 @@
 #include "platform/linux/XTimeUtils.h"
 #endif
 
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
 #define CONTROL_BTNVIEWASICONS      2
 #define CONTROL_BTNSORTBY           3
 #define CONTROL_BTNSORTASC          4
@@ -276,6 +281,111 @@ bool CGUIWindowPictures::OnClick(int iItem, const std::string &player)
   return false;
 }
 
+void CGUIWindowPictures::FormatAndSort(CFileItemList &items)
+{
+  std::unique_ptr<CGUIViewState> viewState(CGUIViewState::GetViewState(GetID(), items));
+
+  if (viewState.get() && SortFromIndex(items, viewState->GetSortMethod().sortBy, viewState->GetSortOrder()))
+  {
+    LABEL_MASKS labelMasks;
+    viewState->GetSortMethodLabelMasks(labelMasks);
+    FormatItemLabels(items, labelMasks);
+    return;
+  }
+
+  CGUIMediaWindow::FormatAndSort(items);
+}
+
+bool CGUIWindowPictures::SortFromIndex(CFileItemList& items, SortBy sortBy, SortOrder sortOrder)
+{
+  CPictureDatabase::Order order;
+  switch (sortBy)
+  {
+  case SortByDateTaken:
+    order = CPictureDatabase::Order::DATE_TAKEN;
+    break;
+  case SortByCamera:
+    order = CPictureDatabase::Order::CAMERA;
+    break;
+  case SortByLocation:
+    order = CPictureDatabase::Order::LOCATION;
+    break;
+  default:
+    return false;
+  }
+
+  if (items.IsVirtualDirectoryRoot() || items.GetFolderCount() == items.Size())
+    return false;
+
+  CPictureDatabase database;
+  std::vector<std::string> files;
+  if (!database.Open() || !database.GetPictures(items.GetPath(), order, files) || files.empty())
+    return false;
+  database.Close();
+
+  std::unordered_map<std::string, int> ranks;
+  for (size_t i = 0; i < files.size(); ++i)
+    ranks[files[i]] = sortOrder == SortOrderDescending ? -static_cast<int>(i) : static_cast<int>(i);
+
+  // the parent folder and the folders keep their place in front, files that
+  // aren't indexed yet follow the indexed ones
+  struct Position
+  {
+    int group;
+    int rank;
+    int index;
+  };
+  std::vector<Position> positions;
+  positions.reserve(items.Size());
+  for (int i = 0; i < items.Size(); ++i)
+  {
+    const CFileItemPtr item = items[i];
+    Position position = { 3, 0, i };
+    if (item->IsParentFolder())
+      position.group = 0;
+    else if (item->m_bIsFolder)
+      position.group = 1;
+    else
+    {
+      auto rank = ranks.find(item->GetPath());
+      if (rank != ranks.end())
+      {
+        position.group = 2;
+        position.rank = rank->second;
+      }
+    }
+    positions.push_back(position);
+  }
+
+  std::sort(positions.begin(), positions.end(), [](const Position& a, const Position& b)
+  {
+    if (a.group != b.group)
+      return a.group < b.group;
+    if (a.rank != b.rank)
+      return a.rank < b.rank;
+    return a.index < b.index;
+  });
+
+  // apply the order in place, current[i] is the original index of the item at i
+  std::vector<int> current(items.Size());
+  std::vector<int> location(items.Size());
+  for (int i = 0; i < items.Size(); ++i)
+    current[i] = location[i] = i;
+  for (int i = 0; i < items.Size(); ++i)
+  {
+    const int from = location[positions[i].index];
+    if (from == i)
+      continue;
+    items.Swap(i, from);
+    location[current[i]] = from;
+    location[current[from]] = i;
+    std::swap(current[i], current[from]);
+  }
+
+  items.ClearSortState();
+  return true;
+}
+
 bool CGUIWindowPictures::GetDirectory(const std::string &strDirectory, CFileItemList& items)
 {
   if (!CGUIMediaWindow::GetDirectory(strDirectory, items))
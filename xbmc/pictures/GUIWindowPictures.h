@@ -27,6 +27,7 @@ protected:
   bool OnClick(int iItem, const std::string &player = "") override;
   void UpdateButtons() override;
   void OnPrepareFileItems(CFileItemList& items) override;
+  void FormatAndSort(CFileItemList &items) override;
   bool Update(const std::string &strDirectory, bool updateFilterPath = true) override;
   void GetContextButtons(int itemNumber, CContextButtons &buttons) override;
   bool OnContextButton(int itemNumber, CONTEXT_BUTTON button) override;
@@ -44,6 +45,12 @@ protected:
   void OnItemLoaded(CFileItem* pItem) override;
   void LoadPlayList(const std::string& strPlayList) override;
 
+  /*!
+   \brief Order the files of a folder by date taken, camera or location straight from the picture index
+   \return false if the sort method isn't served by the index or the folder isn't indexed
+   */
+  static bool SortFromIndex(CFileItemList& items, SortBy sortBy, SortOrder sortOrder);
+
   CGUIDialogProgress* m_dlgProgress;
 
   CPictureThumbLoader m_thumbLoader;
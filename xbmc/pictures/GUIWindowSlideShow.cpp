@@ -30,6 +30,7 @@
 #include "guilib/LocalizeStrings.h"
 #include "TextureDatabase.h"
 #include "threads/SingleLock.h"
+#include "utils/JobManager.h"
 #include "utils/log.h"
 #include "utils/Random.h"
 #include "utils/Variant.h"
@@ -40,6 +41,7 @@
 #ifdef TARGET_POSIX
 #include "platform/linux/XTimeUtils.h"
 #endif
+#include <algorithm>
 #include <random>
 
 using namespace XFILE;
@@ -58,6 +60,12 @@ using namespace KODI::MESSAGING;
 
 #define ROTATION_SNAP_RANGE              10.0f
 
+// decode-ahead limits
+#define PREFETCH_AHEAD                       3
+#define PREFETCH_BEHIND                      1
+#define MAX_PREFETCH_DECODERS                2
+#define MAX_PREFETCH_MEMORY      (128*1024*1024)
+
 #define LABEL_ROW1                          10
 #define CONTROL_PAUSE                       13
 
@@ -77,6 +85,7 @@ CBackgroundPicLoader::CBackgroundPicLoader()
 CBackgroundPicLoader::~CBackgroundPicLoader()
 {
   StopThread();
+  StopDecoders();
 }
 
 void CBackgroundPicLoader::Create(CGUIWindowSlideShow *pCallback)
@@ -90,6 +99,7 @@ void CBackgroundPicLoader::Process()
 {
   unsigned int totalTime = 0;
   unsigned int count = 0;
+  unsigned int decodedAhead = 0;
   while (!m_bStop)
   { // loop around forever, waiting for the app to call LoadPic
     if (AbortableWait(m_loadPic,10) == WAIT_SIGNALED)
@@ -97,7 +107,12 @@ void CBackgroundPicLoader::Process()
       if (m_pCallback)
       {
         unsigned int start = XbmcThreads::SystemClockMillis();
-        CBaseTexture* texture = CTexture::LoadFromFile(m_strFileName, m_maxWidth, m_maxHeight);
+        bool found;
+        CBaseTexture* texture = TakeDecoded(m_strFileName, m_maxWidth, m_maxHeight, found);
+        if (found)
+          decodedAhead++;
+        else
+          texture = CTexture::LoadFromFile(m_strFileName, m_maxWidth, m_maxHeight);
         totalTime += XbmcThreads::SystemClockMillis() - start;
         count++;
         // tell our parent
@@ -122,8 +137,8 @@ void CBackgroundPicLoader::Process()
     }
   }
   if (count > 0)
-    CLog::Log(LOGDEBUG, "Time for loading %u images: %u ms, average %u ms",
-              count, totalTime, totalTime / count);
+    CLog::Log(LOGDEBUG, "Time for loading %u images: %u ms, average %u ms, %u decoded ahead",
+              count, totalTime, totalTime / count, decodedAhead);
 }
 
 void CBackgroundPicLoader::LoadPic(int iPic, int iSlideNumber, const std::string &strFileName, const int maxWidth, const int maxHeight)
@@ -137,6 +152,142 @@ void CBackgroundPicLoader::LoadPic(int iPic, int iSlideNumber, const std::string
   m_loadPic.Set();
 }
 
+void CBackgroundPicLoader::Prefetch(const std::vector<std::string> &files, int maxWidth, int maxHeight)
+{
+  CSingleLock lock(m_decodeSection);
+  m_prefetch = files;
+  m_prefetchWidth = maxWidth;
+  m_prefetchHeight = maxHeight;
+
+  // drop what isn't needed anymore, pictures being decoded are dropped the
+  // next time round
+  for (auto it = m_decoded.begin(); it != m_decoded.end();)
+  {
+    if (!it->decoding &&
+        (it->maxWidth != maxWidth || it->maxHeight != maxHeight ||
+         std::find(files.begin(), files.end(), it->fileName) == files.end()))
+    {
+      delete it->texture;
+      it = m_decoded.erase(it);
+    }
+    else
+      ++it;
+  }
+
+  StartDecoders();
+}
+
+CBaseTexture* CBackgroundPicLoader::TakeDecoded(const std::string &strFileName, int maxWidth, int maxHeight, bool &found)
+{
+  CSingleLock lock(m_decodeSection);
+
+  // don't decode it again once it has been handed out
+  m_prefetch.erase(std::remove(m_prefetch.begin(), m_prefetch.end(), strFileName), m_prefetch.end());
+
+  auto it = FindDecoded(strFileName, maxWidth, maxHeight);
+  while (it != m_decoded.end() && it->decoding)
+  {
+    // decode it here if its job didn't start, wait for the decoder otherwise
+    // rather than decoding it twice
+    if (!it->claim->exchange(true))
+    {
+      DecodedPic* pic = &*it;
+      CSingleExit exit(m_decodeSection);
+      Decode(pic);
+    }
+    else
+      m_decodeDone.wait(lock);
+    it = FindDecoded(strFileName, maxWidth, maxHeight);
+  }
+
+  found = it != m_decoded.end();
+  if (!found)
+    return nullptr;
+
+  CBaseTexture* texture = it->texture;
+  m_decoded.erase(it);
+
+  StartDecoders();
+  return texture;
+}
+
+std::list<CBackgroundPicLoader::DecodedPic>::iterator CBackgroundPicLoader::FindDecoded(const std::string &strFileName, int maxWidth, int maxHeight)
+{
+  return std::find_if(m_decoded.begin(), m_decoded.end(), [&](const DecodedPic& pic)
+  {
+    return pic.fileName == strFileName && pic.maxWidth == maxWidth && pic.maxHeight == maxHeight;
+  });
+}
+
+void CBackgroundPicLoader::StartDecoders()
+{
+  if (m_stopDecoders)
+    return;
+
+  for (const auto& file : m_prefetch)
+  {
+    if (m_activeDecoders >= MAX_PREFETCH_DECODERS)
+      break;
+
+    size_t memory = 0;
+    for (const auto& pic : m_decoded)
+    {
+      if (pic.texture)
+        memory += pic.texture->GetPitch() * pic.texture->GetRows();
+    }
+    if (memory >= MAX_PREFETCH_MEMORY)
+      break;
+
+    if (FindDecoded(file, m_prefetchWidth, m_prefetchHeight) != m_decoded.end())
+      continue;
+
+    std::shared_ptr<std::atomic<bool>> claim = std::make_shared<std::atomic<bool>>(false);
+    m_decoded.push_back({ file, m_prefetchWidth, m_prefetchHeight, nullptr, true, claim });
+    DecodedPic* pic = &m_decoded.back();
+    m_activeDecoders++;
+    CJobManager::GetInstance().Submit([this, pic, claim]() {
+      if (!claim->exchange(true))
+        Decode(pic);
+    }, CJob::PRIORITY_NORMAL);
+  }
+}
+
+void CBackgroundPicLoader::Decode(DecodedPic* pic)
+{
+  // the entry isn't removed while it's being decoded
+  CBaseTexture* texture = CTexture::LoadFromFile(pic->fileName, pic->maxWidth, pic->maxHeight);
+
+  CSingleLock lock(m_decodeSection);
+  pic->texture = texture;
+  pic->decoding = false;
+  m_activeDecoders--;
+  StartDecoders();
+  m_decodeDone.notifyAll();
+}
+
+void CBackgroundPicLoader::StopDecoders()
+{
+  CSingleLock lock(m_decodeSection);
+  m_stopDecoders = true;
+
+  // only wait for the decoders that started
+  for (auto& pic : m_decoded)
+  {
+    if (pic.decoding && !pic.claim->exchange(true))
+    {
+      pic.decoding = false;
+      m_activeDecoders--;
+    }
+  }
+
+  while (m_activeDecoders > 0)
+    m_decodeDone.wait(lock);
+
+  for (auto& pic : m_decoded)
+    delete pic.texture;
+  m_decoded.clear();
+}
+
 CGUIWindowSlideShow::CGUIWindowSlideShow(void)
     : CGUIDialog(WINDOW_SLIDESHOW, "SlideShow.xml")
 {
@@ -217,12 +368,15 @@ void CGUIWindowSlideShow::Reset()
   m_fInitialRotate = 0.0f;
   m_iZoomFactor = 1;
   m_fZoom = 1.0f;
+  m_fLoadedZoom = 1.0f;
   m_fInitialZoom = 0.0f;
   m_iCurrentSlide = 0;
   m_iNextSlide = 1;
   m_iCurrentPic = 0;
   m_iDirection = 1;
   m_iLastFailedNextSlide = -1;
+  m_iPrefetchSlide = -1;
+  m_iPrefetchDirection = 0;
   m_slides.clear();
   AnnouncePlaylistClear();
   m_Resolution = CServiceBroker::GetWinSystem()->GetGfxContext().GetVideoResolution();
@@ -390,6 +544,7 @@ void CGUIWindowSlideShow::Process(unsigned int currentTime, CDirtyRegionList &re
   {
     m_pBackgroundLoader.reset(new CBackgroundPicLoader());
     m_pBackgroundLoader->Create(this);
+    m_iPrefetchSlide = -1;
   }
 
   bool bSlideShow = m_bSlideShow && !m_bPause && !m_bPlayingVideo;
@@ -489,6 +644,10 @@ void CGUIWindowSlideShow::Process(unsigned int currentTime, CDirtyRegionList &re
   if (m_Image[1 - m_iCurrentPic].IsLoaded() && m_Image[1 - m_iCurrentPic].SlideNumber() != m_iNextSlide)
     m_Image[1 - m_iCurrentPic].Close();
 
+  // decode the following slides ahead, before the next one is requested so it isn't decoded twice
+  if (m_Image[m_iCurrentPic].IsLoaded() && (m_iPrefetchSlide != m_iNextSlide || m_iPrefetchDirection != m_iDirection))
+    PrefetchSlides();
+
   if (m_iNextSlide != m_iCurrentSlide && m_Image[m_iCurrentPic].IsLoaded() && !m_Image[1 - m_iCurrentPic].IsLoaded() && !m_pBackgroundLoader->IsLoading() && m_iLastFailedNextSlide != m_iNextSlide)
   { // load the next image
     m_iLastFailedNextSlide = -1;
@@ -501,12 +660,29 @@ void CGUIWindowSlideShow::Process(unsigned int currentTime, CDirtyRegionList &re
       else
         CLog::Log(LOGDEBUG, "Loading the next image %d: %s", m_iNextSlide, item->GetPath().c_str());
 
+      // zoom is reset for the next slide
+      int maxWidth, maxHeight;
+      GetCheckedSize((float)res.iWidth, (float)res.iHeight, maxWidth, maxHeight);
+      m_pBackgroundLoader->LoadPic(1 - m_iCurrentPic, m_iNextSlide, picturePath, maxWidth, maxHeight);
+    }
+  }
+
+  // pictures are decoded for the screen, reload the current one in a higher resolution when zooming in
+  if (m_fZoom > m_fLoadedZoom && m_Image[m_iCurrentPic].IsLoaded() && !m_Image[m_iCurrentPic].FullSize() &&
+      !m_Image[m_iCurrentPic].DrawNextImage() && !m_pBackgroundLoader->IsLoading())
+  {
+    std::string picturePath = GetPicturePath(m_slides.at(m_iCurrentSlide).get());
+    if (!picturePath.empty())
+    {
+      CLog::Log(LOGDEBUG, "Reloading the current image %d for zoom %.1f: %s", m_iCurrentSlide, m_fZoom, m_slides.at(m_iCurrentSlide)->GetPath().c_str());
+
       int maxWidth, maxHeight;
       GetCheckedSize((float)res.iWidth * m_fZoom,
                      (float)res.iHeight * m_fZoom,
                      maxWidth, maxHeight);
-      m_pBackgroundLoader->LoadPic(1 - m_iCurrentPic, m_iNextSlide, picturePath, maxWidth, maxHeight);
+      m_pBackgroundLoader->LoadPic(m_iCurrentPic, m_iCurrentSlide, picturePath, maxWidth, maxHeight);
     }
+    m_fLoadedZoom = m_fZoom;
   }
 
   if (m_slides.at(m_iCurrentSlide)->IsVideo() &&
@@ -608,6 +784,7 @@ void CGUIWindowSlideShow::Process(unsigned int currentTime, CDirtyRegionList &re
 
     m_iZoomFactor = 1;
     m_fZoom = 1.0f;
+    m_fLoadedZoom = 1.0f;
     m_fRotate = 0.0f;
   }
 
@@ -1004,6 +1181,7 @@ bool CGUIWindowSlideShow::OnMessage(CGUIMessage& message)
             AnnouncePlayerPlay(m_slides.at(m_iCurrentSlide));
             m_iZoomFactor = 1;
             m_fZoom = 1.0f;
+            m_fLoadedZoom = 1.0f;
             m_fRotate = 0.0f;
           }
         }
@@ -1121,6 +1299,13 @@ void CGUIWindowSlideShow::OnLoadPic(int iPic, int iSlideNumber, const std::strin
       return;
     }
     CLog::Log(LOGDEBUG, "Finished background loading slot %d, %d: %s", iPic, iSlideNumber, m_slides.at(iSlideNumber)->GetPath().c_str());
+    if (m_Image[iPic].IsLoaded() && m_Image[iPic].SlideNumber() == iSlideNumber)
+    { // higher resolution for a zoomed picture, keep its state
+      m_Image[iPic].UpdateTexture(pTexture);
+      m_Image[iPic].SetOriginalSize(pTexture->GetOriginalWidth(), pTexture->GetOriginalHeight(), bFullSize);
+      MarkDirtyRegion();
+      return;
+    }
     m_Image[iPic].SetTexture(iSlideNumber, pTexture, GetDisplayEffect(iSlideNumber));
     m_Image[iPic].SetOriginalSize(pTexture->GetOriginalWidth(), pTexture->GetOriginalHeight(), bFullSize);
 
@@ -1270,8 +1455,43 @@ void CGUIWindowSlideShow::AddItems(const std::string &strPath, path_set *recursi
 
 void CGUIWindowSlideShow::GetCheckedSize(float width, float height, int &maxWidth, int &maxHeight)
 {
-  maxWidth = CServiceBroker::GetRenderSystem()->GetMaxTextureSize();
-  maxHeight = CServiceBroker::GetRenderSystem()->GetMaxTextureSize();
+  // decoding straight to the displayed size is a lot faster for large
+  // pictures and keeps the textures small
+  const int maxTextureSize = CServiceBroker::GetRenderSystem()->GetMaxTextureSize();
+  maxWidth = std::min(static_cast<int>(width + 0.5f), maxTextureSize);
+  maxHeight = std::min(static_cast<int>(height + 0.5f), maxTextureSize);
+}
+
+void CGUIWindowSlideShow::PrefetchSlides()
+{
+  const int slides = static_cast<int>(m_slides.size());
+  const int step = m_iDirection >= 0 ? 1 : -1;
+
+  std::vector<std::string> files;
+  auto addSlide = [&](int slide)
+  {
+    slide = (slide % slides + slides) % slides;
+    CFileItem* item = m_slides.at(slide).get();
+    if (slide == m_iCurrentSlide || item->IsVideo() || item->HasProperty("unplayable"))
+      return;
+    std::string picturePath = GetPicturePath(item);
+    if (!picturePath.empty() && std::find(files.begin(), files.end(), picturePath) == files.end())
+      files.push_back(picturePath);
+  };
+
+  // most likely first: the next slides, then the ones we came from
+  for (int i = 0; i < PREFETCH_AHEAD; i++)
+    addSlide(m_iNextSlide + i * step);
+  for (int i = 1; i <= PREFETCH_BEHIND; i++)
+    addSlide(m_iCurrentSlide - i * step);
+
+  const RESOLUTION_INFO res = CServiceBroker::GetWinSystem()->GetGfxContext().GetResInfo();
+  int maxWidth, maxHeight;
+  GetCheckedSize((float)res.iWidth, (float)res.iHeight, maxWidth, maxHeight);
+  m_pBackgroundLoader->Prefetch(files, maxWidth, maxHeight);
+
+  m_iPrefetchSlide = m_iNextSlide;
+  m_iPrefetchDirection = m_iDirection;
 }
 
 std::string CGUIWindowSlideShow::GetPicturePath(CFileItem *item)
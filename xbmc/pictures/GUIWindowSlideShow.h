@@ -8,10 +8,14 @@
 
 #pragma once
 
+#include <atomic>
+#include <list>
 #include <memory>
 #include <set>
+#include <vector>
 #include "guilib/GUIDialog.h"
 #include "threads/Thread.h"
+#include "threads/Condition.h"
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
 #include "SlideShowPicture.h"
@@ -34,8 +38,33 @@ public:
   int SlideNumber() const { return m_iSlideNumber; }
   int Pic() const { return m_iPic; }
 
+  /*!
+   \brief Decode pictures ahead on job workers, so LoadPic() can hand them
+   out without waiting for the decoder
+   \param files the pictures likely to be shown next, most likely first
+   */
+  void Prefetch(const std::vector<std::string> &files, int maxWidth, int maxHeight);
+
 private:
+  struct DecodedPic
+  {
+    std::string fileName;
+    int maxWidth;
+    int maxHeight;
+    CBaseTexture* texture;
+    bool decoding;
+    // claimed by whoever decodes it, the job or TakeDecoded(). Jobs the job
+    // manager dropped or cancelled leave it to TakeDecoded() and StopDecoders().
+    std::shared_ptr<std::atomic<bool>> claim;
+  };
+
   void Process() override;
+  CBaseTexture* TakeDecoded(const std::string &strFileName, int maxWidth, int maxHeight, bool &found);
+  std::list<DecodedPic>::iterator FindDecoded(const std::string &strFileName, int maxWidth, int maxHeight);
+  void StartDecoders();
+  void Decode(DecodedPic* pic);
+  void StopDecoders();
+
   int m_iPic;
   int m_iSlideNumber;
   std::string m_strFileName;
@@ -46,6 +75,16 @@ private:
   bool m_isLoading;
 
   CGUIWindowSlideShow *m_pCallback;
+
+  // decode-ahead, protected by m_decodeSection
+  std::list<DecodedPic> m_decoded;
+  std::vector<std::string> m_prefetch;
+  int m_prefetchWidth = 0;
+  int m_prefetchHeight = 0;
+  int m_activeDecoders = 0; // submitted and not finished
+  bool m_stopDecoders = false;
+  CCriticalSection m_decodeSection;
+  XbmcThreads::ConditionVariable m_decodeDone;
 };
 
 class CGUIWindowSlideShow : public CGUIDialog
@@ -112,6 +151,7 @@ private:
   void GetCheckedSize(float width, float height, int &maxWidth, int &maxHeight);
   std::string GetPicturePath(CFileItem *item);
   int  GetNextSlide();
+  void PrefetchSlides();
 
   void AnnouncePlayerPlay(const CFileItemPtr& item);
   void AnnouncePlayerPause(const CFileItemPtr& item);
@@ -128,6 +168,7 @@ private:
   int m_iZoomFactor;
   float m_fZoom;
   float m_fInitialZoom;
+  float m_fLoadedZoom;
 
   bool m_bShuffled;
   bool m_bSlideShow;
@@ -144,6 +185,8 @@ private:
   // background loader
   std::unique_ptr<CBackgroundPicLoader> m_pBackgroundLoader;
   int m_iLastFailedNextSlide;
+  int m_iPrefetchSlide;
+  int m_iPrefetchDirection;
   bool m_bLoadNextPic;
   RESOLUTION m_Resolution;
   CPoint m_firstGesturePoint;
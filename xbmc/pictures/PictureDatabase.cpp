@@ -0,0 +1,241 @@
+/*
+ *  Copyright (C) 2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "PictureDatabase.h"
+#include "dbwrappers/dataset.h"
+#include "utils/JSONVariantParser.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/Variant.h"
+
+#include <set>
+
+namespace
+{
+  std::string FormatColumn(const CDatabase& db, const std::string& value)
+  {
+    if (value.empty())
+      return "NULL";
+    return db.PrepareSQL("'%s'", value.c_str());
+  }
+}
+
+CPictureDatabase::CPictureDatabase() = default;
+
+CPictureDatabase::~CPictureDatabase() = default;
+
+bool CPictureDatabase::Open()
+{
+  return CDatabase::Open();
+}
+
+void CPictureDatabase::CreateTables()
+{
+  CLog::Log(LOGINFO, "create picture table");
+  m_pDS->exec("CREATE TABLE picture ("
+              "idPicture integer primary key,"
+              "path text,"
+              "filename text,"
+              "dateModified text,"
+              "dateTaken text,"
+              "cameraMake text,"
+              "cameraModel text,"
+              "latitude real,"
+              "longitude real,"
+              "tag text)");
+}
+
+void CPictureDatabase::CreateAnalytics()
+{
+  CLog::Log(LOGINFO, "%s - creating indices", __FUNCTION__);
+  m_pDS->exec("CREATE UNIQUE INDEX idxPicture ON picture(path, filename)");
+  m_pDS->exec("CREATE INDEX idxPictureDateTaken ON picture(path, dateTaken)");
+  m_pDS->exec("CREATE INDEX idxPictureCamera ON picture(path, cameraMake, cameraModel)");
+  m_pDS->exec("CREATE INDEX idxPictureLocation ON picture(path, latitude, longitude)");
+}
+
+bool CPictureDatabase::GetPictures(const std::string& path, std::map<std::string, IndexedPicture>& pictures)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    std::string folder(path);
+    URIUtils::AddSlashAtEnd(folder);
+
+    std::string sql = PrepareSQL("SELECT filename, dateModified, tag FROM picture WHERE path='%s'", folder.c_str());
+    if (!m_pDS->query(sql))
+      return false;
+
+    while (!m_pDS->eof())
+    {
+      IndexedPicture picture;
+      picture.path = folder + m_pDS->fv(0).get_asString();
+      picture.dateModified.SetFromDBDateTime(m_pDS->fv(1).get_asString());
+
+      const std::string tag = m_pDS->fv(2).get_asString();
+      CVariant value;
+      if (!tag.empty() && CJSONVariantParser::Parse(tag, value))
+        picture.tag.Deserialize(value);
+
+      pictures[picture.path] = picture;
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s, failed on path '%s'", __FUNCTION__, path.c_str());
+  }
+  return false;
+}
+
+bool CPictureDatabase::GetPictures(const std::string& path, Order order, std::vector<std::string>& files)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    std::string folder(path);
+    URIUtils::AddSlashAtEnd(folder);
+
+    std::string orderBy;
+    switch (order)
+    {
+    case Order::DATE_TAKEN:
+      orderBy = "dateTaken, filename";
+      break;
+    case Order::CAMERA:
+      orderBy = "cameraMake, cameraModel, dateTaken, filename";
+      break;
+    case Order::LOCATION:
+      orderBy = "latitude, longitude, filename";
+      break;
+    }
+
+    std::string sql = PrepareSQL("SELECT filename FROM picture WHERE path='%s' ORDER BY ", folder.c_str()) + orderBy;
+    if (!m_pDS->query(sql))
+      return false;
+
+    while (!m_pDS->eof())
+    {
+      files.push_back(folder + m_pDS->fv(0).get_asString());
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s, failed on path '%s'", __FUNCTION__, path.c_str());
+  }
+  return false;
+}
+
+bool CPictureDatabase::SetPictures(const std::vector<IndexedPicture>& pictures)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    BeginTransaction();
+
+    for (const auto& picture : pictures)
+    {
+      const std::string folder = URIUtils::GetDirectory(picture.path);
+      const std::string filename = URIUtils::GetFileName(picture.path);
+
+      std::string tag;
+      std::string dateTaken;
+      std::string latitude = "NULL";
+      std::string longitude = "NULL";
+      CVariant value;
+      if (picture.tag.Loaded())
+      {
+        picture.tag.Serialize(value);
+        CJSONVariantWriter::Write(value, tag, true);
+
+        if (picture.tag.GetDateTimeTaken().IsValid())
+          dateTaken = picture.tag.GetDateTimeTaken().GetAsDBDateTime();
+
+        double lat, lon;
+        if (picture.tag.GetGpsPosition(lat, lon))
+        {
+          latitude = StringUtils::Format("%f", lat);
+          longitude = StringUtils::Format("%f", lon);
+        }
+      }
+
+      m_pDS->exec(PrepareSQL("DELETE FROM picture WHERE path='%s' AND filename='%s'", folder.c_str(), filename.c_str()));
+      m_pDS->exec(PrepareSQL("INSERT INTO picture (path, filename, dateModified, dateTaken, cameraMake, cameraModel, latitude, longitude, tag) "
+                             "VALUES ('%s', '%s', '%s', ", folder.c_str(), filename.c_str(), picture.dateModified.GetAsDBDateTime().c_str()) +
+                  FormatColumn(*this, dateTaken) + ", " +
+                  FormatColumn(*this, value["cameramake"].asString()) + ", " +
+                  FormatColumn(*this, value["cameramodel"].asString()) + ", " +
+                  latitude + ", " + longitude + ", " +
+                  PrepareSQL("'%s')", tag.c_str()));
+    }
+
+    CommitTransaction();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+    RollbackTransaction();
+  }
+  return false;
+}
+
+bool CPictureDatabase::RemoveMissingPictures(const std::string& path, const std::vector<std::string>& files)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    std::string folder(path);
+    URIUtils::AddSlashAtEnd(folder);
+
+    std::set<std::string> existing;
+    for (const auto& file : files)
+      existing.insert(URIUtils::GetFileName(file));
+
+    std::vector<int> missing;
+    if (!m_pDS->query(PrepareSQL("SELECT idPicture, filename FROM picture WHERE path='%s'", folder.c_str())))
+      return false;
+
+    while (!m_pDS->eof())
+    {
+      if (existing.find(m_pDS->fv(1).get_asString()) == existing.end())
+        missing.push_back(m_pDS->fv(0).get_asInt());
+      m_pDS->next();
+    }
+    m_pDS->close();
+
+    if (missing.empty())
+      return true;
+
+    std::vector<std::string> ids;
+    for (int id : missing)
+      ids.push_back(StringUtils::Format("%i", id));
+
+    return ExecuteQuery("DELETE FROM picture WHERE idPicture IN (" + StringUtils::Join(ids, ",") + ")");
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s, failed on path '%s'", __FUNCTION__, path.c_str());
+  }
+  return false;
+}
@@ -0,0 +1,81 @@
+/*
+ *  Copyright (C) 2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "dbwrappers/Database.h"
+#include "pictures/PictureInfoTag.h"
+#include "XBDateTime.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+/*!
+ \brief Index of the metadata of picture files.
+
+ Reading the EXIF and IPTC data of a picture means opening the file, which is
+ slow for large folders on network shares. Tags are stored per file together
+ with its modification date, so they are only parsed again once the file
+ changed. The date taken, camera and GPS position have their own columns, so
+ the pictures of a folder can be ordered by them without loading any tags.
+ */
+class CPictureDatabase : public CDatabase
+{
+public:
+  struct IndexedPicture
+  {
+    std::string path; // full path of the file
+    CDateTime dateModified;
+    CPictureInfoTag tag; // not loaded if the file has no metadata
+  };
+
+  enum class Order
+  {
+    DATE_TAKEN,
+    CAMERA,
+    LOCATION
+  };
+
+  CPictureDatabase();
+  ~CPictureDatabase() override;
+  bool Open() override;
+
+  /*!
+   \brief Get the indexed pictures of a folder
+   \param path folder of the pictures
+   \param pictures the indexed pictures, keyed by their full path
+   */
+  bool GetPictures(const std::string& path, std::map<std::string, IndexedPicture>& pictures);
+
+  /*!
+   \brief Get the indexed files of a folder in the given order
+   \param path folder of the pictures
+   \param order what to order the files by, files lacking the data come first like with SortUtils
+   \param files full paths of the files
+   */
+  bool GetPictures(const std::string& path, Order order, std::vector<std::string>& files);
+
+  /*!
+   \brief Add or update pictures in a single transaction
+   */
+  bool SetPictures(const std::vector<IndexedPicture>& pictures);
+
+  /*!
+   \brief Remove the pictures of a folder that aren't in it anymore
+   \param path folder of the pictures
+   \param files full paths of the files that still exist
+   */
+  bool RemoveMissingPictures(const std::string& path, const std::vector<std::string>& files);
+
+protected:
+  void CreateTables() override;
+  void CreateAnalytics() override;
+  int GetSchemaVersion() const override { return 1; }
+  const char *GetBaseDBName() const override { return "Pictures"; }
+};
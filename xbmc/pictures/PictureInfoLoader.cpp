@@ -11,6 +11,15 @@
 #include "ServiceBroker.h"
 #include "settings/Settings.h"
 #include "FileItem.h"
+#include "utils/JobManager.h"
+#include "utils/log.h"
+#include "utils/URIUtils.h"
+
+#include <algorithm>
+#include <set>
+
+// number of job workers parsing tags ahead of the loader thread
+#define MAX_TAG_PARSERS 4
 
 CPictureInfoLoader::CPictureInfoLoader()
 {
@@ -21,9 +30,15 @@ CPictureInfoLoader::CPictureInfoLoader()
 CPictureInfoLoader::~CPictureInfoLoader()
 {
   StopThread();
+  StopTagLookups();
   delete m_mapFileItems;
 }
 
+bool CPictureInfoLoader::CanLoadTag(const CFileItem& item)
+{
+  return item.IsPicture() && !item.IsZIP() && !item.IsRAR() && !item.IsCBR() && !item.IsCBZ() && !item.IsInternetStream() && !item.IsVideo();
+}
+
 void CPictureInfoLoader::OnLoaderStart()
 {
   // Load previously cached items from HD
@@ -34,6 +49,23 @@ void CPictureInfoLoader::OnLoaderStart()
   m_tagReads = 0;
   m_loadTags = CServiceBroker::GetSettings().GetBool(CSettings::SETTING_PICTURES_USETAGS);
 
+  // Load the indexed tags of all folders the items are in
+  m_indexedPictures.clear();
+  m_newPictures.clear();
+  if (m_loadTags && m_database.Open())
+  {
+    std::set<std::string> folders;
+    for (const auto& item : m_vecItems)
+    {
+      if (!item->m_bIsFolder && CanLoadTag(*item))
+        folders.insert(URIUtils::GetDirectory(item->GetPath()));
+    }
+    for (const auto& folder : folders)
+      m_database.GetPictures(folder, m_indexedPictures);
+  }
+
+  m_lookupsStarted = false;
+
   if (m_pProgressCallback)
     m_pProgressCallback->SetProgressMax(m_pVecItems->GetFileCount());
 }
@@ -48,12 +80,20 @@ bool CPictureInfoLoader::LoadItem(CFileItem* pItem)
 
 bool CPictureInfoLoader::LoadItemCached(CFileItem* pItem)
 {
-  if (!pItem->IsPicture() || pItem->IsZIP() || pItem->IsRAR() || pItem->IsCBR() || pItem->IsCBZ() || pItem->IsInternetStream() || pItem->IsVideo())
+  if (!CanLoadTag(*pItem))
     return false;
 
   if (pItem->HasPictureInfoTag())
     return true;
 
+  // Check the index, the tag is valid as long as the file didn't change
+  auto indexed = m_indexedPictures.find(pItem->GetPath());
+  if (indexed != m_indexedPictures.end() && indexed->second.dateModified == pItem->m_dateTime)
+  {
+    *pItem->GetPictureInfoTag() = indexed->second.tag;
+    return true;
+  }
+
   // Check the cached item
   CFileItemPtr mapItem = (*m_mapFileItems)[pItem->GetPath()];
   if (mapItem && mapItem->m_dateTime==pItem->m_dateTime && mapItem->HasPictureInfoTag())
@@ -71,7 +111,7 @@ bool CPictureInfoLoader::LoadItemLookup(CFileItem* pItem)
   if (m_pProgressCallback && !pItem->m_bIsFolder)
     m_pProgressCallback->SetProgressAdvance();
 
-  if (!pItem->IsPicture() || pItem->IsZIP() || pItem->IsRAR() || pItem->IsCBR() || pItem->IsCBZ() || pItem->IsInternetStream() || pItem->IsVideo())
+  if (!CanLoadTag(*pItem))
     return false;
 
   if (pItem->HasPictureInfoTag())
@@ -79,19 +119,168 @@ bool CPictureInfoLoader::LoadItemLookup(CFileItem* pItem)
 
   if (m_loadTags)
   { // Nothing found, load tag from file
-    pItem->GetPictureInfoTag()->Load(pItem->GetPath());
+    if (!m_lookupsStarted)
+      StartTagLookups();
+
+    CPictureInfoTag tag;
+    if (!GetLookedUpTag(*pItem, tag))
+      tag.Load(pItem->GetPath());
+    *pItem->GetPictureInfoTag() = tag;
     m_tagReads++;
+
+    if (m_database.IsOpen() && !pItem->m_bIsFolder)
+    {
+      CPictureDatabase::IndexedPicture picture;
+      picture.path = pItem->GetPath();
+      picture.dateModified = pItem->m_dateTime;
+      picture.tag = tag;
+      m_newPictures.push_back(picture);
+    }
   }
 
   return true;
 }
 
+void CPictureInfoLoader::StartTagLookups()
+{
+  m_lookupsStarted = true;
+
+  // the items that are left after stage 1, in the order they are looked up
+  CSingleLock lock(m_lookupSection);
+  m_lookups.clear();
+  for (const auto& item : m_vecItems)
+  {
+    if (CanLoadTag(*item) && !item->HasPictureInfoTag())
+    {
+      TagLookup lookup;
+      lookup.path = item->GetPath();
+      m_lookups.push_back(lookup);
+    }
+  }
+  m_nextLookup = 0;
+  m_nextParse = 0;
+  m_stopLookups = false;
+
+  // the loader thread parses as well, workers only help with larger folders
+  m_activeParsers = std::min<unsigned int>(MAX_TAG_PARSERS, m_lookups.size() / 8);
+  m_parserClaims.clear();
+  for (unsigned int i = 0; i < m_activeParsers; i++)
+  {
+    std::shared_ptr<std::atomic<bool>> claim = std::make_shared<std::atomic<bool>>(false);
+    m_parserClaims.push_back(claim);
+    CJobManager::GetInstance().Submit([this, claim]() {
+      if (claim->exchange(true))
+        return;
+      CSingleLock lock(m_lookupSection);
+      while (ParseNextTag(lock))
+        ;
+      m_activeParsers--;
+      m_lookupDone.notifyAll();
+    }, CJob::PRIORITY_NORMAL);
+  }
+
+  CLog::Log(LOGDEBUG, "%s - parsing %u tags with %u workers", __FUNCTION__,
+            static_cast<unsigned int>(m_lookups.size()), m_activeParsers);
+}
+
+void CPictureInfoLoader::StopTagLookups()
+{
+  CSingleLock lock(m_lookupSection);
+  m_stopLookups = true;
+
+  // only wait for the parsers that started
+  for (const auto& claim : m_parserClaims)
+  {
+    if (!claim->exchange(true))
+      m_activeParsers--;
+  }
+  m_parserClaims.clear();
+
+  while (m_activeParsers > 0)
+    m_lookupDone.wait(lock);
+  m_lookups.clear();
+}
+
+bool CPictureInfoLoader::ParseNextTag(CSingleLock& lock)
+{
+  if (m_stopLookups || m_bStop || m_nextParse >= m_lookups.size())
+    return false;
+
+  size_t index = m_nextParse++;
+  std::string path = m_lookups[index].path;
+
+  CPictureInfoTag tag;
+  {
+    CSingleExit exit(m_lookupSection);
+    tag.Load(path);
+  }
+
+  m_lookups[index].tag = tag;
+  m_lookups[index].done = true;
+  m_lookupDone.notifyAll();
+  return true;
+}
+
+bool CPictureInfoLoader::GetLookedUpTag(const CFileItem& item, CPictureInfoTag& tag)
+{
+  CSingleLock lock(m_lookupSection);
+
+  // items are looked up in the order the lookups were created in
+  while (m_nextLookup < m_lookups.size() && m_lookups[m_nextLookup].path != item.GetPath())
+    m_nextLookup++;
+  if (m_nextLookup >= m_lookups.size())
+    return false;
+
+  TagLookup& lookup = m_lookups[m_nextLookup];
+  while (!lookup.done)
+  {
+    // help out instead of waiting if there is anything left to parse
+    if (ParseNextTag(lock))
+      continue;
+
+    // lookups are claimed in order, an unclaimed one won't be parsed when stopping
+    if (m_nextLookup >= m_nextParse)
+      return false;
+
+    m_lookupDone.wait(lock);
+  }
+
+  tag = lookup.tag;
+  m_nextLookup++;
+  return true;
+}
+
 void CPictureInfoLoader::OnLoaderFinish()
 {
+  StopTagLookups();
+
   // cleanup cache loaded from HD
   m_mapFileItems->Clear();
 
   // Save loaded items to HD
   if (!m_bStop && m_tagReads > 0)
     m_pVecItems->Save();
+
+  // Update the index with the parsed tags and drop the files that are gone
+  if (m_database.IsOpen())
+  {
+    if (!m_newPictures.empty())
+      m_database.SetPictures(m_newPictures);
+
+    if (!m_bStop && !m_pVecItems->GetPath().empty())
+    {
+      std::vector<std::string> files;
+      for (const auto& item : m_vecItems)
+      {
+        if (URIUtils::PathEquals(URIUtils::GetDirectory(item->GetPath()), m_pVecItems->GetPath(), true))
+          files.push_back(item->GetPath());
+      }
+      m_database.RemoveMissingPictures(m_pVecItems->GetPath(), files);
+    }
+
+    m_database.Close();
+  }
+
+  m_indexedPictures.clear();
+  m_newPictures.clear();
 }
@@ -9,7 +9,17 @@
 #pragma once
 
 #include "BackgroundInfoLoader.h"
+#include "PictureDatabase.h"
+#include "PictureInfoTag.h"
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+
+#include <atomic>
+#include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 class CPictureInfoLoader : public CBackgroundInfoLoader
 {
@@ -29,5 +39,37 @@ protected:
   CFileItemList* m_mapFileItems;
   unsigned int m_tagReads;
   bool m_loadTags;
+
+private:
+  struct TagLookup
+  {
+    std::string path;
+    CPictureInfoTag tag;
+    bool done = false;
+  };
+
+  static bool CanLoadTag(const CFileItem& item);
+  void StartTagLookups();
+  void StopTagLookups();
+  bool ParseNextTag(CSingleLock& lock);
+  bool GetLookedUpTag(const CFileItem& item, CPictureInfoTag& tag);
+
+  CPictureDatabase m_database;
+  std::map<std::string, CPictureDatabase::IndexedPicture> m_indexedPictures;
+  std::vector<CPictureDatabase::IndexedPicture> m_newPictures;
+
+  // tags of the items missing from the index are parsed ahead on job workers
+  // in the order the items are looked up
+  std::vector<TagLookup> m_lookups;
+  bool m_lookupsStarted = false;
+  bool m_stopLookups = false;
+  size_t m_nextLookup = 0;
+  size_t m_nextParse = 0;
+  // a parser job only touches the loader once it claimed its start, jobs the
+  // job manager dropped or cancelled are claimed by StopTagLookups() instead
+  std::vector<std::shared_ptr<std::atomic<bool>>> m_parserClaims;
+  unsigned int m_activeParsers = 0; // submitted and not finished
+  CCriticalSection m_lookupSection;
+  XbmcThreads::ConditionVariable m_lookupDone;
 };
 
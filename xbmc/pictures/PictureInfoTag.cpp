@@ -14,8 +14,26 @@
 #include "utils/Archive.h"
 
 #include <algorithm>
+#include <stdio.h>
 #include <vector>
 
+namespace
+{
+  // Converts the "N 51d  2'  3.45"" format of CExifParse to signed degrees
+  bool ParseCoordinate(const char* value, double& degrees)
+  {
+    char ref;
+    double d, m, s;
+    if (sscanf(value, "%c %lfd %lf' %lf", &ref, &d, &m, &s) != 4)
+      return false;
+
+    degrees = d + m / 60.0 + s / 3600.0;
+    if (ref == 'S' || ref == 'W')
+      degrees = -degrees;
+    return true;
+  }
+}
+
 void CPictureInfoTag::Reset()
 {
   memset(&m_exifInfo, 0, sizeof(m_exifInfo));
@@ -244,10 +262,96 @@ void CPictureInfoTag::Serialize(CVariant& value) const
   value["imagetype"] = std::string(m_iptcInfo.ImageType);
 }
 
+void CPictureInfoTag::Deserialize(const CVariant& value)
+{
+  Reset();
+
+  m_exifInfo.ApertureFNumber = value["aperturefnumber"].asFloat();
+  GetStringFromVariant(value["cameramake"], m_exifInfo.CameraMake, sizeof(m_exifInfo.CameraMake));
+  GetStringFromVariant(value["cameramodel"], m_exifInfo.CameraModel, sizeof(m_exifInfo.CameraModel));
+  m_exifInfo.CCDWidth = value["ccdwidth"].asFloat();
+  GetStringFromVariant(value["comments"], m_exifInfo.Comments, sizeof(m_exifInfo.Comments));
+  m_exifInfo.CommentsCharset = EXIF_COMMENT_CHARSET_CONVERTED; // Serialized comments are charset converted
+  GetStringFromVariant(value["description"], m_exifInfo.Description, sizeof(m_exifInfo.Description));
+  GetStringFromVariant(value["datetime"], m_exifInfo.DateTime, sizeof(m_exifInfo.DateTime));
+  for (int i = 0; i < 10; i++)
+    m_exifInfo.DateTimeOffsets[i] = static_cast<int>(value["datetimeoffsets"][i].asInteger());
+  m_exifInfo.DigitalZoomRatio = value["digitalzoomratio"].asFloat();
+  m_exifInfo.Distance = value["distance"].asFloat();
+  m_exifInfo.ExposureBias = value["exposurebias"].asFloat();
+  m_exifInfo.ExposureMode = static_cast<int>(value["exposuremode"].asInteger());
+  m_exifInfo.ExposureProgram = static_cast<int>(value["exposureprogram"].asInteger());
+  m_exifInfo.ExposureTime = value["exposuretime"].asFloat();
+  m_exifInfo.FlashUsed = static_cast<int>(value["flashused"].asInteger());
+  m_exifInfo.FocalLength = value["focallength"].asFloat();
+  m_exifInfo.FocalLength35mmEquiv = static_cast<int>(value["focallength35mmequiv"].asInteger());
+  m_exifInfo.GpsInfoPresent = static_cast<int>(value["gpsinfopresent"].asInteger());
+  GetStringFromVariant(value["gpsinfo"]["alt"], m_exifInfo.GpsAlt, sizeof(m_exifInfo.GpsAlt));
+  GetStringFromVariant(value["gpsinfo"]["lat"], m_exifInfo.GpsLat, sizeof(m_exifInfo.GpsLat));
+  GetStringFromVariant(value["gpsinfo"]["long"], m_exifInfo.GpsLong, sizeof(m_exifInfo.GpsLong));
+  m_exifInfo.Height = static_cast<int>(value["height"].asInteger());
+  m_exifInfo.IsColor = static_cast<int>(value["iscolor"].asInteger());
+  m_exifInfo.ISOequivalent = static_cast<int>(value["isoequivalent"].asInteger());
+  m_exifInfo.LargestExifOffset = static_cast<unsigned>(value["largestexifoffset"].asUnsignedInteger());
+  m_exifInfo.LightSource = static_cast<int>(value["lightsource"].asInteger());
+  m_exifInfo.MeteringMode = static_cast<int>(value["meteringmode"].asInteger());
+  m_exifInfo.numDateTimeTags = static_cast<int>(value["numdatetimetags"].asInteger());
+  m_exifInfo.Orientation = static_cast<int>(value["orientation"].asInteger());
+  m_exifInfo.Process = static_cast<int>(value["process"].asInteger());
+  m_exifInfo.ThumbnailAtEnd = static_cast<char>(value["thumbnailatend"].asInteger());
+  m_exifInfo.ThumbnailOffset = static_cast<unsigned>(value["thumbnailoffset"].asUnsignedInteger());
+  m_exifInfo.ThumbnailSize = static_cast<unsigned>(value["thumbnailsize"].asUnsignedInteger());
+  m_exifInfo.ThumbnailSizeOffset = static_cast<int>(value["thumbnailsizeoffset"].asInteger());
+  m_exifInfo.Whitebalance = static_cast<int>(value["whitebalance"].asInteger());
+  m_exifInfo.Width = static_cast<int>(value["width"].asInteger());
+
+  GetStringFromVariant(value["author"], m_iptcInfo.Author, sizeof(m_iptcInfo.Author));
+  GetStringFromVariant(value["byline"], m_iptcInfo.Byline, sizeof(m_iptcInfo.Byline));
+  GetStringFromVariant(value["bylinetitle"], m_iptcInfo.BylineTitle, sizeof(m_iptcInfo.BylineTitle));
+  GetStringFromVariant(value["caption"], m_iptcInfo.Caption, sizeof(m_iptcInfo.Caption));
+  GetStringFromVariant(value["category"], m_iptcInfo.Category, sizeof(m_iptcInfo.Category));
+  GetStringFromVariant(value["city"], m_iptcInfo.City, sizeof(m_iptcInfo.City));
+  GetStringFromVariant(value["urgency"], m_iptcInfo.Urgency, sizeof(m_iptcInfo.Urgency));
+  GetStringFromVariant(value["copyrightnotice"], m_iptcInfo.CopyrightNotice, sizeof(m_iptcInfo.CopyrightNotice));
+  GetStringFromVariant(value["country"], m_iptcInfo.Country, sizeof(m_iptcInfo.Country));
+  GetStringFromVariant(value["countrycode"], m_iptcInfo.CountryCode, sizeof(m_iptcInfo.CountryCode));
+  GetStringFromVariant(value["credit"], m_iptcInfo.Credit, sizeof(m_iptcInfo.Credit));
+  GetStringFromVariant(value["date"], m_iptcInfo.Date, sizeof(m_iptcInfo.Date));
+  GetStringFromVariant(value["headline"], m_iptcInfo.Headline, sizeof(m_iptcInfo.Headline));
+  GetStringFromVariant(value["keywords"], m_iptcInfo.Keywords, sizeof(m_iptcInfo.Keywords));
+  GetStringFromVariant(value["objectname"], m_iptcInfo.ObjectName, sizeof(m_iptcInfo.ObjectName));
+  GetStringFromVariant(value["referenceservice"], m_iptcInfo.ReferenceService, sizeof(m_iptcInfo.ReferenceService));
+  GetStringFromVariant(value["source"], m_iptcInfo.Source, sizeof(m_iptcInfo.Source));
+  GetStringFromVariant(value["specialinstructions"], m_iptcInfo.SpecialInstructions, sizeof(m_iptcInfo.SpecialInstructions));
+  GetStringFromVariant(value["state"], m_iptcInfo.State, sizeof(m_iptcInfo.State));
+  GetStringFromVariant(value["supplementalcategories"], m_iptcInfo.SupplementalCategories, sizeof(m_iptcInfo.SupplementalCategories));
+  GetStringFromVariant(value["transmissionreference"], m_iptcInfo.TransmissionReference, sizeof(m_iptcInfo.TransmissionReference));
+  GetStringFromVariant(value["timecreated"], m_iptcInfo.TimeCreated, sizeof(m_iptcInfo.TimeCreated));
+  GetStringFromVariant(value["sublocation"], m_iptcInfo.SubLocation, sizeof(m_iptcInfo.SubLocation));
+  GetStringFromVariant(value["imagetype"], m_iptcInfo.ImageType, sizeof(m_iptcInfo.ImageType));
+
+  m_isLoaded = true;
+  ConvertDateTime();
+}
+
 void CPictureInfoTag::ToSortable(SortItem& sortable, Field field) const
 {
   if (field == FieldDateTaken && m_dateTimeTaken.IsValid())
     sortable[FieldDateTaken] = m_dateTimeTaken.GetAsDBDateTime();
+  else if (field == FieldCamera && m_exifInfo.CameraMake[0] != 0)
+    sortable[FieldCamera] = StringUtils::Format("%s %s", m_exifInfo.CameraMake, m_exifInfo.CameraModel);
+  else if (field == FieldLocation)
+  {
+    // shifted to positive values, so they sort as text
+    double latitude, longitude;
+    if (GetGpsPosition(latitude, longitude))
+      sortable[FieldLocation] = StringUtils::Format("%010.6f %010.6f", latitude + 90.0, longitude + 180.0);
+  }
+}
+
+bool CPictureInfoTag::GetGpsPosition(double& latitude, double& longitude) const
+{
+  return ParseCoordinate(m_exifInfo.GpsLat, latitude) && ParseCoordinate(m_exifInfo.GpsLong, longitude);
 }
 
 void CPictureInfoTag::GetStringFromArchive(CArchive &ar, char *string, size_t length)
@@ -260,6 +364,15 @@ void CPictureInfoTag::GetStringFromArchive(CArchive &ar, char *string, size_t le
   string[length] = 0;
 }
 
+void CPictureInfoTag::GetStringFromVariant(const CVariant &value, char *string, size_t length)
+{
+  const std::string temp = value.asString();
+  length = std::min(temp.size(), length - 1);
+  if (!temp.empty())
+    memcpy(string, temp.c_str(), length);
+  string[length] = 0;
+}
+
 const std::string CPictureInfoTag::GetInfo(int info) const
 {
   if (!m_isLoaded && !m_isInfoSetExternally) // If no metadata has been loaded from the picture file or set with SetInfo(), just return
@@ -26,6 +26,10 @@ public:
   void Reset();
   void Archive(CArchive& ar) override;
   void Serialize(CVariant& value) const override;
+  /*!
+   \brief Restore a loaded tag from the output of Serialize()
+   */
+  void Deserialize(const CVariant& value);
   void ToSortable(SortItem& sortable, Field field) const override;
   const std::string GetInfo(int info) const;
 
@@ -41,9 +45,18 @@ public:
    * DateTime tags. See libexif CExifParse::ProcessDir for details.
    */
   const CDateTime& GetDateTimeTaken() const;
+
+  /*!
+   \brief Get the GPS position the picture was taken at
+   \param latitude degrees north, negative for south
+   \param longitude degrees east, negative for west
+   \return false if the picture has no or an unreadable position
+   */
+  bool GetGpsPosition(double& latitude, double& longitude) const;
 private:
   static int TranslateString(const std::string &info);
   void GetStringFromArchive(CArchive &ar, char *string, size_t length);
+  static void GetStringFromVariant(const CVariant &value, char *string, size_t length);
 
   ExifInfo_t m_exifInfo;
   IPTCInfo_t m_iptcInfo;
@@ -260,6 +260,8 @@ void CSlideShowPic::UpdateTexture(CBaseTexture* pTexture)
   m_pImage = pTexture;
   m_fWidth = (float)pTexture->GetWidth();
   m_fHeight = (float)pTexture->GetHeight();
+  if (CServiceBroker::GetSettings().GetBool(CSettings::SETTING_SLIDESHOW_HIGHQUALITYDOWNSCALING))
+    pTexture->SetMipmapping();
   m_bIsDirty = true;
 }
 
@@ -0,0 +1,217 @@
+/*
+ *  Copyright (C) 2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "PVRChannelPreTuner.h"
+
+#include <algorithm>
+
+#include "FileItem.h"
+#include "ServiceBroker.h"
+#include "addons/PVRClient.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/JobManager.h"
+#include "utils/log.h"
+
+#include "pvr/PVRManager.h"
+#include "pvr/channels/PVRChannel.h"
+#include "pvr/channels/PVRChannelGroup.h"
+
+using namespace PVR;
+
+// owned by the job, so processing is marked done as well if the job is dropped or cancelled
+struct CPVRChannelPreTuner::ProcessingJob
+{
+  ProcessingJob(const std::shared_ptr<CPVRChannelPreTuner> &preTuner, unsigned int iGeneration) :
+    m_preTuner(preTuner), m_iGeneration(iGeneration)
+  {
+  }
+
+  ~ProcessingJob()
+  {
+    CSingleLock lock(m_preTuner->m_critSection);
+    if (m_preTuner->m_iGeneration == m_iGeneration)
+      m_preTuner->m_bProcessing = false;
+  }
+
+  std::shared_ptr<CPVRChannelPreTuner> m_preTuner;
+  unsigned int m_iGeneration;
+};
+
+void CPVRChannelPreTuner::OnPlaybackStarted(const CPVRChannelPtr &channel, const CPVRChannelGroupPtr &group)
+{
+  const size_t iMaxChannels = static_cast<size_t>(std::max(g_advancedSettings.m_iPVRPreTuneChannels, 0));
+  if (iMaxChannels == 0 || !channel)
+    return;
+
+  CSingleLock lock(m_critSection);
+
+  // channel history, most recent first
+  m_history.erase(std::remove(m_history.begin(), m_history.end(), channel), m_history.end());
+  m_history.push_front(channel);
+  while (m_history.size() > iMaxChannels + 1)
+    m_history.pop_back();
+
+  // up/down neighbours first, then the channels played before
+  std::vector<CPVRChannelPtr> candidates;
+  const auto addCandidate = [&candidates, &channel](const CPVRChannelPtr &candidate) {
+    if (candidate && candidate != channel && std::find(candidates.begin(), candidates.end(), candidate) == candidates.end())
+      candidates.emplace_back(candidate);
+  };
+
+  if (group)
+  {
+    const CFileItemPtr next = group->GetNextChannel(channel);
+    if (next && next->HasPVRChannelInfoTag())
+      addCandidate(next->GetPVRChannelInfoTag());
+
+    const CFileItemPtr previous = group->GetPreviousChannel(channel);
+    if (previous && previous->HasPVRChannelInfoTag())
+      addCandidate(previous->GetPVRChannelInfoTag());
+  }
+
+  for (const auto &recent : m_history)
+    addCandidate(recent);
+
+  if (candidates.size() > iMaxChannels)
+    candidates.resize(iMaxChannels);
+
+  // keep at most one entry per candidate. entries past half of their lifetime are fetched again.
+  const unsigned int iNow = XbmcThreads::SystemClockMillis();
+  const unsigned int iMaxAge = g_advancedSettings.m_iPVRPreTuneExpiry * 1000 / 2;
+  m_entries.erase(std::remove_if(m_entries.begin(), m_entries.end(), [&candidates, iNow, iMaxAge](const Entry &entry) {
+    return std::find(candidates.begin(), candidates.end(), entry.channel) == candidates.end() ||
+           iNow - entry.iFetched > iMaxAge;
+  }), m_entries.end());
+
+  m_candidates.clear();
+  for (const auto &candidate : candidates)
+  {
+    const auto it = std::find_if(m_entries.begin(), m_entries.end(), [&candidate](const Entry &entry) {
+      return entry.channel == candidate;
+    });
+    if (it == m_entries.end())
+      m_candidates.emplace_back(candidate);
+  }
+
+  if (!m_candidates.empty() && !m_bProcessing)
+  {
+    m_bProcessing = true;
+    const std::shared_ptr<ProcessingJob> job(new ProcessingJob(shared_from_this(), ++m_iGeneration));
+    CJobManager::GetInstance().Submit([job]() {
+      job->m_preTuner->Process(job->m_iGeneration);
+    });
+  }
+}
+
+void CPVRChannelPreTuner::Process(unsigned int iGeneration)
+{
+  while (true)
+  {
+    CPVRChannelPtr channel;
+    {
+      CSingleLock lock(m_critSection);
+      if (m_iGeneration != iGeneration)
+        return;
+
+      if (m_candidates.empty())
+      {
+        m_bProcessing = false;
+        return;
+      }
+      channel = m_candidates.front();
+    }
+
+    // one client call at a time, without holding the lock
+    const std::shared_ptr<CFileItem> item = std::make_shared<CFileItem>(channel);
+    const CPVRClientPtr client = CServiceBroker::GetPVRManager().GetClient(channel->ClientID());
+    const bool bFilled = client && client->FillChannelStreamFileItem(*item) == PVR_ERROR_NO_ERROR;
+
+    CSingleLock lock(m_critSection);
+
+    // cleared in the meantime, a new job may already be running
+    if (m_iGeneration != iGeneration)
+      return;
+
+    // candidates may have changed in the meantime
+    const auto it = std::find(m_candidates.begin(), m_candidates.end(), channel);
+    if (it == m_candidates.end())
+      continue;
+
+    m_candidates.erase(it);
+
+    if (bFilled)
+    {
+      m_entries.emplace_back(Entry{channel, item, XbmcThreads::SystemClockMillis()});
+      CLog::LogFC(LOGDEBUG, LOGPVR, "Fetched stream properties of channel '%s' in advance", channel->ChannelName().c_str());
+    }
+  }
+}
+
+bool CPVRChannelPreTuner::FillStreamFileItem(CFileItem &fileItem)
+{
+  if (g_advancedSettings.m_iPVRPreTuneChannels <= 0)
+    return false;
+
+  const CPVRChannelPtr channel = fileItem.GetPVRChannelInfoTag();
+  if (!channel)
+    return false;
+
+  std::shared_ptr<CFileItem> item;
+  {
+    CSingleLock lock(m_critSection);
+
+    const auto it = std::find_if(m_entries.begin(), m_entries.end(), [&channel](const Entry &entry) {
+      return entry.channel == channel;
+    });
+
+    if (it != m_entries.end())
+    {
+      // properties may hold session specific urls, use them once only
+      if (IsFresh(*it, XbmcThreads::SystemClockMillis()))
+        item = it->item;
+
+      m_entries.erase(it);
+    }
+
+    if (item)
+      m_iHits++;
+    else
+      m_iMisses++;
+
+    CLog::LogFC(LOGDEBUG, LOGPVR, "Stream properties of channel '%s' %s fetched in advance (%u hits, %u misses)",
+                channel->ChannelName().c_str(), item ? "were" : "were not", m_iHits, m_iMisses);
+  }
+
+  if (!item)
+    return false;
+
+  fileItem.SetDynPath(item->GetDynPath());
+  fileItem.SetMimeType(item->GetMimeType());
+  fileItem.SetContentLookup(item->ContentLookup());
+  fileItem.AppendProperties(*item);
+  return true;
+}
+
+void CPVRChannelPreTuner::Clear()
+{
+  CSingleLock lock(m_critSection);
+  m_history.clear();
+  m_candidates.clear();
+  m_entries.clear();
+
+  // a running job stops after its current client call
+  ++m_iGeneration;
+  m_bProcessing = false;
+}
+
+bool CPVRChannelPreTuner::IsFresh(const Entry &entry, unsigned int iNow) const
+{
+  return iNow - entry.iFetched <= static_cast<unsigned int>(g_advancedSettings.m_iPVRPreTuneExpiry) * 1000;
+}
@@ -0,0 +1,83 @@
+/*
+ *  Copyright (C) 2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "threads/CriticalSection.h"
+
+#include "pvr/PVRTypes.h"
+
+class CFileItem;
+
+namespace PVR
+{
+  /*!
+   * @brief Fetches the stream properties of the channels that are likely to be played next.
+   *
+   * Starting playback of a channel needs a GetChannelStreamProperties call to the client
+   * before the input stream can be opened, which can take a noticeable part of a channel
+   * switch for clients that resolve the stream url on their backend. After a channel was
+   * started, the properties of its neighbours in the playing group and of the channels
+   * played before it are fetched in the background and used for the next switch if they
+   * are not older than the configured expiry.
+   *
+   * Enabled with <pvr><pretunechannels> in advancedsettings.xml, the expiry is
+   * <pretuneexpiry> in seconds.
+   */
+  class CPVRChannelPreTuner : public std::enable_shared_from_this<CPVRChannelPreTuner>
+  {
+  public:
+    CPVRChannelPreTuner() = default;
+    virtual ~CPVRChannelPreTuner() = default;
+
+    /*!
+     * @brief Fetch the stream properties of the channels likely to be played after the given one.
+     * @param channel The channel that started playing.
+     * @param group The group the channel is playing from.
+     */
+    void OnPlaybackStarted(const CPVRChannelPtr &channel, const CPVRChannelGroupPtr &group);
+
+    /*!
+     * @brief Fill the stream properties of a channel item from the properties fetched in advance.
+     * @param fileItem The item of the channel to play.
+     * @return true if up to date properties were available, false otherwise.
+     */
+    bool FillStreamFileItem(CFileItem &fileItem);
+
+    /*!
+     * @brief Drop all properties fetched in advance and the channel history.
+     */
+    void Clear();
+
+  private:
+    struct Entry
+    {
+      CPVRChannelPtr channel;
+      std::shared_ptr<CFileItem> item;
+      unsigned int iFetched;
+    };
+
+    struct ProcessingJob;
+
+    void Process(unsigned int iGeneration);
+    bool IsFresh(const Entry &entry, unsigned int iNow) const;
+
+    CCriticalSection m_critSection;
+    std::deque<CPVRChannelPtr> m_history;
+    std::vector<CPVRChannelPtr> m_candidates;
+    std::vector<Entry> m_entries;
+    bool m_bProcessing = false;
+    unsigned int m_iGeneration = 0; // of the processing job, changed by every submit and by Clear()
+    unsigned int m_iHits = 0;
+    unsigned int m_iMisses = 0;
+  };
+}
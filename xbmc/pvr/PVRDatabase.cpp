@@ -277,6 +277,7 @@ int CPVRDatabase::Get(CPVRChannelGroup &results, bool bCompressDB)
                                         0);
         results.m_sortedMembers.emplace_back(newMember);
         results.m_members.insert(std::make_pair(channel->StorageId(), newMember));
+        results.InvalidateMembersIndex();
 
         m_pDS->next();
         ++iReturn;
@@ -583,6 +584,7 @@ int CPVRDatabase::Get(CPVRChannelGroup &group, const CPVRChannelGroup &allGroup)
                                           0);
           group.m_sortedMembers.emplace_back(newMember);
           group.m_members.insert(std::make_pair(channel->second->StorageId(), newMember));
+          group.InvalidateMembersIndex();
           ++iReturn;
         }
         else
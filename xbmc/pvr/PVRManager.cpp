@@ -23,6 +23,7 @@
 #include "utils/Variant.h"
 #include "utils/log.h"
 
+#include "pvr/PVRChannelPreTuner.h"
 #include "pvr/PVRDatabase.h"
 #include "pvr/PVRGUIActions.h"
 #include "pvr/PVRGUIInfo.h"
@@ -125,6 +126,7 @@ CPVRManager::CPVRManager(void) :
     m_addons(new CPVRClients),
     m_guiInfo(new CPVRGUIInfo),
     m_guiActions(new CPVRGUIActions),
+    m_preTuner(new CPVRChannelPreTuner),
     m_database(new CPVRDatabase),
     m_parentalTimer(new CStopWatch),
     m_settings({
@@ -231,6 +233,7 @@ void CPVRManager::Clear(void)
 {
   m_pendingUpdates.Clear();
   m_epgContainer.Clear();
+  m_preTuner->Clear();
 
   CSingleLock lock(m_critSection);
 
@@ -767,6 +770,8 @@ void CPVRManager::OnPlaybackStarted(const CFileItemPtr item)
 
     SetPlayingGroup(channel);
     UpdateLastWatched(channel);
+
+    m_preTuner->OnPlaybackStarted(channel, GetPlayingGroup(channel->IsRadio()));
   }
   else if (item->HasPVRRecordingInfoTag())
   {
@@ -878,7 +883,8 @@ bool CPVRManager::FillStreamFileItem(CFileItem &fileItem)
   if (client)
   {
     if (fileItem.IsPVRChannel())
-      return client->FillChannelStreamFileItem(fileItem) == PVR_ERROR_NO_ERROR;
+      return m_preTuner->FillStreamFileItem(fileItem) ||
+             client->FillChannelStreamFileItem(fileItem) == PVR_ERROR_NO_ERROR;
     else if (fileItem.IsPVRRecording())
       return client->FillRecordingStreamFileItem(fileItem) == PVR_ERROR_NO_ERROR;
     else if (fileItem.IsEPG())
@@ -34,6 +34,7 @@ class CVariant;
 
 namespace PVR
 {
+  class CPVRChannelPreTuner;
   class CPVRClient;
   class CPVRGUIInfo;
   class CPVRGUIProgressHandler;
@@ -515,6 +516,7 @@ namespace PVR
     std::unique_ptr<CPVRGUIInfo>   m_guiInfo;                     /*!< pointer to the guiinfo data */
     CPVRGUIActionsPtr              m_guiActions;                  /*!< pointer to the pvr gui actions */
     CPVREpgContainer               m_epgContainer;                /*!< the epg container */
+    std::shared_ptr<CPVRChannelPreTuner> m_preTuner;              /*!< stream properties of the channels likely to be played next */
     //@}
 
     CPVRManagerJobQueue             m_pendingUpdates;              /*!< vector of pending pvr updates */
@@ -8,12 +8,17 @@
 
 #include "PVRClients.h"
 
+#include <set>
 #include <utility>
 
 #include "ServiceBroker.h"
 #include "addons/BinaryAddonCache.h"
 #include "guilib/LocalizeStrings.h"
 #include "messaging/ApplicationMessenger.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/Condition.h"
+#include "threads/SystemClock.h"
+#include "utils/JobManager.h"
 #include "utils/log.h"
 
 #include "pvr/PVRJobs.h"
@@ -35,9 +40,53 @@ namespace
     return iClientId;
   }
 
+  struct ClientCall
+  {
+    int iClientId;
+    CPVRClientPtr client;
+    PVR_ERROR error = PVR_ERROR_NO_ERROR;
+    bool bDone = false;
+    CPVRClient::TransferQueue transfers;
+  };
+
+  struct ClientCalls
+  {
+    CCriticalSection critSection;
+    XbmcThreads::ConditionVariable doneCondition;
+    std::vector<ClientCall> calls;
+    size_t iPending = 0;
+  };
+
 } // unnamed namespace
 
-CPVRClients::CPVRClients(void)
+struct CPVRClients::OutstandingCalls
+{
+  CCriticalSection critSection;
+  std::set<int> clientIds;
+};
+
+// owned by the job of a call, so the client is released as well if the job is dropped or cancelled
+struct CPVRClients::OutstandingCall
+{
+  OutstandingCall(const std::shared_ptr<OutstandingCalls> &calls, int iClientId) :
+    m_calls(calls), m_iClientId(iClientId)
+  {
+    CSingleLock lock(m_calls->critSection);
+    m_calls->clientIds.insert(m_iClientId);
+  }
+
+  ~OutstandingCall()
+  {
+    CSingleLock lock(m_calls->critSection);
+    m_calls->clientIds.erase(m_iClientId);
+  }
+
+  std::shared_ptr<OutstandingCalls> m_calls;
+  int m_iClientId;
+};
+
+CPVRClients::CPVRClients(void) :
+  m_outstandingCalls(new OutstandingCalls)
 {
   CServiceBroker::GetAddonMgr().RegisterAddonMgrCallback(ADDON_PVRDLL, this);
   CServiceBroker::GetAddonMgr().Events().Subscribe(this, &CPVRClients::OnAddonEvent);
@@ -468,7 +517,7 @@ bool CPVRClients::SupportsTimers() const
 
 bool CPVRClients::GetTimers(CPVRTimersContainer *timers, std::vector<int> &failedClients)
 {
-  return ForCreatedClients(__FUNCTION__, [timers](const CPVRClientPtr &client) {
+  return ForCreatedClientsParallel(__FUNCTION__, [timers](const CPVRClientPtr &client) {
     return client->GetTimers(timers);
   }, failedClients) == PVR_ERROR_NO_ERROR;
 }
@@ -480,11 +529,11 @@ PVR_ERROR CPVRClients::GetTimerTypes(CPVRTimerTypes& results) const
   });
 }
 
-PVR_ERROR CPVRClients::GetRecordings(CPVRRecordings *recordings, bool deleted)
+PVR_ERROR CPVRClients::GetRecordings(CPVRRecordings *recordings, bool deleted, std::vector<int> &failedClients)
 {
-  return ForCreatedClients(__FUNCTION__, [recordings, deleted](const CPVRClientPtr &client) {
+  return ForCreatedClientsParallel(__FUNCTION__, [recordings, deleted](const CPVRClientPtr &client) {
     return client->GetRecordings(recordings, deleted);
-  });
+  }, failedClients);
 }
 
 PVR_ERROR CPVRClients::DeleteAllRecordingsFromTrash()
@@ -496,28 +545,30 @@ PVR_ERROR CPVRClients::DeleteAllRecordingsFromTrash()
 
 PVR_ERROR CPVRClients::SetEPGTimeFrame(int iDays)
 {
-  return ForCreatedClients(__FUNCTION__, [iDays](const CPVRClientPtr &client) {
+  std::vector<int> failedClients;
+  return ForCreatedClientsParallel(__FUNCTION__, [iDays](const CPVRClientPtr &client) {
     return client->SetEPGTimeFrame(iDays);
-  });
+  }, failedClients);
 }
 
 PVR_ERROR CPVRClients::GetChannels(CPVRChannelGroupInternal *group, std::vector<int> &failedClients)
 {
-  return ForCreatedClients(__FUNCTION__, [group](const CPVRClientPtr &client) {
-    return client->GetChannels(*group, group->IsRadio());
+  const bool bRadio = group->IsRadio();
+  return ForCreatedClientsParallel(__FUNCTION__, [group, bRadio](const CPVRClientPtr &client) {
+    return client->GetChannels(*group, bRadio);
   }, failedClients);
 }
 
 PVR_ERROR CPVRClients::GetChannelGroups(CPVRChannelGroups *groups, std::vector<int> &failedClients)
 {
-  return ForCreatedClients(__FUNCTION__, [groups](const CPVRClientPtr &client) {
+  return ForCreatedClientsParallel(__FUNCTION__, [groups](const CPVRClientPtr &client) {
     return client->GetChannelGroups(groups);
   }, failedClients);
 }
 
 PVR_ERROR CPVRClients::GetChannelGroupMembers(CPVRChannelGroup *group, std::vector<int> &failedClients)
 {
-  return ForCreatedClients(__FUNCTION__, [group](const CPVRClientPtr &client) {
+  return ForCreatedClientsParallel(__FUNCTION__, [group](const CPVRClientPtr &client) {
     return client->GetChannelGroupMembers(group);
   }, failedClients);
 }
@@ -670,3 +721,127 @@ PVR_ERROR CPVRClients::ForCreatedClients(const char* strFunctionName, PVRClientF
   }
   return lastError;
 }
+
+PVR_ERROR CPVRClients::ForCreatedClientsParallel(const char* strFunctionName, PVRClientFunction function, std::vector<int> &failedClients) const
+{
+  CPVRClientMap clients;
+  GetCreatedClients(clients, failedClients);
+
+  std::vector<ClientCall> results;
+
+  // a client stuck in a call that timed out before would most likely time out again and tie up another worker
+  std::vector<CPVRClientPtr> skippedClients;
+  {
+    CSingleLock lock(m_outstandingCalls->critSection);
+    for (auto it = clients.begin(); it != clients.end();)
+    {
+      if (m_outstandingCalls->clientIds.count(it->first) > 0)
+      {
+        skippedClients.emplace_back(it->second);
+        failedClients.emplace_back(it->first);
+        it = clients.erase(it);
+      }
+      else
+        ++it;
+    }
+  }
+
+  if (clients.size() == 1)
+  {
+    // nothing to overlap, transfers are added right away
+    ClientCall result;
+    result.iClientId = clients.begin()->first;
+    result.client = clients.begin()->second;
+    result.error = function(result.client);
+    result.bDone = true;
+    results.emplace_back(std::move(result));
+  }
+  else if (!clients.empty())
+  {
+    std::shared_ptr<ClientCalls> calls(new ClientCalls);
+    for (const auto &clientEntry : clients)
+    {
+      ClientCall call;
+      call.iClientId = clientEntry.first;
+      call.client = clientEntry.second;
+      calls->calls.emplace_back(std::move(call));
+    }
+    calls->iPending = calls->calls.size();
+
+    // dedicated workers, a client stuck in its backend must not block other jobs
+    for (size_t i = 0; i < calls->calls.size(); ++i)
+    {
+      std::shared_ptr<OutstandingCall> outstandingCall(new OutstandingCall(m_outstandingCalls, calls->calls[i].iClientId));
+      CJobManager::GetInstance().Submit([calls, i, function, outstandingCall]() mutable {
+        CPVRClient::TransferQueue transfers;
+        CPVRClient::SetTransferQueue(&transfers);
+        const PVR_ERROR error = function(calls->calls[i].client);
+        CPVRClient::SetTransferQueue(nullptr);
+        outstandingCall.reset();
+
+        CSingleLock lock(calls->critSection);
+        ClientCall &call = calls->calls[i];
+        call.error = error;
+        call.transfers = std::move(transfers);
+        call.bDone = true;
+        if (--calls->iPending == 0)
+          calls->doneCondition.notifyAll();
+      }, CJob::PRIORITY_DEDICATED);
+    }
+
+    XbmcThreads::EndTime timeout(g_advancedSettings.m_iPVRClientTimeout);
+    CSingleLock lock(calls->critSection);
+    while (calls->iPending > 0 && !timeout.IsTimePast())
+      calls->doneCondition.wait(lock, timeout.MillisLeft());
+
+    // clients still running keep their slot, whatever they transfer later is never added
+    for (ClientCall &call : calls->calls)
+    {
+      ClientCall result;
+      result.iClientId = call.iClientId;
+      result.client = call.client;
+      result.bDone = call.bDone;
+      if (call.bDone)
+      {
+        result.error = call.error;
+        result.transfers = std::move(call.transfers);
+      }
+      results.emplace_back(std::move(result));
+    }
+  }
+
+  PVR_ERROR lastError = PVR_ERROR_NO_ERROR;
+  for (const auto &client : skippedClients)
+  {
+    CLog::LogFunction(LOGERROR, strFunctionName,
+                      "PVR client '%s' skipped, a previous call did not return yet",
+                      client->GetFriendlyName().c_str());
+    lastError = PVR_ERROR_SERVER_TIMEOUT;
+  }
+
+  for (const ClientCall &result : results)
+  {
+    if (!result.bDone)
+    {
+      CLog::LogFunction(LOGERROR, strFunctionName,
+                        "PVR client '%s' did not return within %d ms",
+                        result.client->GetFriendlyName().c_str(), g_advancedSettings.m_iPVRClientTimeout);
+      lastError = PVR_ERROR_SERVER_TIMEOUT;
+      failedClients.emplace_back(result.iClientId);
+      continue;
+    }
+
+    for (const auto &transfer : result.transfers)
+      transfer();
+
+    if (result.error != PVR_ERROR_NO_ERROR && result.error != PVR_ERROR_NOT_IMPLEMENTED)
+    {
+      CLog::LogFunction(LOGERROR, strFunctionName,
+                        "PVR client '%s' returned an error: %s",
+                        result.client->GetFriendlyName().c_str(), CPVRClient::ToString(result.error));
+      lastError = result.error;
+      failedClients.emplace_back(result.iClientId);
+    }
+  }
+  return lastError;
+}
@@ -10,6 +10,7 @@
 
 #include <functional>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -204,9 +205,10 @@ namespace PVR
      * @brief Get all recordings from clients
      * @param recordings Store the recordings in this container.
      * @param deleted If true, return deleted recordings, return not deleted recordings otherwise.
+     * @param failedClients in case of errors will contain the ids of the clients for which the recordings could not be obtained.
      * @return PVR_ERROR_NO_ERROR if the operation succeeded, the respective PVR_ERROR value otherwise.
      */
-    PVR_ERROR GetRecordings(CPVRRecordings *recordings, bool deleted);
+    PVR_ERROR GetRecordings(CPVRRecordings *recordings, bool deleted, std::vector<int> &failedClients);
 
     /*!
      * @brief Delete all "soft" deleted recordings permanently on the backend.
@@ -355,7 +357,24 @@ namespace PVR
      */
     PVR_ERROR ForCreatedClients(const char* strFunctionName, PVRClientFunction function, std::vector<int> &failedClients) const;
 
+    /*!
+     * @brief Calls all created clients in parallel, so a slow backend doesn't hold up the others. The entries transferred by
+     * the clients are added to their containers on the calling thread, ordered by client id, like calling the clients one by one.
+     * A client that doesn't return within the pvr client timeout counts as failed and the entries it transfers are dropped.
+     * It also counts as failed and isn't called again until its outstanding call returned.
+     * @param strFunctionName The function name, for logging purposes.
+     * @param function The function to call. It has to have return type PVR_ERROR and must take a const reference to a CPVRClientPtr as parameter.
+     * @param failedClients Contains a list of the ids of clients for that the call failed or timed out, if any.
+     * @return PVR_ERROR_NO_ERROR on success, any other PVR_ERROR_* value otherwise.
+     */
+    PVR_ERROR ForCreatedClientsParallel(const char* strFunctionName, PVRClientFunction function, std::vector<int> &failedClients) const;
+
     mutable CCriticalSection m_critSection;
     CPVRClientMap m_clientMap;
+
+    // the clients with a call of ForCreatedClientsParallel() that didn't return yet, shared with the calls
+    struct OutstandingCalls;
+    struct OutstandingCall;
+    std::shared_ptr<OutstandingCalls> m_outstandingCalls;
   };
 }
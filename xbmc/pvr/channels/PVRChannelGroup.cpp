@@ -98,6 +98,41 @@ bool CPVRChannelGroup::operator!=(const CPVRChannelGroup &right) const
 
 PVRChannelGroupMember CPVRChannelGroup::EmptyMember;
 
+namespace
+{
+  template<typename K, typename V>
+  struct SortByKey
+  {
+    bool operator()(const std::pair<K, V> &left, const std::pair<K, V> &right) const
+    {
+      return left.first < right.first;
+    }
+  };
+
+  // the first entry with the given key in a vector sorted by SortByKey
+  template<typename K, typename V>
+  const std::pair<K, V>* FindFirst(const std::vector<std::pair<K, V>> &entries, const K &key)
+  {
+    const auto it = std::lower_bound(entries.begin(), entries.end(), std::make_pair(key, V()), SortByKey<K, V>());
+    return it != entries.end() && it->first == key ? &(*it) : nullptr;
+  }
+}
+
+/*!
+ * @brief Snapshot of the members of a group with sorted vectors to look them up by storage id, channel
+ * number, channel id and epg id. Equal keys keep the order of the members, so the first match is the one
+ * a linear search would have found.
+ */
+struct CPVRChannelGroup::MembersIndex
+{
+  PVR_CHANNEL_GROUP_SORTED_MEMBERS sortedMembers;                                        // copy of m_sortedMembers
+  std::vector<std::pair<std::pair<int, int>, PVRChannelGroupMember>> members;            // copy of m_members
+  std::vector<std::pair<std::pair<int, int>, size_t>> sortedMembersByStorageId;          // positions in sortedMembers
+  std::vector<std::pair<CPVRChannelNumber, size_t>> sortedMembersByChannelNumber;        // positions in sortedMembers
+  std::vector<std::pair<int, size_t>> membersByChannelId;                                // positions in members
+  std::vector<std::pair<int, size_t>> membersByEpgId;                                    // positions in members
+};
+
 void CPVRChannelGroup::OnInit(void)
 {
   CServiceBroker::GetSettings().RegisterCallback(this, {
@@ -141,6 +176,7 @@ void CPVRChannelGroup::Unload(void)
   CSingleLock lock(m_critSection);
   m_sortedMembers.clear();
   m_members.clear();
+  InvalidateMembersIndex();
   m_failedClientsForChannels.clear();
   m_failedClientsForChannelGroupMembers.clear();
 }
@@ -178,6 +214,7 @@ bool CPVRChannelGroup::SetChannelNumber(const CPVRChannelPtr &channel, const CPV
         m_bChanged = true;
         bReturn = true;
         member.channelNumber = channelNumber;
+        InvalidateMembersIndex();
       }
       break;
     }
@@ -298,14 +335,20 @@ void CPVRChannelGroup::SortByClientChannelNumber(void)
 {
   CSingleLock lock(m_critSection);
   if (!PreventSortAndRenumber())
+  {
     sort(m_sortedMembers.begin(), m_sortedMembers.end(), sortByClientChannelNumber());
+    InvalidateMembersIndex();
+  }
 }
 
 void CPVRChannelGroup::SortByChannelNumber(void)
 {
   CSingleLock lock(m_critSection);
   if (!PreventSortAndRenumber())
+  {
     sort(m_sortedMembers.begin(), m_sortedMembers.end(), sortByChannelNumber());
+    InvalidateMembersIndex();
+  }
 }
 
 bool CPVRChannelGroup::UpdateClientPriorities()
@@ -336,9 +379,56 @@ bool CPVRChannelGroup::UpdateClientPriorities()
     member.iClientPriority = iNewPriority;
   }
 
+  if (bChanged)
+    InvalidateMembersIndex();
+
   return bChanged;
 }
 
+void CPVRChannelGroup::InvalidateMembersIndex() const
+{
+  std::atomic_store(&m_membersIndex, std::shared_ptr<const MembersIndex>());
+}
+
+std::shared_ptr<const CPVRChannelGroup::MembersIndex> CPVRChannelGroup::GetMembersIndex() const
+{
+  std::shared_ptr<const MembersIndex> index = std::atomic_load(&m_membersIndex);
+  if (index)
+    return index;
+
+  CSingleLock lock(m_critSection);
+  index = std::atomic_load(&m_membersIndex);
+  if (index)
+    return index;
+
+  std::shared_ptr<MembersIndex> newIndex = std::make_shared<MembersIndex>();
+  newIndex->sortedMembers = m_sortedMembers;
+  newIndex->members.assign(m_members.begin(), m_members.end());
+
+  for (size_t i = 0; i < newIndex->sortedMembers.size(); ++i)
+  {
+    const PVRChannelGroupMember &member = newIndex->sortedMembers[i];
+    newIndex->sortedMembersByStorageId.emplace_back(member.channel->StorageId(), i);
+    newIndex->sortedMembersByChannelNumber.emplace_back(member.channelNumber, i);
+  }
+
+  for (size_t i = 0; i < newIndex->members.size(); ++i)
+  {
+    const CPVRChannelPtr &channel = newIndex->members[i].second.channel;
+    newIndex->membersByChannelId.emplace_back(channel->ChannelID(), i);
+    newIndex->membersByEpgId.emplace_back(channel->EpgID(), i);
+  }
+
+  std::stable_sort(newIndex->sortedMembersByStorageId.begin(), newIndex->sortedMembersByStorageId.end(), SortByKey<std::pair<int, int>, size_t>());
+  std::stable_sort(newIndex->sortedMembersByChannelNumber.begin(), newIndex->sortedMembersByChannelNumber.end(), SortByKey<CPVRChannelNumber, size_t>());
+  std::stable_sort(newIndex->membersByChannelId.begin(), newIndex->membersByChannelId.end(), SortByKey<int, size_t>());
+  std::stable_sort(newIndex->membersByEpgId.begin(), newIndex->membersByEpgId.end(), SortByKey<int, size_t>());
+
+  index = newIndex;
+  std::atomic_store(&m_membersIndex, index);
+  return index;
+}
+
 /********** getters **********/
 PVRChannelGroupMember& CPVRChannelGroup::GetByUniqueID(const std::pair<int, int>& id)
 {
@@ -356,35 +446,49 @@ const PVRChannelGroupMember& CPVRChannelGroup::GetByUniqueID(const std::pair<int
 
 CPVRChannelPtr CPVRChannelGroup::GetByUniqueID(int iUniqueChannelId, int iClientID) const
 {
-  return GetByUniqueID(std::make_pair(iClientID, iUniqueChannelId)).channel;
+  const std::shared_ptr<const MembersIndex> index = GetMembersIndex();
+  const auto entry = FindFirst(index->members, std::make_pair(iClientID, iUniqueChannelId));
+  return entry ? entry->second.channel : CPVRChannelPtr();
 }
 
 CPVRChannelPtr CPVRChannelGroup::GetByChannelID(int iChannelID) const
 {
-  CPVRChannelPtr retval;
-  CSingleLock lock(m_critSection);
+  const std::shared_ptr<const MembersIndex> index = GetMembersIndex();
+  const auto entry = FindFirst(index->membersByChannelId, iChannelID);
+  if (entry && index->members[entry->second].second.channel->ChannelID() == iChannelID)
+    return index->members[entry->second].second.channel;
 
-  for (PVR_CHANNEL_GROUP_MEMBERS::const_iterator it = m_members.begin(); !retval && it != m_members.end(); ++it)
+  // channels get their id when they're persisted, which doesn't invalidate the index
+  for (const auto &member : index->members)
   {
-    if (it->second.channel->ChannelID() == iChannelID)
-      retval = it->second.channel;
+    if (member.second.channel->ChannelID() == iChannelID)
+    {
+      InvalidateMembersIndex();
+      return member.second.channel;
+    }
   }
 
-  return retval;
+  return CPVRChannelPtr();
 }
 
 CPVRChannelPtr CPVRChannelGroup::GetByChannelEpgID(int iEpgID) const
 {
-  CPVRChannelPtr retval;
-  CSingleLock lock(m_critSection);
+  const std::shared_ptr<const MembersIndex> index = GetMembersIndex();
+  const auto entry = FindFirst(index->membersByEpgId, iEpgID);
+  if (entry && index->members[entry->second].second.channel->EpgID() == iEpgID)
+    return index->members[entry->second].second.channel;
 
-  for (PVR_CHANNEL_GROUP_MEMBERS::const_iterator it = m_members.begin(); !retval && it != m_members.end(); ++it)
+  // channels get their epg id when their epg is created, which doesn't invalidate the index
+  for (const auto &member : index->members)
   {
-    if (it->second.channel->EpgID() == iEpgID)
-      retval = it->second.channel;
+    if (member.second.channel->EpgID() == iEpgID)
+    {
+      InvalidateMembersIndex();
+      return member.second.channel;
+    }
   }
 
-  return retval;
+  return CPVRChannelPtr();
 }
 
 CFileItemPtr CPVRChannelGroup::GetLastPlayedChannel(int iCurrentChannel /* = -1 */) const
@@ -409,23 +513,16 @@ CFileItemPtr CPVRChannelGroup::GetLastPlayedChannel(int iCurrentChannel /* = -1
 
 CPVRChannelNumber CPVRChannelGroup::GetChannelNumber(const CPVRChannelPtr &channel) const
 {
-  CSingleLock lock(m_critSection);
-  const PVRChannelGroupMember& member(GetByUniqueID(channel->StorageId()));
-  return member.channelNumber;
+  const std::shared_ptr<const MembersIndex> index = GetMembersIndex();
+  const auto entry = FindFirst(index->members, channel->StorageId());
+  return entry ? entry->second.channelNumber : CPVRChannelGroup::EmptyMember.channelNumber;
 }
 
 CFileItemPtr CPVRChannelGroup::GetByChannelNumber(const CPVRChannelNumber &channelNumber) const
 {
-  CFileItemPtr retval;
-  CSingleLock lock(m_critSection);
-
-  for (PVR_CHANNEL_GROUP_SORTED_MEMBERS::const_iterator it = m_sortedMembers.begin(); !retval && it != m_sortedMembers.end(); ++it)
-  {
-    if ((*it).channelNumber == channelNumber)
-      retval = CFileItemPtr(new CFileItem((*it).channel));
-  }
-
-  return retval;
+  const std::shared_ptr<const MembersIndex> index = GetMembersIndex();
+  const auto entry = FindFirst(index->sortedMembersByChannelNumber, channelNumber);
+  return entry ? CFileItemPtr(new CFileItem(index->sortedMembers[entry->second].channel)) : CFileItemPtr();
 }
 
 CFileItemPtr CPVRChannelGroup::GetNextChannel(const CPVRChannelPtr &channel) const
@@ -434,22 +531,22 @@ CFileItemPtr CPVRChannelGroup::GetNextChannel(const CPVRChannelPtr &channel) con
 
   if (channel)
   {
-    CSingleLock lock(m_critSection);
-    for (PVR_CHANNEL_GROUP_SORTED_MEMBERS::const_iterator it = m_sortedMembers.begin(); !retval && it != m_sortedMembers.end(); ++it)
+    const std::shared_ptr<const MembersIndex> index = GetMembersIndex();
+    const PVR_CHANNEL_GROUP_SORTED_MEMBERS &members = index->sortedMembers;
+    const auto entry = FindFirst(index->sortedMembersByStorageId, channel->StorageId());
+    if (entry && members[entry->second].channel == channel)
     {
-      if ((*it).channel == channel)
+      size_t i = entry->second;
+      do
       {
-        do
-        {
-          if ((++it) == m_sortedMembers.end())
-            it = m_sortedMembers.begin();
-          if ((*it).channel && !(*it).channel->IsHidden())
-            retval = std::make_shared<CFileItem>((*it).channel);
-        } while (!retval && (*it).channel != channel);
-
-        if (!retval)
-          retval = std::make_shared<CFileItem>();
-      }
+        if (++i == members.size())
+          i = 0;
+        if (members[i].channel && !members[i].channel->IsHidden())
+          retval = std::make_shared<CFileItem>(members[i].channel);
+      } while (!retval && members[i].channel != channel);
+
+      if (!retval)
+        retval = std::make_shared<CFileItem>();
     }
   }
 
@@ -462,22 +559,22 @@ CFileItemPtr CPVRChannelGroup::GetPreviousChannel(const CPVRChannelPtr &channel)
 
   if (channel)
   {
-    CSingleLock lock(m_critSection);
-    for (PVR_CHANNEL_GROUP_SORTED_MEMBERS::const_reverse_iterator it = m_sortedMembers.rbegin(); !retval && it != m_sortedMembers.rend(); ++it)
+    const std::shared_ptr<const MembersIndex> index = GetMembersIndex();
+    const PVR_CHANNEL_GROUP_SORTED_MEMBERS &members = index->sortedMembers;
+    const auto entry = FindFirst(index->sortedMembersByStorageId, channel->StorageId());
+    if (entry && members[entry->second].channel == channel)
     {
-      if ((*it).channel == channel)
+      size_t i = entry->second;
+      do
       {
-        do
-        {
-          if ((++it) == m_sortedMembers.rend())
-            it = m_sortedMembers.rbegin();
-          if ((*it).channel && !(*it).channel->IsHidden())
-            retval = std::make_shared<CFileItem>((*it).channel);
-        } while (!retval && (*it).channel != channel);
-
-        if (!retval)
-          retval = std::make_shared<CFileItem>();
-      }
+        if (i-- == 0)
+          i = members.size() - 1;
+        if (members[i].channel && !members[i].channel->IsHidden())
+          retval = std::make_shared<CFileItem>(members[i].channel);
+      } while (!retval && members[i].channel != channel);
+
+      if (!retval)
+        retval = std::make_shared<CFileItem>();
     }
   }
   return retval;
@@ -485,8 +582,7 @@ CFileItemPtr CPVRChannelGroup::GetPreviousChannel(const CPVRChannelPtr &channel)
 
 PVR_CHANNEL_GROUP_SORTED_MEMBERS CPVRChannelGroup::GetMembers(void) const
 {
-  CSingleLock lock(m_critSection);
-  return m_sortedMembers;
+  return GetMembersIndex()->sortedMembers;
 }
 
 int CPVRChannelGroup::GetMembers(CFileItemList &results, bool bGroupMembers /* = true */) const
@@ -616,6 +712,7 @@ std::vector<CPVRChannelPtr> CPVRChannelGroup::RemoveDeletedChannels(const CPVRCh
       m_members.erase(channel->StorageId());
       it = m_sortedMembers.erase(it);
       m_bChanged = true;
+      InvalidateMembersIndex();
     }
     else
     {
@@ -676,6 +773,7 @@ bool CPVRChannelGroup::RemoveFromGroup(const CPVRChannelPtr &channel)
       //! @todo notify observers
       m_members.erase((*it).channel->StorageId());
       it = m_sortedMembers.erase(it);
+      InvalidateMembersIndex();
       bReturn = true;
       m_bChanged = true;
       break;
@@ -717,6 +815,7 @@ bool CPVRChannelGroup::AddToGroup(const CPVRChannelPtr &channel, const CPVRChann
       m_sortedMembers.push_back(newMember);
       m_members.insert(std::make_pair(realChannel.channel->StorageId(), newMember));
       m_bChanged = true;
+      InvalidateMembersIndex();
 
       SortAndRenumber();
 
@@ -730,19 +829,12 @@ bool CPVRChannelGroup::AddToGroup(const CPVRChannelPtr &channel, const CPVRChann
 
 bool CPVRChannelGroup::IsGroupMember(const CPVRChannelPtr &channel) const
 {
-  CSingleLock lock(m_critSection);
-  return m_members.find(channel->StorageId()) != m_members.end();
+  return FindFirst(GetMembersIndex()->members, channel->StorageId()) != nullptr;
 }
 
 bool CPVRChannelGroup::IsGroupMember(int iChannelId) const
 {
-  bool bReturn(false);
-  CSingleLock lock(m_critSection);
-
-  for (PVR_CHANNEL_GROUP_MEMBERS::const_iterator it = m_members.begin(); !bReturn && it != m_members.end(); ++it)
-    bReturn = (iChannelId == it->second.channel->ChannelID());
-
-  return bReturn;
+  return GetByChannelID(iChannelId) != nullptr;
 }
 
 bool CPVRChannelGroup::SetGroupName(const std::string &strGroupName, bool bSaveInDb /* = false */)
@@ -837,6 +929,7 @@ bool CPVRChannelGroup::Renumber(void)
       bReturn = true;
       m_bChanged = true;
       (*it).channelNumber = currentChannelNumber;
+      InvalidateMembersIndex();
     }
   }
 
@@ -933,9 +1026,9 @@ int CPVRChannelGroup::GetEPGNowOrNext(CFileItemList &results, bool bGetNext) con
   int iInitialSize = results.Size();
   CPVREpgInfoTagPtr epgNext;
   CPVRChannelPtr channel;
-  CSingleLock lock(m_critSection);
+  const std::shared_ptr<const MembersIndex> index = GetMembersIndex();
 
-  for (PVR_CHANNEL_GROUP_SORTED_MEMBERS::const_iterator it = m_sortedMembers.begin(); it != m_sortedMembers.end(); ++it)
+  for (PVR_CHANNEL_GROUP_SORTED_MEMBERS::const_iterator it = index->sortedMembers.begin(); it != index->sortedMembers.end(); ++it)
   {
     channel = (*it).channel;
     CPVREpgPtr epg = channel->GetEPG();
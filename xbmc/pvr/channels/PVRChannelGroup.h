@@ -516,6 +516,12 @@ namespace PVR
      */
     bool UpdateClientPriorities();
 
+    /*!
+     * @brief Drop the lookup tables of the members. To be called whenever members are added, removed,
+     * reordered or renumbered, the tables are built again on the next lookup.
+     */
+    void InvalidateMembersIndex() const;
+
     bool             m_bRadio = false;                      /*!< true if this container holds radio channels, false if it holds TV channels */
     int              m_iGroupType = PVR_GROUP_TYPE_DEFAULT;                  /*!< The type of this group */
     int              m_iGroupId = -1;                    /*!< The ID of this group in the database */
@@ -536,6 +542,17 @@ namespace PVR
     std::vector<int> m_failedClientsForChannelGroupMembers;
 
   private:
+    struct MembersIndex;
+
+    /*!
+     * @brief Get the lookup tables of the members, build them if they were invalidated.
+     * They are immutable, so lookups use them without locking the group.
+     * @return The lookup tables.
+     */
+    std::shared_ptr<const MembersIndex> GetMembersIndex() const;
+
+    mutable std::shared_ptr<const MembersIndex> m_membersIndex; /*!< accessed with std::atomic_load and std::atomic_store only */
+
     CDateTime GetEPGDate(EpgDateType epgDateType) const;
     /*!
      * @brief Get all entries that will be active next.
@@ -107,6 +107,7 @@ CPVRChannelPtr CPVRChannelGroupInternal::UpdateFromClient(const CPVRChannelPtr &
     m_sortedMembers.push_back(newMember);
     m_members.insert(std::make_pair(channel->StorageId(), newMember));
     m_bChanged = true;
+    InvalidateMembersIndex();
 
     SortAndRenumber();
   }
@@ -152,6 +153,7 @@ bool CPVRChannelGroupInternal::AddToGroup(const CPVRChannelPtr &channel, const C
   if (groupMember.channelNumber.GetChannelNumber() != iChannelNumber)
   {
     groupMember.channelNumber = CPVRChannelNumber(iChannelNumber, channelNumber.GetSubChannelNumber());
+    InvalidateMembersIndex();
     bSort = true;
   }
 
@@ -549,6 +549,16 @@ int CPVREpg::Get(CFileItemList &results, const CPVREpgSearchFilter &filter) cons
 
 bool CPVREpg::Persist(void)
 {
+  unsigned int iWritten;
+  unsigned int iDeleted;
+  return Persist(iWritten, iDeleted);
+}
+
+bool CPVREpg::Persist(unsigned int &iWritten, unsigned int &iDeleted)
+{
+  iWritten = 0;
+  iDeleted = 0;
+
   if (CServiceBroker::GetSettings().GetBool(CSettings::SETTING_EPG_IGNOREDBFORCLIENT) || !NeedsSave())
     return true;
 
@@ -559,6 +569,12 @@ bool CPVREpg::Persist(void)
     return false;
   }
 
+  std::vector<std::string> values;
+  std::vector<std::pair<CPVREpgInfoTagPtr, int64_t>> writtenHashes;
+  std::vector<int> deletedIds;
+  std::map<int, CPVREpgInfoTagPtr> changedTags;
+  std::map<int, CPVREpgInfoTagPtr> deletedTags;
+
   database->Lock();
 
   {
@@ -570,23 +586,57 @@ bool CPVREpg::Persist(void)
         m_iEpgID = iId;
     }
 
-    for (std::map<int, CPVREpgInfoTagPtr>::iterator it = m_deletedTags.begin(); it != m_deletedTags.end(); ++it)
-      database->Delete(*it->second);
+    for (const auto &tag : m_deletedTags)
+    {
+      /* tag without a database ID was not persisted */
+      if (tag.second->BroadcastId() > 0)
+        deletedIds.emplace_back(tag.second->BroadcastId());
+    }
 
-    for (std::map<int, CPVREpgInfoTagPtr>::iterator it = m_changedTags.begin(); it != m_changedTags.end(); ++it)
-      it->second->Persist(false);
+    /* only write tags whose content differs from what was last persisted */
+    for (const auto &tag : m_changedTags)
+    {
+      if (tag.second->EpgID() <= 0)
+        continue;
+
+      int64_t iContentHash;
+      std::string strValues = database->GetTagValues(*tag.second, iContentHash);
+      if (iContentHash == tag.second->m_iContentHash)
+        continue;
+
+      writtenHashes.emplace_back(tag.second, iContentHash);
+      values.emplace_back(std::move(strValues));
+    }
 
     if (m_bUpdateLastScanTime)
       database->PersistLastEpgScanTime(m_iEpgID, true);
 
-    m_deletedTags.clear();
-    m_changedTags.clear();
+    deletedTags.swap(m_deletedTags);
+    changedTags.swap(m_changedTags);
     m_bChanged            = false;
     m_bTagsChanged        = false;
     m_bUpdateLastScanTime = false;
   }
 
-  bool bRet = database->CommitInsertQueries();
+  /* the table isn't locked while the changes are written */
+  bool bRet = database->PersistTags(values, deletedIds);
+  if (bRet)
+  {
+    iWritten = values.size();
+    iDeleted = deletedIds.size();
+
+    // only what is in the database counts as persisted
+    CSingleLock lock(m_critSection);
+    for (const auto &writtenHash : writtenHashes)
+      writtenHash.first->m_iContentHash = writtenHash.second;
+  }
+  else
+  {
+    // try again with the next persist, changes made in the meantime take precedence
+    CSingleLock lock(m_critSection);
+    m_changedTags.insert(changedTags.begin(), changedTags.end());
+    m_deletedTags.insert(deletedTags.begin(), deletedTags.end());
+  }
 
   database->Unlock();
   return bRet;
@@ -231,6 +231,14 @@ namespace PVR
      */
     bool Persist(void);
 
+    /*!
+     * @brief Persist this table in the database.
+     * @param iWritten The number of tags that were written. Tags that didn't change since they were persisted last are skipped.
+     * @param iDeleted The number of tags that were deleted.
+     * @return True if the table was persisted, false otherwise.
+     */
+    bool Persist(unsigned int &iWritten, unsigned int &iDeleted);
+
     /*!
      * @brief Get the start time of the first entry in this table.
      * @return The first date in UTC.
@@ -333,15 +333,28 @@ bool CPVREpgContainer::PersistAll(void)
   auto copy = m_epgs;
   m_critSection.unlock();
 
+  const unsigned int iStart = XbmcThreads::SystemClockMillis();
+  unsigned int iTables = 0;
+  unsigned int iWrittenTotal = 0;
+  unsigned int iDeletedTotal = 0;
+
   for (EPGMAP::const_iterator it = copy.begin(); it != copy.end() && !m_bStop; ++it)
   {
     CPVREpgPtr epg = it->second;
     if (epg && epg->NeedsSave())
     {
-      bReturn &= epg->Persist();
+      unsigned int iWritten, iDeleted;
+      bReturn &= epg->Persist(iWritten, iDeleted);
+      iWrittenTotal += iWritten;
+      iDeletedTotal += iDeleted;
+      iTables++;
     }
   }
 
+  if (iTables > 0)
+    CLog::LogFC(LOGDEBUG, LOGEPG, "Persisted %u tables, %u tags written and %u deleted in %u ms",
+                iTables, iWrittenTotal, iDeletedTotal, XbmcThreads::SystemClockMillis() - iStart);
+
   return bReturn;
 }
 
@@ -8,6 +8,7 @@
 
 #include "EpgDatabase.h"
 
+#include <algorithm>
 #include <cstdlib>
 
 #include "addons/kodi-addon-dev-kit/include/kodi/xbmc_pvr_types.h"
@@ -21,6 +22,29 @@
 using namespace dbiplus;
 using namespace PVR;
 
+namespace
+{
+  const char* TAG_COLUMNS = "idBroadcast, idEpg, iStartTime, iEndTime, sTitle, sPlotOutline, sPlot, sOriginalTitle, "
+                            "sCast, sDirector, sWriter, iYear, sIMDBNumber, sIconPath, iGenreType, iGenreSubType, sGenre, "
+                            "iFirstAired, iParentalRating, iStarRating, bNotify, iSeriesId, iEpisodeId, iEpisodePart, "
+                            "sEpisodeName, iFlags, iBroadcastUid, iContentHash";
+
+  // length of a multi-row statement, well below the 1,000,000 bytes SQLite accepts by default
+  const size_t MAX_STATEMENT_LENGTH = 500000;
+
+  // 64 bit FNV-1a, the hash is stored in the database so it must not depend on the platform
+  int64_t HashValues(const std::string &strValues)
+  {
+    uint64_t iHash = 14695981039346656037ULL;
+    for (unsigned char c : strValues)
+    {
+      iHash ^= c;
+      iHash *= 1099511628211ULL;
+    }
+    return static_cast<int64_t>(iHash >> 1);
+  }
+}
+
 bool CPVREpgDatabase::Open()
 {
   CSingleLock lock(m_critSection);
@@ -88,7 +112,8 @@ void CPVREpgDatabase::CreateTables(void)
         "iEpisodeId      integer, "
         "iEpisodePart    integer, "
         "sEpisodeName    varchar(128), "
-        "iFlags          integer"
+        "iFlags          integer, "
+        "iContentHash    integer"
       ")"
   );
 
@@ -132,6 +157,9 @@ void CPVREpgDatabase::UpdateTables(int iVersion)
   {
     m_pDS->exec("ALTER TABLE epgtags ADD iFlags integer;");
   }
+
+  if (iVersion < 12)
+    m_pDS->exec("ALTER TABLE epgtags ADD iContentHash integer;");
 }
 
 bool CPVREpgDatabase::DeleteEpg(void)
@@ -272,6 +300,7 @@ std::vector<CPVREpgInfoTagPtr> CPVREpgDatabase::Get(const CPVREpg &epg)
         newTag->m_iSeriesNumber      = m_pDS->fv("iSeriesId").get_asInt();
         newTag->m_strIconPath        = m_pDS->fv("sIconPath").get_asString().c_str();
         newTag->m_iFlags             = m_pDS->fv("iFlags").get_asInt();
+        newTag->m_iContentHash       = m_pDS->fv("iContentHash").get_asInt64();
 
         result.emplace_back(newTag);
 
@@ -354,51 +383,10 @@ int CPVREpgDatabase::Persist(const CPVREpgInfoTag &tag, bool bSingleUpdate /* =
     return iReturn;
   }
 
-  time_t iStartTime, iEndTime, iFirstAired;
-  tag.StartAsUTC().GetAsTime(iStartTime);
-  tag.EndAsUTC().GetAsTime(iEndTime);
-  tag.FirstAiredAsUTC().GetAsTime(iFirstAired);
-
-  int iBroadcastId = tag.BroadcastId();
-  std::string strQuery;
-
-  /* Only store the genre string when needed */
-  std::string strGenre = (tag.GenreType() == EPG_GENRE_USE_STRING) ? tag.DeTokenize(tag.Genre()) : "";
-
   CSingleLock lock(m_critSection);
 
-  if (iBroadcastId < 0)
-  {
-    strQuery = PrepareSQL("REPLACE INTO epgtags (idEpg, iStartTime, "
-        "iEndTime, sTitle, sPlotOutline, sPlot, sOriginalTitle, sCast, sDirector, sWriter, iYear, sIMDBNumber, "
-        "sIconPath, iGenreType, iGenreSubType, sGenre, iFirstAired, iParentalRating, iStarRating, bNotify, iSeriesId, "
-        "iEpisodeId, iEpisodePart, sEpisodeName, iFlags, iBroadcastUid) "
-        "VALUES (%u, %u, %u, '%s', '%s', '%s', '%s', '%s', '%s', '%s', %i, '%s', '%s', %i, %i, '%s', %u, %i, %i, %i, %i, %i, %i, '%s', %i, %i);",
-        tag.EpgID(), static_cast<unsigned int>(iStartTime), static_cast<unsigned int>(iEndTime),
-        tag.Title(true).c_str(), tag.PlotOutline(true).c_str(), tag.Plot(true).c_str(),
-        tag.OriginalTitle(true).c_str(), tag.DeTokenize(tag.Cast()).c_str(), tag.DeTokenize(tag.Directors()).c_str(),
-        tag.DeTokenize(tag.Writers()).c_str(), tag.Year(), tag.IMDBNumber().c_str(),
-        tag.Icon().c_str(), tag.GenreType(), tag.GenreSubType(), strGenre.c_str(),
-        static_cast<unsigned int>(iFirstAired), tag.ParentalRating(), tag.StarRating(), tag.Notify(),
-        tag.SeriesNumber(), tag.EpisodeNumber(), tag.EpisodePart(), tag.EpisodeName(true).c_str(), tag.Flags(),
-        tag.UniqueBroadcastID());
-  }
-  else
-  {
-    strQuery = PrepareSQL("REPLACE INTO epgtags (idEpg, iStartTime, "
-        "iEndTime, sTitle, sPlotOutline, sPlot, sOriginalTitle, sCast, sDirector, sWriter, iYear, sIMDBNumber, "
-        "sIconPath, iGenreType, iGenreSubType, sGenre, iFirstAired, iParentalRating, iStarRating, bNotify, iSeriesId, "
-        "iEpisodeId, iEpisodePart, sEpisodeName, iFlags, iBroadcastUid, idBroadcast) "
-        "VALUES (%u, %u, %u, '%s', '%s', '%s', '%s', '%s', '%s', '%s', %i, '%s', '%s', %i, %i, '%s', %u, %i, %i, %i, %i, %i, %i, '%s', %i, %i, %i);",
-        tag.EpgID(), static_cast<unsigned int>(iStartTime), static_cast<unsigned int>(iEndTime),
-        tag.Title(true).c_str(), tag.PlotOutline(true).c_str(), tag.Plot(true).c_str(),
-        tag.OriginalTitle(true).c_str(), tag.DeTokenize(tag.Cast()).c_str(), tag.DeTokenize(tag.Directors()).c_str(),
-        tag.DeTokenize(tag.Writers()).c_str(), tag.Year(), tag.IMDBNumber().c_str(),
-        tag.Icon().c_str(), tag.GenreType(), tag.GenreSubType(), strGenre.c_str(),
-        static_cast<unsigned int>(iFirstAired), tag.ParentalRating(), tag.StarRating(), tag.Notify(),
-        tag.SeriesNumber(), tag.EpisodeNumber(), tag.EpisodePart(), tag.EpisodeName(true).c_str(), tag.Flags(),
-        tag.UniqueBroadcastID(), iBroadcastId);
-  }
+  int64_t iContentHash;
+  std::string strQuery = StringUtils::Format("REPLACE INTO epgtags (%s) VALUES %s;", TAG_COLUMNS, GetTagValues(tag, iContentHash).c_str());
 
   if (bSingleUpdate)
   {
@@ -414,6 +402,70 @@ int CPVREpgDatabase::Persist(const CPVREpgInfoTag &tag, bool bSingleUpdate /* =
   return iReturn;
 }
 
+std::string CPVREpgDatabase::GetTagValues(const CPVREpgInfoTag &tag, int64_t &iContentHash) const
+{
+  time_t iStartTime, iEndTime, iFirstAired;
+  tag.StartAsUTC().GetAsTime(iStartTime);
+  tag.EndAsUTC().GetAsTime(iEndTime);
+  tag.FirstAiredAsUTC().GetAsTime(iFirstAired);
+
+  /* Only store the genre string when needed */
+  std::string strGenre = (tag.GenreType() == EPG_GENRE_USE_STRING) ? tag.DeTokenize(tag.Genre()) : "";
+
+  const std::string strValues = PrepareSQL("%u, %u, %u, '%s', '%s', '%s', '%s', '%s', '%s', '%s', %i, '%s', '%s', %i, %i, '%s', %u, %i, %i, %i, %i, %i, %i, '%s', %i, %i",
+      tag.EpgID(), static_cast<unsigned int>(iStartTime), static_cast<unsigned int>(iEndTime),
+      tag.Title(true).c_str(), tag.PlotOutline(true).c_str(), tag.Plot(true).c_str(),
+      tag.OriginalTitle(true).c_str(), tag.DeTokenize(tag.Cast()).c_str(), tag.DeTokenize(tag.Directors()).c_str(),
+      tag.DeTokenize(tag.Writers()).c_str(), tag.Year(), tag.IMDBNumber().c_str(),
+      tag.Icon().c_str(), tag.GenreType(), tag.GenreSubType(), strGenre.c_str(),
+      static_cast<unsigned int>(iFirstAired), tag.ParentalRating(), tag.StarRating(), tag.Notify(),
+      tag.SeriesNumber(), tag.EpisodeNumber(), tag.EpisodePart(), tag.EpisodeName(true).c_str(), tag.Flags(),
+      tag.UniqueBroadcastID());
+
+  iContentHash = HashValues(strValues);
+
+  /* a tag without a database ID gets a new one */
+  const std::string strBroadcastId = tag.BroadcastId() < 0 ? "NULL" : StringUtils::Format("%i", tag.BroadcastId());
+
+  return StringUtils::Format("(%s, %s, %lld)", strBroadcastId.c_str(), strValues.c_str(), static_cast<long long>(iContentHash));
+}
+
+bool CPVREpgDatabase::PersistTags(const std::vector<std::string> &values, const std::vector<int> &deletedIds)
+{
+  CSingleLock lock(m_critSection);
+
+  // rows are joined until a statement would get too long, a single longer row gets a statement of its own
+  const auto queueStatements = [this](const std::string &strPrefix, const std::vector<std::string> &rows, const std::string &strSuffix) {
+    std::string strQuery;
+    for (const auto &row : rows)
+    {
+      if (!strQuery.empty() && strQuery.size() + 2 + row.size() + strSuffix.size() > MAX_STATEMENT_LENGTH)
+      {
+        QueueInsertQuery(strQuery + strSuffix);
+        strQuery.clear();
+      }
+
+      if (strQuery.empty())
+        strQuery = strPrefix + row;
+      else
+        strQuery += ", " + row;
+    }
+
+    if (!strQuery.empty())
+      QueueInsertQuery(strQuery + strSuffix);
+  };
+
+  std::vector<std::string> ids;
+  for (int iId : deletedIds)
+    ids.emplace_back(StringUtils::Format("%i", iId));
+  queueStatements("DELETE FROM epgtags WHERE idBroadcast IN (", ids, ");");
+
+  queueStatements(StringUtils::Format("REPLACE INTO epgtags (%s) VALUES ", TAG_COLUMNS), values, ";");
+
+  // always commit, the epg itself may have been queued by Persist()
+  return CommitInsertQueries();
+}
+
 int CPVREpgDatabase::GetLastEPGId(void)
 {
   CSingleLock lock(m_critSection);
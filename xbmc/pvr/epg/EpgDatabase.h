@@ -59,7 +59,7 @@ namespace PVR
      * @brief Get the minimal database version that is required to operate correctly.
      * @return The minimal database version.
      */
-    int GetSchemaVersion(void) const override { return 11; }
+    int GetSchemaVersion(void) const override { return 12; }
 
     /*!
      * @brief Get the default sqlite database filename.
@@ -143,6 +143,22 @@ namespace PVR
      */
     int Persist(const CPVREpgInfoTag &tag, bool bSingleUpdate = true);
 
+    /*!
+     * @brief Get the values of an infotag as they are persisted, for PersistTags().
+     * @param tag The tag.
+     * @param iContentHash The hash of the values, excluding the database ID.
+     * @return The values.
+     */
+    std::string GetTagValues(const CPVREpgInfoTag &tag, int64_t &iContentHash) const;
+
+    /*!
+     * @brief Persist changed and deleted infotags in a single transaction, using multi-row statements.
+     * @param values The values of the changed tags, as returned by GetTagValues().
+     * @param deletedIds The database IDs of the deleted tags.
+     * @return True if the tags were persisted, false otherwise.
+     */
+    bool PersistTags(const std::vector<std::string> &values, const std::vector<int> &deletedIds);
+
     /*!
      * @return Last EPG id in the database
      */
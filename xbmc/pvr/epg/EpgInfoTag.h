@@ -492,6 +492,7 @@ namespace PVR
     bool                     m_bNotify = false;            /*!< notify on start */
     int                      m_iClientId = -1;          /*!< client id */
     int                      m_iBroadcastId = -1;       /*!< database ID */
+    int64_t                  m_iContentHash = 0;       /*!< hash of the content last persisted to the database */
     int                      m_iGenreType = 0;         /*!< genre type */
     int                      m_iGenreSubType = 0;      /*!< genre subtype */
     int                      m_iParentalRating = 0;    /*!< parental rating */
@@ -333,6 +333,22 @@ void CPVRRecording::UpdateMetadata(CVideoDatabase &db)
   m_bGotMetaData = true;
 }
 
+void CPVRRecording::UpdateMetadata(int iPlayCount, const CBookmark &resumePoint)
+{
+  if (m_bGotMetaData)
+    return;
+
+  const CPVRClientPtr client = CServiceBroker::GetPVRManager().GetClient(m_iClientId);
+
+  if (!client || !client->GetClientCapabilities().SupportsRecordingsPlayCount())
+    CVideoInfoTag::SetPlayCount(iPlayCount);
+
+  if ((!client || !client->GetClientCapabilities().SupportsRecordingsLastPlayedPosition()) && resumePoint.IsSet())
+    CVideoInfoTag::SetResumePoint(resumePoint);
+
+  m_bGotMetaData = true;
+}
+
 std::vector<PVR_EDL_ENTRY> CPVRRecording::GetEdl() const
 {
   std::vector<PVR_EDL_ENTRY> edls;
@@ -373,6 +389,17 @@ void CPVRRecording::Update(const CPVRRecording &tag)
   CVideoInfoTag::SetResumePoint(tag.GetLocalResumePoint());
   SetDuration(tag.GetDuration());
 
+  // play count and resume point were overwritten with the client's ones
+  m_bGotMetaData = false;
+
+  Normalize();
+
+  if (m_bIsDeleted)
+    OnDelete();
+}
+
+void CPVRRecording::Normalize(void)
+{
   //Old Method of identifying TV show title and subtitle using m_strDirectory and strPlotOutline (deprecated)
   std::string strShow = StringUtils::Format("%s - ", g_localizeStrings.Get(20364).c_str());
   if (StringUtils::StartsWithNoCase(m_strPlotOutline, strShow))
@@ -390,9 +417,6 @@ void CPVRRecording::Update(const CPVRRecording &tag)
     m_strShowTitle = strEpisode;
   }
 
-  if (m_bIsDeleted)
-    OnDelete();
-
   UpdatePath();
 }
 
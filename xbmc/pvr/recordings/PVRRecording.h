@@ -177,12 +177,31 @@ namespace PVR
      */
     void UpdateMetadata(CVideoDatabase &db);
 
+    /*!
+     * @brief Set the resume point and play count from the database, fetched for many recordings at once,
+     * if the client doesn't handle it itself.
+     * @param iPlayCount The play count stored in the database.
+     * @param resumePoint The resume point stored in the database, an unset bookmark if there is none.
+     */
+    void UpdateMetadata(int iPlayCount, const CBookmark &resumePoint);
+
+    /*!
+     * @brief Whether the resume point and play count were fetched from the database since the last update.
+     */
+    bool HasMetadata() const { return m_bGotMetaData; }
+
     /*!
      * @brief Update this tag with the contents of the given tag.
      * @param tag The new tag info.
      */
     void Update(const CPVRRecording &tag);
 
+    /*!
+     * @brief Derive the title and the episode name from the deprecated plot outline format
+     * and update the path, the same way Update() does.
+     */
+    void Normalize(void);
+
     /*!
      * @brief Retrieve the recording start as UTC time
      * @return the recording start time
@@ -8,7 +8,9 @@
 
 #include "PVRRecordings.h"
 
+#include <algorithm>
 #include <utility>
+#include <vector>
 
 #include "FileItem.h"
 #include "ServiceBroker.h"
@@ -16,6 +18,7 @@
 #include "filesystem/Directory.h"
 #include "settings/Settings.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/log.h"
@@ -30,6 +33,37 @@
 
 using namespace PVR;
 
+namespace
+{
+  // fewer recordings without metadata are looked up one by one
+  const size_t MIN_BULK_METADATA_RECORDINGS = 10;
+
+  // whether the client reported changes of a recording we already have. the id and the
+  // play count and resume point from the video database are ours, not the client's, and
+  // the titles and the path of the stored recording were derived by Update().
+  bool HasChanges(const CPVRRecordingPtr &recording, const CPVRRecordingPtr &tag)
+  {
+    tag->m_iRecordingId = recording->m_iRecordingId;
+    tag->Normalize();
+    if (*recording != *tag || recording->m_genre != tag->m_genre)
+      return true;
+
+    const CPVRClientPtr client = CServiceBroker::GetPVRManager().GetClient(tag->m_iClientId);
+    if (!client)
+      return false;
+
+    if (client->GetClientCapabilities().SupportsRecordingsPlayCount() &&
+        recording->GetLocalPlayCount() != tag->GetLocalPlayCount())
+      return true;
+
+    if (client->GetClientCapabilities().SupportsRecordingsLastPlayedPosition() &&
+        recording->GetLocalResumePoint().timeInSeconds != tag->GetLocalResumePoint().timeInSeconds)
+      return true;
+
+    return false;
+  }
+}
+
 CPVRRecordings::~CPVRRecordings()
 {
   if (m_database && m_database->IsOpen())
@@ -38,10 +72,67 @@ CPVRRecordings::~CPVRRecordings()
 
 void CPVRRecordings::UpdateFromClients(void)
 {
-  CSingleLock lock(m_critSection);
-  Unload();
-  CServiceBroker::GetPVRManager().Clients()->GetRecordings(this, false);
-  CServiceBroker::GetPVRManager().Clients()->GetRecordings(this, true);
+  const unsigned int iStartTime = XbmcThreads::SystemClockMillis();
+
+  {
+    CSingleLock lock(m_critSection);
+    m_syncedRecordings.clear();
+    m_iChangedRecordings = 0;
+  }
+
+  // recordings are added and updated one by one, so the lock isn't held while the clients are busy
+  // and unchanged recordings keep their ids, epg tags and metadata.
+  // each call clears the clients that failed before
+  std::vector<int> failedClients;
+  std::vector<int> failedClientsDeleted;
+  CServiceBroker::GetPVRManager().Clients()->GetRecordings(this, false, failedClients);
+  CServiceBroker::GetPVRManager().Clients()->GetRecordings(this, true, failedClientsDeleted);
+  failedClients.insert(failedClients.end(), failedClientsDeleted.begin(), failedClientsDeleted.end());
+
+  std::vector<CPVRRecordingPtr> removedRecordings;
+  {
+    CSingleLock lock(m_critSection);
+    m_bDeletedTVRecordings = false;
+    m_bDeletedRadioRecordings = false;
+    m_iTVRecordings = 0;
+    m_iRadioRecordings = 0;
+
+    // remove the recordings the clients didn't report anymore, keep those of clients that failed
+    for (PVR_RECORDINGMAP_ITR it = m_recordings.begin(); it != m_recordings.end();)
+    {
+      const CPVRRecordingPtr recording = it->second;
+      if (m_syncedRecordings.find(it->first) == m_syncedRecordings.end() &&
+          std::find(failedClients.begin(), failedClients.end(), recording->m_iClientId) == failedClients.end())
+      {
+        removedRecordings.emplace_back(recording);
+        it = m_recordings.erase(it);
+        continue;
+      }
+
+      if (recording->IsDeleted())
+      {
+        if (recording->IsRadio())
+          m_bDeletedRadioRecordings = true;
+        else
+          m_bDeletedTVRecordings = true;
+      }
+
+      if (recording->IsRadio())
+        ++m_iRadioRecordings;
+      else
+        ++m_iTVRecordings;
+
+      ++it;
+    }
+    m_syncedRecordings.clear();
+
+    CLog::LogFC(LOGDEBUG, LOGPVR, "Updated %d recordings in %d ms, %d added or changed, %d removed",
+                static_cast<int>(m_recordings.size()), XbmcThreads::SystemClockMillis() - iStartTime,
+                m_iChangedRecordings, static_cast<int>(removedRecordings.size()));
+  }
+
+  for (const auto &recording : removedRecordings)
+    recording->OnDelete();
 }
 
 std::string CPVRRecordings::TrimSlashes(const std::string &strOrig) const
@@ -91,8 +182,6 @@ void CPVRRecordings::GetSubDirectories(const CPVRRecordingsPath &recParentPath,
     recChildPath.AppendSegment(strCurrent);
     std::string strFilePath(recChildPath);
 
-    current->UpdateMetadata(GetVideoDatabase());
-
     CFileItemPtr pFileItem;
     if (!results->Contains(strFilePath))
     {
@@ -282,6 +371,8 @@ bool CPVRRecordings::GetDirectory(const std::string& strPath, CFileItemList &ite
   CPVRRecordingsPath recPath(url.GetWithoutOptions());
   if (recPath.IsValid())
   {
+    UpdateMetadata();
+
     // Get the directory structure if in non-flatten mode
     // Deleted view is always flatten. So only for an active view
     std::string strDirectory(recPath.GetUnescapedDirectoryPath());
@@ -299,8 +390,6 @@ bool CPVRRecordings::GetDirectory(const std::string& strPath, CFileItemList &ite
           current->IsRadio() != recPath.IsRadio())
         continue;
 
-      current->UpdateMetadata(GetVideoDatabase());
-
       CFileItemPtr pFileItem(new CFileItem(current));
       pFileItem->m_dateTime = current->RecordingTimeAsLocalTime();
 
@@ -332,14 +421,14 @@ bool CPVRRecordings::GetDirectory(const std::string& strPath, CFileItemList &ite
 void CPVRRecordings::GetAll(CFileItemList &items, bool bDeleted)
 {
   CSingleLock lock(m_critSection);
+  UpdateMetadata();
+
   for (const auto recording : m_recordings)
   {
     CPVRRecordingPtr current = recording.second;
     if (current->IsDeleted() != bDeleted)
       continue;
 
-    current->UpdateMetadata(GetVideoDatabase());
-
     CFileItemPtr pFileItem(new CFileItem(current));
     pFileItem->m_dateTime = current->RecordingTimeAsLocalTime();
     pFileItem->SetOverlayImage(CGUIListItem::ICON_OVERLAY_UNWATCHED, pFileItem->GetPVRRecordingInfoTag()->GetPlayCount() > 0);
@@ -403,18 +492,16 @@ void CPVRRecordings::UpdateFromClient(const CPVRRecordingPtr &tag)
 {
   CSingleLock lock(m_critSection);
 
-  if (tag->IsDeleted())
-  {
-    if (tag->IsRadio())
-      m_bDeletedRadioRecordings = true;
-    else
-      m_bDeletedTVRecordings = true;
-  }
+  m_syncedRecordings.insert(CPVRRecordingUid(tag->m_iClientId, tag->m_strRecordingId));
 
   CPVRRecordingPtr newTag = GetById(tag->m_iClientId, tag->m_strRecordingId);
   if (newTag)
   {
-    newTag->Update(*tag);
+    if (HasChanges(newTag, tag))
+    {
+      newTag->Update(*tag);
+      ++m_iChangedRecordings;
+    }
   }
   else
   {
@@ -432,10 +519,43 @@ void CPVRRecordings::UpdateFromClient(const CPVRRecordingPtr &tag)
     }
     newTag->m_iRecordingId = ++m_iLastId;
     m_recordings.insert(std::make_pair(CPVRRecordingUid(newTag->m_iClientId, newTag->m_strRecordingId), newTag));
-    if (newTag->IsRadio())
-      ++m_iRadioRecordings;
-    else
-      ++m_iTVRecordings;
+    ++m_iChangedRecordings;
+  }
+}
+
+void CPVRRecordings::UpdateMetadata()
+{
+  std::vector<CPVRRecordingPtr> recordings;
+  for (const auto &recording : m_recordings)
+  {
+    if (!recording.second->HasMetadata())
+      recordings.emplace_back(recording.second);
+  }
+
+  if (recordings.empty())
+    return;
+
+  CVideoDatabase &db = GetVideoDatabase();
+  if (!db.IsOpen())
+    return;
+
+  // one query for all recordings instead of two per recording
+  std::map<std::string, int> playCounts;
+  std::map<std::string, CBookmark> resumePoints;
+  if (recordings.size() < MIN_BULK_METADATA_RECORDINGS ||
+      !db.GetPlayCountsAndResumePoints(CPVRRecordingsPath::PATH_RECORDINGS, playCounts, resumePoints))
+  {
+    for (const auto &recording : recordings)
+      recording->UpdateMetadata(db);
+    return;
+  }
+
+  for (const auto &recording : recordings)
+  {
+    const auto playCount = playCounts.find(recording->m_strFileNameAndPath);
+    const auto resumePoint = resumePoints.find(recording->m_strFileNameAndPath);
+    recording->UpdateMetadata(playCount != playCounts.end() ? playCount->second : 0,
+                              resumePoint != resumePoints.end() ? resumePoint->second : CBookmark());
   }
 }
 
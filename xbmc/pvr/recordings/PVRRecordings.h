@@ -10,6 +10,7 @@
 
 #include <map>
 #include <memory>
+#include <set>
 
 #include "FileItem.h"
 #include "video/VideoDatabase.h"
@@ -91,6 +92,8 @@ namespace PVR
     mutable CCriticalSection m_critSection;
     bool m_bIsUpdating = false;
     PVR_RECORDINGMAP m_recordings;
+    std::set<CPVRRecordingUid> m_syncedRecordings; // reported by the clients during the current update
+    unsigned int m_iChangedRecordings = 0; // added or changed during the current update
     unsigned int m_iLastId = 0;
     std::unique_ptr<CVideoDatabase> m_database;
     bool m_bDeletedTVRecordings = false;
@@ -99,6 +102,11 @@ namespace PVR
     unsigned int m_iRadioRecordings = 0;
 
     void UpdateFromClients(void);
+
+    /**
+     * @brief get the resume points and play counts of the recordings that don't have them yet from the video database.
+     */
+    void UpdateMetadata();
     std::string TrimSlashes(const std::string &strOrig) const;
     bool IsDirectoryMember(const std::string &strDirectory, const std::string &strEntryDirectory, bool bGrouped) const;
     void GetSubDirectories(const CPVRRecordingsPath &recParentPath, CFileItemList *results);
@@ -0,0 +1,109 @@
+/*
+ *  Copyright (C) 2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "pvr/timers/PVRTimersSchedule.h"
+#include "pvr/timers/PVRTimerInfoTag.h"
+#include "XBDateTime.h"
+
+#include "gtest/gtest.h"
+
+using namespace PVR;
+
+namespace
+{
+  const int CHANNEL_UID = 1;
+
+  CDateTime At(int hour, int minute)
+  {
+    return CDateTime(2018, 6, 1, hour, minute, 0);
+  }
+
+  void SetSpan(const CPVRTimerInfoTagPtr& timer, CDateTime start, CDateTime end)
+  {
+    timer->SetStartFromUTC(start);
+    timer->SetEndFromUTC(end);
+  }
+
+  CPVRTimerInfoTagPtr CreateTimer(const CDateTime& start, const CDateTime& end)
+  {
+    CPVRTimerInfoTagPtr timer(new CPVRTimerInfoTag);
+    timer->m_iClientChannelUid = CHANNEL_UID;
+    SetSpan(timer, start, end);
+    return timer;
+  }
+}
+
+TEST(TestPVRTimersSchedule, OverlappingEdges)
+{
+  CPVRTimersSchedule schedule;
+  const CPVRTimerInfoTagPtr before = CreateTimer(At(18, 0), At(19, 59));
+  const CPVRTimerInfoTagPtr endsAtStart = CreateTimer(At(19, 0), At(20, 0));
+  const CPVRTimerInfoTagPtr startsAtEnd = CreateTimer(At(21, 0), At(22, 0));
+  const CPVRTimerInfoTagPtr after = CreateTimer(At(21, 1), At(22, 0));
+  schedule.Insert(after);
+  schedule.Insert(startsAtEnd);
+  schedule.Insert(endsAtStart);
+  schedule.Insert(before);
+
+  // a timer touching the span at either edge overlaps it
+  const std::vector<CPVRTimerInfoTagPtr> timers = schedule.GetOverlapping(CHANNEL_UID, At(20, 0), At(21, 0));
+  ASSERT_EQ(2u, timers.size());
+  EXPECT_EQ(endsAtStart, timers[0]);
+  EXPECT_EQ(startsAtEnd, timers[1]);
+
+  EXPECT_TRUE(schedule.GetOverlapping(CHANNEL_UID + 1, At(20, 0), At(21, 0)).empty());
+}
+
+TEST(TestPVRTimersSchedule, OverlappingLongTimer)
+{
+  CPVRTimersSchedule schedule;
+  const CPVRTimerInfoTagPtr longTimer = CreateTimer(At(6, 0), At(23, 0));
+  schedule.Insert(longTimer);
+  for (int hour = 7; hour < 20; ++hour)
+    schedule.Insert(CreateTimer(At(hour, 0), At(hour, 30)));
+
+  // only the long timer reaches the span, it started long before the short ones
+  std::vector<CPVRTimerInfoTagPtr> timers = schedule.GetOverlapping(CHANNEL_UID, At(21, 0), At(22, 0));
+  ASSERT_EQ(1u, timers.size());
+  EXPECT_EQ(longTimer, timers[0]);
+
+  timers = schedule.GetOverlapping(CHANNEL_UID, At(12, 40), At(13, 10));
+  ASSERT_EQ(2u, timers.size());
+  EXPECT_EQ(longTimer, timers[0]);
+  EXPECT_EQ(At(13, 0), timers[1]->StartAsUTC());
+
+  // the span of the short timers applies again once the long one is gone
+  schedule.Erase(longTimer);
+  EXPECT_TRUE(schedule.GetOverlapping(CHANNEL_UID, At(21, 0), At(22, 0)).empty());
+}
+
+TEST(TestPVRTimersSchedule, InsertAfterStartChange)
+{
+  CPVRTimersSchedule schedule;
+  const CPVRTimerInfoTagPtr timer = CreateTimer(At(20, 0), At(21, 0));
+  schedule.Insert(timer);
+
+  // the timer is found by the span it was inserted with until it's inserted again
+  SetSpan(timer, At(22, 0), At(23, 0));
+  EXPECT_EQ(1u, schedule.GetOverlapping(CHANNEL_UID, At(20, 15), At(20, 45)).size());
+
+  schedule.Insert(timer);
+  EXPECT_TRUE(schedule.GetOverlapping(CHANNEL_UID, At(20, 15), At(20, 45)).empty());
+  std::vector<CPVRTimerInfoTagPtr> timers = schedule.GetOverlapping(CHANNEL_UID, At(22, 15), At(22, 45));
+  ASSERT_EQ(1u, timers.size());
+  EXPECT_EQ(timer, timers[0]);
+
+  // erasing uses the indexed span as well, after another change
+  SetSpan(timer, At(8, 0), At(9, 0));
+  schedule.Erase(timer);
+  EXPECT_TRUE(schedule.GetOverlapping(CHANNEL_UID, At(22, 15), At(22, 45)).empty());
+  EXPECT_TRUE(schedule.GetOverlapping(CHANNEL_UID, At(8, 15), At(8, 45)).empty());
+
+  schedule.Insert(timer);
+  EXPECT_EQ(1u, schedule.GetOverlapping(CHANNEL_UID, At(8, 15), At(8, 45)).size());
+}
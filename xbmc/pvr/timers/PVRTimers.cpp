@@ -35,9 +35,12 @@ bool CPVRTimersContainer::UpdateFromClient(const CPVRTimerInfoTagPtr &timer)
   CPVRTimerInfoTagPtr tag = GetByClient(timer->m_iClientId, timer->m_iClientIndex);
   if (!tag)
   {
+    // the timer is indexed by its client ids, so it's inserted once it has them
     tag.reset(new CPVRTimerInfoTag());
     tag->m_iTimerId = ++m_iLastId;
+    bool bReturn = tag->UpdateEntry(timer);
     InsertTimer(tag);
+    return bReturn;
   }
 
   return tag->UpdateEntry(timer);
@@ -46,22 +49,17 @@ bool CPVRTimersContainer::UpdateFromClient(const CPVRTimerInfoTagPtr &timer)
 CPVRTimerInfoTagPtr CPVRTimersContainer::GetByClient(int iClientId, unsigned int iClientTimerId) const
 {
   CSingleLock lock(m_critSection);
-  for (const auto startDates : m_tags)
-  {
-    for (const auto timer : startDates.second)
-    {
-      if (timer->m_iClientId == iClientId && timer->m_iClientIndex == iClientTimerId)
-      {
-        return timer;
-      }
-    }
-  }
+  const auto it = m_clientTimers.find(std::make_pair(iClientId, iClientTimerId));
+  if (it != m_clientTimers.end())
+    return it->second;
 
   return CPVRTimerInfoTagPtr();
 }
 
 void CPVRTimersContainer::InsertTimer(const CPVRTimerInfoTagPtr &newTimer)
 {
+  m_clientTimers[std::make_pair(newTimer->m_iClientId, newTimer->m_iClientIndex)] = newTimer;
+
   auto it = m_tags.find(newTimer->m_bStartAnyTime ? CDateTime() : newTimer->StartAsUTC());
   if (it == m_tags.end())
   {
@@ -110,6 +108,8 @@ void CPVRTimers::Unload()
   // remove all tags
   CSingleLock lock(m_critSection);
   m_tags.clear();
+  m_clientTimers.clear();
+  m_schedule.Clear();
 }
 
 bool CPVRTimers::Update(void)
@@ -196,9 +196,11 @@ bool CPVRTimers::UpdateEntries(const CPVRTimersContainer &timers, const std::vec
         /* if it's present, update the current tag */
         bool bStateChanged(existingTimer->m_state != (*timerIt)->m_state);
         ClearEpgTagTimer(existingTimer);
+        m_schedule.Erase(existingTimer);
         if (existingTimer->UpdateEntry(*timerIt))
         {
           SetEpgTagTimer(existingTimer);
+          m_schedule.Insert(existingTimer);
 
           bChanged = true;
           existingTimer->ResetChildState();
@@ -222,6 +224,7 @@ bool CPVRTimers::UpdateEntries(const CPVRTimersContainer &timers, const std::vec
         newTimer->m_iTimerId = ++m_iLastId;
         SetEpgTagTimer(newTimer);
         InsertTimer(newTimer);
+        m_schedule.Insert(newTimer);
 
         bChanged = true;
         bAddedOrDeleted = true;
@@ -270,6 +273,8 @@ bool CPVRTimers::UpdateEntries(const CPVRTimersContainer &timers, const std::vec
         timerNotifications.push_back(std::make_pair(timer->m_iClientId, timer->GetDeletedNotificationText()));
 
         ClearEpgTagTimer(timer);
+        m_schedule.Erase(timer);
+        m_clientTimers.erase(std::make_pair(timer->m_iClientId, timer->m_iClientIndex));
 
         it2 = it->second.erase(it2);
 
@@ -310,6 +315,7 @@ bool CPVRTimers::UpdateEntries(const CPVRTimersContainer &timers, const std::vec
   {
     SetEpgTagTimer(*timerIt);
     InsertTimer(*timerIt);
+    m_schedule.Insert(*timerIt);
   }
 
   /* update child information for all parent timers */
@@ -748,30 +754,32 @@ CPVRTimerInfoTagPtr CPVRTimers::GetTimerForEpgTag(const CPVREpgInfoTagPtr &epgTa
     {
       CSingleLock lock(m_critSection);
 
-      for (const auto &tagsEntry : m_tags)
+      // the timer the tag is assigned to, whatever its channel
+      const CPVRTimerInfoTagPtr assignedTimer(m_schedule.GetByEpgTag(epgTag));
+      if (assignedTimer)
+        return assignedTimer;
+
+      if (channel->UniqueID() == PVR_CHANNEL_INVALID_UID)
+        return CPVRTimerInfoTagPtr();
+
+      // the timers of the channel during the tag, then the timer of its broadcast
+      for (const auto &timer : m_schedule.GetOverlapping(channel->UniqueID(), epgTag->StartAsUTC(), epgTag->EndAsUTC()))
       {
-        for (const auto &timersEntry : tagsEntry.second)
-        {
-          if (timersEntry->IsTimerRule())
-            continue;
+        if (timer->GetEpgInfoTag(false) == epgTag)
+          return timer;
 
-          if (timersEntry->GetEpgInfoTag(false) == epgTag)
-            return timersEntry;
+        if (timer->UniqueBroadcastID() != EPG_TAG_INVALID_UID &&
+            timer->UniqueBroadcastID() == epgTag->UniqueBroadcastID())
+          return timer;
 
-          if (timersEntry->m_iClientChannelUid != PVR_CHANNEL_INVALID_UID &&
-              timersEntry->m_iClientChannelUid == channel->UniqueID())
-          {
-            if (timersEntry->UniqueBroadcastID() != EPG_TAG_INVALID_UID &&
-                timersEntry->UniqueBroadcastID() == epgTag->UniqueBroadcastID())
-              return timersEntry;
-
-            if (timersEntry->m_bIsRadio == channel->IsRadio() &&
-                timersEntry->StartAsUTC() <= epgTag->StartAsUTC() &&
-                timersEntry->EndAsUTC() >= epgTag->EndAsUTC())
-              return timersEntry;
-          }
-        }
+        if (timer->m_bIsRadio == channel->IsRadio() &&
+            timer->StartAsUTC() <= epgTag->StartAsUTC() &&
+            timer->EndAsUTC() >= epgTag->EndAsUTC())
+          return timer;
       }
+
+      if (epgTag->UniqueBroadcastID() != EPG_TAG_INVALID_UID)
+        return m_schedule.GetByBroadcast(channel->UniqueID(), epgTag->UniqueBroadcastID());
     }
   }
 
@@ -787,19 +795,14 @@ CPVRTimerInfoTagPtr CPVRTimers::GetRecordingTimerForRecording(const CPVRRecordin
 {
   CSingleLock lock(m_critSection);
 
-  for (const auto &tagsEntry : m_tags)
+  for (const auto &timer : m_schedule.GetOverlapping(recording.ChannelUid(), recording.RecordingTimeAsUTC(), recording.EndTimeAsUTC()))
   {
-    for (const auto &timersEntry : tagsEntry.second)
+    if (timer->IsRecording() &&
+        timer->m_iClientId == recording.ClientID() &&
+        timer->StartAsUTC() <= recording.RecordingTimeAsUTC() &&
+        timer->EndAsUTC() >= recording.EndTimeAsUTC())
     {
-      if (timersEntry->IsRecording() &&
-          !timersEntry->IsTimerRule() &&
-          timersEntry->m_iClientId == recording.ClientID() &&
-          timersEntry->m_iClientChannelUid == recording.ChannelUid() &&
-          timersEntry->StartAsUTC() <= recording.RecordingTimeAsUTC() &&
-          timersEntry->EndAsUTC() >= recording.EndTimeAsUTC())
-      {
-        return timersEntry;
-      }
+      return timer;
     }
   }
 
@@ -813,17 +816,7 @@ CPVRTimerInfoTagPtr CPVRTimers::GetTimerRule(const CPVRTimerInfoTagPtr &timer) c
     unsigned int iRuleId = timer->GetTimerRuleId();
     if (iRuleId != PVR_TIMER_NO_PARENT)
     {
-      int iClientId = timer->m_iClientId;
-
-      CSingleLock lock(m_critSection);
-      for (const auto &tagsEntry : m_tags)
-      {
-        for (const auto &timersEntry : tagsEntry.second)
-        {
-          if (timersEntry->m_iClientId == iClientId && timersEntry->m_iClientIndex == iRuleId)
-            return timersEntry;
-        }
-      }
+      return GetByClient(timer->m_iClientId, iRuleId);
     }
   }
   return CPVRTimerInfoTagPtr();
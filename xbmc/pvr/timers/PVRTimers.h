@@ -19,6 +19,7 @@
 #include "pvr/PVRSettings.h"
 #include "pvr/PVRTypes.h"
 #include "pvr/timers/PVRTimerInfoTag.h"
+#include "pvr/timers/PVRTimersSchedule.h"
 
 class CFileItem;
 class CFileItemList;
@@ -62,6 +63,7 @@ namespace PVR
     mutable CCriticalSection m_critSection;
     unsigned int m_iLastId = 0;
     MapTags m_tags;
+    std::map<std::pair<int, unsigned int>, CPVRTimerInfoTagPtr> m_clientTimers; // by client id and client timer id
   };
 
   class CPVRTimers : public CPVRTimersContainer, public Observer
@@ -306,6 +308,7 @@ namespace PVR
 
     bool m_bIsUpdating = false;
     CPVRSettings m_settings;
+    CPVRTimersSchedule m_schedule;
   };
 
   class CPVRTimersPath
@@ -0,0 +1,149 @@
+/*
+ *  Copyright (C) 2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "PVRTimersSchedule.h"
+
+#include "XBDateTime.h"
+
+#include "pvr/timers/PVRTimerInfoTag.h"
+
+using namespace PVR;
+
+void CPVRTimersSchedule::Insert(const CPVRTimerInfoTagPtr &timer)
+{
+  Erase(timer);
+
+  if (timer->IsTimerRule())
+    return;
+
+  Entry entry;
+  timer->StartAsUTC().GetAsTime(entry.start);
+  timer->EndAsUTC().GetAsTime(entry.end);
+  entry.timer = timer;
+
+  const CPVREpgInfoTagPtr epgTag = timer->GetEpgInfoTag(false);
+  const Key key = { timer->m_iClientChannelUid, timer->UniqueBroadcastID(), entry.start, entry.end, epgTag.get() };
+  m_keys[timer.get()] = key;
+
+  Channel &channel = m_channels[key.iClientChannelUid];
+  channel.timers.insert(std::make_pair(entry.start, entry));
+  channel.durations.insert(entry.end - entry.start);
+
+  if (key.iBroadcastUid != EPG_TAG_INVALID_UID)
+    m_broadcasts.insert(std::make_pair(std::make_pair(key.iClientChannelUid, key.iBroadcastUid), entry));
+
+  if (key.epgTag)
+    m_epgTags.insert(std::make_pair(key.epgTag, timer));
+}
+
+void CPVRTimersSchedule::Erase(const CPVRTimerInfoTagPtr &timer)
+{
+  auto it = m_keys.find(timer.get());
+  if (it == m_keys.end())
+    return;
+
+  const Key key = it->second;
+  m_keys.erase(it);
+
+  auto channelIt = m_channels.find(key.iClientChannelUid);
+  if (channelIt != m_channels.end())
+  {
+    Channel &channel = channelIt->second;
+    auto range = channel.timers.equal_range(key.start);
+    for (auto timerIt = range.first; timerIt != range.second; ++timerIt)
+    {
+      if (timerIt->second.timer == timer)
+      {
+        channel.timers.erase(timerIt);
+        channel.durations.erase(channel.durations.find(key.end - key.start));
+        break;
+      }
+    }
+
+    if (channel.timers.empty())
+      m_channels.erase(channelIt);
+  }
+
+  auto range = m_broadcasts.equal_range(std::make_pair(key.iClientChannelUid, key.iBroadcastUid));
+  for (auto broadcastIt = range.first; broadcastIt != range.second;)
+  {
+    if (broadcastIt->second.timer == timer)
+      broadcastIt = m_broadcasts.erase(broadcastIt);
+    else
+      ++broadcastIt;
+  }
+
+  auto epgTags = m_epgTags.equal_range(key.epgTag);
+  for (auto epgTagIt = epgTags.first; epgTagIt != epgTags.second;)
+  {
+    if (epgTagIt->second == timer)
+      epgTagIt = m_epgTags.erase(epgTagIt);
+    else
+      ++epgTagIt;
+  }
+}
+
+void CPVRTimersSchedule::Clear()
+{
+  m_channels.clear();
+  m_broadcasts.clear();
+  m_epgTags.clear();
+  m_keys.clear();
+}
+
+std::vector<CPVRTimerInfoTagPtr> CPVRTimersSchedule::GetOverlapping(int iClientChannelUid, const CDateTime &start, const CDateTime &end) const
+{
+  std::vector<CPVRTimerInfoTagPtr> timers;
+
+  auto it = m_channels.find(iClientChannelUid);
+  if (it != m_channels.end())
+  {
+    time_t spanStart, spanEnd;
+    start.GetAsTime(spanStart);
+    end.GetAsTime(spanEnd);
+
+    // no timer starting before this one is long enough to reach the span
+    const Channel &channel = it->second;
+    const time_t maxDuration = *channel.durations.rbegin();
+    const auto last = channel.timers.upper_bound(spanEnd);
+    for (auto timerIt = channel.timers.lower_bound(spanStart - maxDuration); timerIt != last; ++timerIt)
+    {
+      if (timerIt->second.end >= spanStart)
+        timers.push_back(timerIt->second.timer);
+    }
+  }
+
+  return timers;
+}
+
+CPVRTimerInfoTagPtr CPVRTimersSchedule::GetByBroadcast(int iClientChannelUid, unsigned int iBroadcastUid) const
+{
+  const Entry *first = nullptr;
+
+  auto range = m_broadcasts.equal_range(std::make_pair(iClientChannelUid, iBroadcastUid));
+  for (auto it = range.first; it != range.second; ++it)
+  {
+    if (!first || it->second.start < first->start)
+      first = &it->second;
+  }
+
+  return first ? first->timer : CPVRTimerInfoTagPtr();
+}
+
+CPVRTimerInfoTagPtr CPVRTimersSchedule::GetByEpgTag(const CPVREpgInfoTagPtr &epgTag) const
+{
+  // the tag of a timer may have been replaced since it was inserted
+  auto range = m_epgTags.equal_range(epgTag.get());
+  for (auto it = range.first; it != range.second; ++it)
+  {
+    if (it->second->GetEpgInfoTag(false) == epgTag)
+      return it->second;
+  }
+
+  return CPVRTimerInfoTagPtr();
+}
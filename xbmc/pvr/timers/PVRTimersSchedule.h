@@ -0,0 +1,106 @@
+/*
+ *  Copyright (C) 2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <ctime>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "pvr/PVRTypes.h"
+
+class CDateTime;
+
+namespace PVR
+{
+  /*!
+   * @brief Index of the timers of each channel by their time span.
+   *
+   * Looking up the timer of an EPG tag used to check every timer, for every tag
+   * of the EPG grid. The timers of each channel are kept ordered by their start,
+   * together with their durations. A timer overlapping a span can't start earlier
+   * than the longest duration before the span, so only the timers starting from
+   * there up to the end of the span are checked. Inserting and erasing a timer
+   * is O(log n). Timer rules have no span and aren't indexed.
+   *
+   * The timers are also indexed by the EPG tag assigned to them when they were
+   * inserted, as the tag of a timer doesn't need to be on the timer's channel.
+   */
+  class CPVRTimersSchedule
+  {
+  public:
+    /*!
+     * @brief Add a timer, or index it again after it changed.
+     * @param timer The timer.
+     */
+    void Insert(const CPVRTimerInfoTagPtr &timer);
+
+    /*!
+     * @brief Remove a timer, as indexed before it changed.
+     * @param timer The timer.
+     */
+    void Erase(const CPVRTimerInfoTagPtr &timer);
+
+    void Clear();
+
+    /*!
+     * @brief Get the timers of a channel that overlap the given span.
+     * @param iClientChannelUid The unique id of the channel.
+     * @param start The start of the span.
+     * @param end The end of the span.
+     * @return The timers, ordered by their start.
+     */
+    std::vector<CPVRTimerInfoTagPtr> GetOverlapping(int iClientChannelUid, const CDateTime &start, const CDateTime &end) const;
+
+    /*!
+     * @brief Get the timer for a broadcast.
+     * @param iClientChannelUid The unique id of the channel.
+     * @param iBroadcastUid The unique id of the broadcast.
+     * @return The timer that started first, null if there is none.
+     */
+    CPVRTimerInfoTagPtr GetByBroadcast(int iClientChannelUid, unsigned int iBroadcastUid) const;
+
+    /*!
+     * @brief Get the timer an EPG tag is assigned to.
+     * @param epgTag The EPG tag.
+     * @return The timer that was inserted first, null if there is none.
+     */
+    CPVRTimerInfoTagPtr GetByEpgTag(const CPVREpgInfoTagPtr &epgTag) const;
+
+  private:
+    struct Entry
+    {
+      time_t start;
+      time_t end;
+      CPVRTimerInfoTagPtr timer;
+    };
+
+    struct Channel
+    {
+      std::multimap<time_t, Entry> timers; // by start, in the order they were inserted
+      std::multiset<time_t> durations;
+    };
+
+    struct Key
+    {
+      int iClientChannelUid;
+      unsigned int iBroadcastUid;
+      time_t start;
+      time_t end;
+      const CPVREpgInfoTag *epgTag;
+    };
+
+    std::map<int, Channel> m_channels;
+    std::multimap<std::pair<int, unsigned int>, Entry> m_broadcasts;
+    std::multimap<const CPVREpgInfoTag*, CPVRTimerInfoTagPtr> m_epgTags;
+    std::unordered_map<const CPVRTimerInfoTag*, Key> m_keys; // how each timer was indexed
+  };
+}
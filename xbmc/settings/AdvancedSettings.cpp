@@ -106,6 +106,9 @@ void CAdvancedSettings::Initialize()
   m_limiterHold = 0.025f;
   m_limiterRelease = 0.1f;
 
+  m_audioPrepareNextSeconds = 5;
+  m_audioDecodeBufferSeconds = 2;
+
   m_seekSteps = { 10, 30, 60, 180, 300, 600, 1800 };
 
   m_omxDecodeStartWithValidFrame = true;
@@ -314,6 +317,8 @@ void CAdvancedSettings::Initialize()
   m_curlretries = 2;
   m_curlDisableIPV6 = false;      //Certain hardware/OS combinations have trouble
                                   //with ipv6.
+  m_bDirectoryIndex = false;
+  m_iDirectoryIndexRefresh = 300;
 
 #if defined(TARGET_DARWIN_IOS)
   m_startFullScreen = true;
@@ -325,6 +330,7 @@ void CAdvancedSettings::Initialize()
 
   m_playlistRetries = 100;
   m_playlistTimeout = 20; // 20 seconds timeout
+  m_pythonInvokerPoolSize = 1;
   m_GLRectangleHack = false;
   m_iSkipLoopFilter = 0;
   m_RestrictCapsMask = 0;
@@ -348,6 +354,9 @@ void CAdvancedSettings::Initialize()
   m_bPVRChannelIconsAutoScan       = true;
   m_bPVRAutoScanIconsUserSet       = false;
   m_iPVRNumericChannelSwitchTimeout = 2000;
+  m_iPVRClientTimeout              = 60000;
+  m_iPVRPreTuneChannels            = 0;
+  m_iPVRPreTuneExpiry              = 60;
 
   m_cacheMemSize = 1024 * 1024 * 20;
   m_cacheBufferMode = CACHE_BUFFER_MODE_INTERNET; // Default (buffer all internet streams/filesystems)
@@ -519,6 +528,9 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
 
     XMLUtils::GetFloat(pElement, "limiterhold", m_limiterHold, 0.0f, 100.0f);
     XMLUtils::GetFloat(pElement, "limiterrelease", m_limiterRelease, 0.001f, 100.0f);
+
+    XMLUtils::GetInt(pElement, "preparenextseconds", m_audioPrepareNextSeconds, 5, 60);
+    XMLUtils::GetInt(pElement, "decodebufferseconds", m_audioDecodeBufferSeconds, 2, 10);
   }
 
   pElement = pRootElement->FirstChildElement("omx");
@@ -810,6 +822,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetInt(pElement, "curllowspeedtime", m_curllowspeedtime, 1, 1000);
     XMLUtils::GetInt(pElement, "curlretries", m_curlretries, 0, 10);
     XMLUtils::GetBoolean(pElement,"disableipv6", m_curlDisableIPV6);
+    XMLUtils::GetBoolean(pElement, "directoryindex", m_bDirectoryIndex);
+    XMLUtils::GetInt(pElement, "directoryindexrefresh", m_iDirectoryIndexRefresh, 0, 86400);
   }
 
   pElement = pRootElement->FirstChildElement("cache");
@@ -880,6 +894,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
   XMLUtils::GetInt(pRootElement, "songinfoduration", m_songInfoDuration, 0, INT_MAX);
   XMLUtils::GetInt(pRootElement, "playlistretries", m_playlistRetries, -1, 5000);
   XMLUtils::GetInt(pRootElement, "playlisttimeout", m_playlistTimeout, 0, 5000);
+  XMLUtils::GetInt(pRootElement, "pythoninvokerpoolsize", m_pythonInvokerPoolSize, 1, 16);
 
   XMLUtils::GetBoolean(pRootElement,"glrectanglehack", m_GLRectangleHack);
   XMLUtils::GetInt(pRootElement,"skiploopfilter", m_iSkipLoopFilter, -16, 48);
@@ -1094,6 +1109,9 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetBoolean(pPVR, "channeliconsautoscan", m_bPVRChannelIconsAutoScan);
     XMLUtils::GetBoolean(pPVR, "autoscaniconsuserset", m_bPVRAutoScanIconsUserSet);
     XMLUtils::GetInt(pPVR, "numericchannelswitchtimeout", m_iPVRNumericChannelSwitchTimeout, 50, 60000);
+    XMLUtils::GetInt(pPVR, "clienttimeout", m_iPVRClientTimeout, 1000, 600000);
+    XMLUtils::GetInt(pPVR, "pretunechannels", m_iPVRPreTuneChannels, 0, 8);
+    XMLUtils::GetInt(pPVR, "pretuneexpiry", m_iPVRPreTuneExpiry, 5, 3600);
   }
 
   TiXmlElement* pDatabase = pRootElement->FirstChildElement("videodatabase");
@@ -1401,6 +1419,7 @@ void CAdvancedSettings::SettingOptionsLoggingComponentsFiller(SettingConstPtr se
   list.push_back(std::make_pair(g_localizeStrings.Get(684), LOGWINDOWING));
   list.push_back(std::make_pair(g_localizeStrings.Get(685), LOGPVR));
   list.push_back(std::make_pair(g_localizeStrings.Get(686), LOGEPG));
+  list.push_back(std::make_pair(g_localizeStrings.Get(687), LOGGUI));
 #ifdef HAS_DBUS
   list.push_back(std::make_pair(g_localizeStrings.Get(674), LOGDBUS));
 #endif
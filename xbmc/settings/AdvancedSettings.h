@@ -131,6 +131,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_VideoPlayerIgnoreDTSinWAV;
     float m_limiterHold;
     float m_limiterRelease;
+    int m_audioPrepareNextSeconds; ///< how long before the end of a track PAPlayer opens the next one
+    int m_audioDecodeBufferSeconds; ///< seconds of decoded audio PAPlayer buffers per track
 
     bool  m_omxDecodeStartWithValidFrame;
 
@@ -291,6 +293,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int m_curllowspeedtime;
     int m_curlretries;
     bool m_curlDisableIPV6;
+    bool m_bDirectoryIndex;
+    int m_iDirectoryIndexRefresh; // seconds
 
     bool m_fullScreen;
     bool m_startFullScreen;
@@ -300,6 +304,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_alwaysOnTop;  /* makes xbmc to run always on top .. osx/win32 only .. */
     int m_playlistRetries;
     int m_playlistTimeout;
+    int m_pythonInvokerPoolSize; ///< number of idle reusable script invokers kept alive
     bool m_GLRectangleHack;
     int m_iSkipLoopFilter;
 
@@ -324,6 +329,9 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_bPVRChannelIconsAutoScan; /*!< @brief automatically scan user defined folder for channel icons when loading internal channel groups */
     bool m_bPVRAutoScanIconsUserSet; /*!< @brief mark channel icons populated by auto scan as "user set" */
     int m_iPVRNumericChannelSwitchTimeout; /*!< @brief time in ms before the numeric dialog auto closes when confirmchannelswitch is disabled */
+    int m_iPVRClientTimeout;      /*!< @brief time in ms to wait for a pvr client to return its channels, groups, timers or recordings. defaults to 60000. */
+    int m_iPVRPreTuneChannels;    /*!< @brief number of channels likely to be played next to fetch the stream properties of in advance. defaults to 0 (disabled). */
+    int m_iPVRPreTuneExpiry;      /*!< @brief time in seconds the stream properties fetched in advance are used for. defaults to 60. */
 
     DatabaseSettings m_databaseMusic; // advanced music database setup
     DatabaseSettings m_databaseVideo; // advanced video database setup
@@ -0,0 +1,106 @@
+/*
+ *  Copyright (C) 2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ServiceInitGraph.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+class TestServiceInitGraph : public ::testing::Test
+{
+protected:
+  std::function<bool()> Record(const std::string& name, bool result = true)
+  {
+    return [this, name, result]()
+    {
+      CSingleLock lock(m_critSection);
+      m_order.push_back(name);
+      return result;
+    };
+  }
+
+  bool RanBefore(const std::string& first, const std::string& second)
+  {
+    auto a = std::find(m_order.begin(), m_order.end(), first);
+    auto b = std::find(m_order.begin(), m_order.end(), second);
+    return a != m_order.end() && b != m_order.end() && a < b;
+  }
+
+  bool Ran(const std::string& name)
+  {
+    return std::find(m_order.begin(), m_order.end(), name) != m_order.end();
+  }
+
+  CCriticalSection m_critSection;
+  std::vector<std::string> m_order;
+};
+
+TEST_F(TestServiceInitGraph, DependencyOrder)
+{
+  CServiceInitGraph graph("test");
+  graph.Add("a", Record("a"));
+  graph.Add("b", Record("b"), { "a" });
+  graph.Add("c", Record("c"), { "a" }, true);
+  graph.Add("d", Record("d"), { "b", "c" });
+  graph.Add("e", Record("e"));
+
+  EXPECT_TRUE(graph.Run());
+  EXPECT_EQ(5u, m_order.size());
+  EXPECT_TRUE(RanBefore("a", "b"));
+  EXPECT_TRUE(RanBefore("a", "c"));
+  EXPECT_TRUE(RanBefore("b", "d"));
+  EXPECT_TRUE(RanBefore("c", "d"));
+  EXPECT_TRUE(Ran("e"));
+}
+
+TEST_F(TestServiceInitGraph, CallingThread)
+{
+  CThread* callingThread = CThread::GetCurrentThread();
+  bool sameThread = false;
+
+  CServiceInitGraph graph("test");
+  graph.Add("worker", Record("worker"));
+  graph.Add("main", [&]()
+  {
+    sameThread = CThread::GetCurrentThread() == callingThread;
+    return true;
+  }, {}, true);
+
+  EXPECT_TRUE(graph.Run());
+  EXPECT_TRUE(sameThread);
+}
+
+TEST_F(TestServiceInitGraph, FailureSkipsDependents)
+{
+  CServiceInitGraph graph("test");
+  graph.Add("a", Record("a", false));
+  graph.Add("b", Record("b"), { "a" });
+  graph.Add("c", Record("c"), { "b" });
+  graph.Add("d", Record("d"));
+
+  EXPECT_FALSE(graph.Run());
+  EXPECT_TRUE(Ran("a"));
+  EXPECT_FALSE(Ran("b"));
+  EXPECT_FALSE(Ran("c"));
+  EXPECT_TRUE(Ran("d"));
+}
+
+TEST_F(TestServiceInitGraph, UnknownDependency)
+{
+  CServiceInitGraph graph("test");
+  graph.Add("a", Record("a"), { "missing" });
+
+  EXPECT_FALSE(graph.Run());
+  EXPECT_TRUE(m_order.empty());
+}
@@ -15,6 +15,7 @@
 #include "commons/Exception.h"
 #include <stdlib.h>
 #include "utils/log.h"
+#include "utils/TraceProfiler.h"
 
 #define __STDC_FORMAT_MACROS
 #include <inttypes.h>
@@ -107,6 +108,7 @@ THREADFUNC CThread::staticThread(void* data)
   autodelete = pThread->m_bAutoDelete;
 
   pThread->SetThreadInfo();
+  KODI_TRACE_THREAD_NAME(name);
 
   CLog::Log(LOGDEBUG,"Thread %s start, auto delete: %s", name.c_str(), (autodelete ? "true" : "false"));
 
@@ -131,6 +131,8 @@ typedef enum {
   FieldStereoMode,
   FieldUserRating,
   FieldRelevance, // Used for actors' appearances
+  FieldCamera,
+  FieldLocation,
   FieldMax
 } Field;
 
@@ -13,7 +13,7 @@
 class CJSONVariantParserHandler
 {
 public:
-  explicit CJSONVariantParserHandler(CVariant& parsedObject);
+  CJSONVariantParserHandler(CVariant& parsedObject, const std::function<bool(CVariant&)>* elementCallback = nullptr);
 
   bool Null();
   bool Bool(bool b);
@@ -35,40 +35,33 @@ private:
   bool Primitive(TArgs... args)
   {
     PushObject(CVariant(std::forward<TArgs>(args)...));
-    PopObject();
-
-    return true;
+    return PopObject();
   }
 
-  void PushObject(CVariant variant);
-  void PopObject();
+  // Values are moved into their place in the tree, nothing is copied
+  void PushObject(CVariant&& variant);
+  bool PopObject();
 
   CVariant& m_parsedObject;
   std::vector<CVariant *> m_parse;
   std::string m_key;
 
-  enum class PARSE_STATUS
-  {
-    Variable,
-    Array,
-    Object
-  };
-  PARSE_STATUS m_status;
+  // elements of the top level array are built here instead if they are handed out
+  const std::function<bool(CVariant&)>* m_elementCallback;
+  CVariant m_element;
 };
 
-CJSONVariantParserHandler::CJSONVariantParserHandler(CVariant& parsedObject)
+CJSONVariantParserHandler::CJSONVariantParserHandler(CVariant& parsedObject, const std::function<bool(CVariant&)>* elementCallback /* = nullptr */)
   : m_parsedObject(parsedObject),
     m_parse(),
     m_key(),
-    m_status(PARSE_STATUS::Variable)
+    m_elementCallback(elementCallback)
 { }
 
 bool CJSONVariantParserHandler::Null()
 {
-  PushObject(CVariant::ConstNullVariant);
-  PopObject();
-
-  return true;
+  PushObject(CVariant());
+  return PopObject();
 }
 
 bool CJSONVariantParserHandler::Bool(bool b)
@@ -113,85 +106,78 @@ bool CJSONVariantParserHandler::String(const char* str, rapidjson::SizeType leng
 
 bool CJSONVariantParserHandler::StartObject()
 {
-  PushObject(CVariant::VariantTypeObject);
+  PushObject(CVariant(CVariant::VariantTypeObject));
 
   return true;
 }
 
 bool CJSONVariantParserHandler::Key(const char* str, rapidjson::SizeType length, bool copy)
 {
-  m_key = std::string(str, 0, length);
+  m_key.assign(str, length);
 
   return true;
 }
 
 bool CJSONVariantParserHandler::EndObject(rapidjson::SizeType memberCount)
 {
-  PopObject();
-
-  return true;
+  return PopObject();
 }
 
 bool CJSONVariantParserHandler::StartArray()
 {
-  PushObject(CVariant::VariantTypeArray);
+  PushObject(CVariant(CVariant::VariantTypeArray));
 
   return true;
 }
 
 bool CJSONVariantParserHandler::EndArray(rapidjson::SizeType elementCount)
 {
-  PopObject();
-
-  return true;
+  return PopObject();
 }
 
-void CJSONVariantParserHandler::PushObject(CVariant variant)
+void CJSONVariantParserHandler::PushObject(CVariant&& variant)
 {
-  if (m_status == PARSE_STATUS::Object)
+  CVariant *pushed;
+  if (m_parse.empty())
   {
-    (*m_parse[m_parse.size() - 1])[m_key] = variant;
-    m_parse.push_back(&(*m_parse[m_parse.size() - 1])[m_key]);
+    m_parsedObject = std::move(variant);
+    pushed = &m_parsedObject;
   }
-  else if (m_status == PARSE_STATUS::Array)
+  else
   {
-    CVariant *temp = m_parse[m_parse.size() - 1];
-    temp->push_back(variant);
-    m_parse.push_back(&(*temp)[temp->size() - 1]);
+    CVariant *parent = m_parse.back();
+    if (parent->isObject())
+    {
+      pushed = &(*parent)[m_key];
+      *pushed = std::move(variant);
+    }
+    else if (m_elementCallback != nullptr && m_parse.size() == 1)
+    {
+      m_element = std::move(variant);
+      pushed = &m_element;
+    }
+    else
+    {
+      parent->push_back(std::move(variant));
+      pushed = &(*parent)[parent->size() - 1];
+    }
   }
-  else if (m_parse.empty())
-    m_parse.push_back(new CVariant(variant));
 
-  if (variant.isObject())
-    m_status = PARSE_STATUS::Object;
-  else if (variant.isArray())
-    m_status = PARSE_STATUS::Array;
-  else
-    m_status = PARSE_STATUS::Variable;
+  m_parse.push_back(pushed);
 }
 
-void CJSONVariantParserHandler::PopObject()
+bool CJSONVariantParserHandler::PopObject()
 {
-  CVariant *variant = m_parse[m_parse.size() - 1];
+  CVariant *variant = m_parse.back();
   m_parse.pop_back();
 
-  if (!m_parse.empty())
-  {
-    variant = m_parse[m_parse.size() - 1];
-    if (variant->isObject())
-      m_status = PARSE_STATUS::Object;
-    else if (variant->isArray())
-      m_status = PARSE_STATUS::Array;
-    else
-      m_status = PARSE_STATUS::Variable;
-  }
-  else
-  {
-    m_parsedObject = *variant;
-    delete variant;
+  if (variant != &m_element)
+    return true;
 
-    m_status = PARSE_STATUS::Variable;
-  }
+  bool result = (*m_elementCallback)(m_element);
+  m_element = CVariant();
+
+  return result;
 }
 
 bool CJSONVariantParser::Parse(const char* json, CVariant& data)
@@ -202,9 +188,14 @@ bool CJSONVariantParser::Parse(const char* json, CVariant& data)
   rapidjson::Reader reader;
   rapidjson::StringStream stringStream(json);
 
-  CJSONVariantParserHandler handler(data);
+  // parse into a new value so data stays untouched by invalid JSON
+  CVariant parsedObject;
+  CJSONVariantParserHandler handler(parsedObject);
   if (reader.Parse(stringStream, handler))
+  {
+    data = std::move(parsedObject);
     return true;
+  }
 
   return false;
 }
@@ -213,3 +204,30 @@ bool CJSONVariantParser::Parse(const std::string& json, CVariant& data)
 {
   return Parse(json.c_str(), data);
 }
+
+bool CJSONVariantParser::Parse(const std::string& json, CVariant& data, const std::function<bool(CVariant& element)>& elementCallback)
+{
+  rapidjson::Reader reader;
+
+  // Elements are handed out while parsing, so an array has to be known to be
+  // valid JSON before. The validating pass doesn't build any values.
+  size_t start = json.find_first_not_of(" \t\r\n");
+  if (start != std::string::npos && json[start] == '[')
+  {
+    rapidjson::StringStream stringStream(json.c_str());
+    rapidjson::BaseReaderHandler<> validator;
+    if (!reader.Parse(stringStream, validator))
+      return false;
+  }
+
+  rapidjson::StringStream stringStream(json.c_str());
+  CVariant parsedObject;
+  CJSONVariantParserHandler handler(parsedObject, &elementCallback);
+  if (reader.Parse(stringStream, handler))
+  {
+    data = std::move(parsedObject);
+    return true;
+  }
+
+  return false;
+}
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <functional>
 #include <string>
 
 #include "utils/Variant.h"
@@ -19,4 +20,16 @@ public:
 
   static bool Parse(const char* json, CVariant& data);
   static bool Parse(const std::string& json, CVariant& data);
+
+  /*!
+   \brief Parse JSON and hand out the elements of a top level array one by one
+   Each element is passed to the callback as soon as it's parsed and dropped
+   afterwards, so a large array is never held in memory as a whole. The JSON is
+   checked to be valid before any element is handed out.
+   \param json the JSON to parse
+   \param data the parsed value, an empty array if it's an array
+   \param elementCallback called with each element of a top level array, parsing stops if it returns false
+   \return false if the JSON is invalid or the callback stopped parsing
+   */
+  static bool Parse(const std::string& json, CVariant& data, const std::function<bool(CVariant& element)>& elementCallback);
 };
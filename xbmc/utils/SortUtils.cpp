@@ -404,6 +404,16 @@ std::string ByDateTaken(SortAttribute attributes, const SortItem &values)
   return values.at(FieldDateTaken).asString();
 }
 
+std::string ByCamera(SortAttribute attributes, const SortItem &values)
+{
+  return StringUtils::Format("%s %s", values.at(FieldCamera).asString().c_str(), values.at(FieldDateTaken).asString().c_str());
+}
+
+std::string ByLocation(SortAttribute attributes, const SortItem &values)
+{
+  return values.at(FieldLocation).asString();
+}
+
 std::string ByRelevance(SortAttribute attributes, const SortItem &values)
 {
   return StringUtils::Format("%i", (int)values.at(FieldRelevance).asInteger());
@@ -603,6 +613,8 @@ std::map<SortBy, SortUtils::SortPreparator> fillPreparators()
   preparators[SortByChannel]                  = ByChannel;
   preparators[SortByChannelNumber]            = ByChannelNumber;
   preparators[SortByDateTaken]                = ByDateTaken;
+  preparators[SortByCamera]                   = ByCamera;
+  preparators[SortByLocation]                 = ByLocation;
   preparators[SortByRelevance]                = ByRelevance;
   preparators[SortByInstallDate]              = ByInstallDate;
   preparators[SortByLastUpdated]              = ByLastUpdated;
@@ -688,6 +700,9 @@ std::map<SortBy, Fields> fillSortingFields()
   sortingFields[SortByChannel].insert(FieldChannelName);
   sortingFields[SortByChannelNumber].insert(FieldChannelNumber);
   sortingFields[SortByDateTaken].insert(FieldDateTaken);
+  sortingFields[SortByCamera].insert(FieldCamera);
+  sortingFields[SortByCamera].insert(FieldDateTaken);
+  sortingFields[SortByLocation].insert(FieldLocation);
   sortingFields[SortByRelevance].insert(FieldRelevance);
   sortingFields[SortByInstallDate].insert(FieldInstallDate);
   sortingFields[SortByLastUpdated].insert(FieldLastUpdated);
@@ -948,7 +963,9 @@ const sort_map table[] = {
   { SortByAudioCodec,               SORT_METHOD_NONE,                         SortAttributeNone,          21446 },
   { SortByAudioLanguage,            SORT_METHOD_NONE,                         SortAttributeNone,          21447 },
   { SortBySubtitleLanguage,         SORT_METHOD_NONE,                         SortAttributeNone,          21448 },
-  { SortByRandom,                   SORT_METHOD_NONE,                         SortAttributeNone,          590 }
+  { SortByRandom,                   SORT_METHOD_NONE,                         SortAttributeNone,          590 },
+  { SortByCamera,                   SORT_METHOD_NONE,                         SortAttributeIgnoreFolders, 21822 },
+  { SortByLocation,                 SORT_METHOD_NONE,                         SortAttributeIgnoreFolders, 579 }
 };
 
 SORT_METHOD SortUtils::TranslateOldSortMethod(SortBy sortBy, bool ignoreArticle)
@@ -1077,6 +1094,8 @@ const std::map<std::string, SortBy> sortMethods = {
   { "installdate",      SortByInstallDate },
   { "lastupdated",      SortByLastUpdated },
   { "lastused",         SortByLastUsed },
+  { "camera",           SortByCamera },
+  { "location",         SortByLocation },
 };
 
 SortBy SortUtils::SortMethodFromString(const std::string& sortMethod)
@@ -153,6 +153,10 @@ typedef enum {
   SortByLastUpdated,
   /// __52__ : Sort by last used                  <em>(String: <b><c>lastused</c></b>)</em>
   SortByLastUsed,
+  /// __53__ : Sort by camera                     <em>(String: <b><c>camera</c></b>)</em>
+  SortByCamera,
+  /// __54__ : Sort by location                   <em>(String: <b><c>location</c></b>)</em>
+  SortByLocation,
 } SortBy;
 ///@}
 
@@ -0,0 +1,310 @@
+/*
+ *  Copyright (C) 2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "TraceProfiler.h"
+#include "XBDateTime.h"
+#include "filesystem/File.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+
+#include <chrono>
+#include <inttypes.h>
+#include <thread>
+
+namespace
+{
+
+// events per thread and session, 40 bytes each
+const size_t TRACE_BUFFER_EVENTS = 16384;
+
+std::string EscapeJSON(const char* str)
+{
+  std::string escaped;
+  for (const char* c = str; c != nullptr && *c != '\0'; ++c)
+  {
+    if (*c == '"' || *c == '\\')
+      escaped += '\\';
+    if (static_cast<unsigned char>(*c) < 0x20)
+      escaped += StringUtils::Format("\\u%04x", static_cast<unsigned char>(*c));
+    else
+      escaped += *c;
+  }
+  return escaped;
+}
+
+} // unnamed namespace
+
+// the buffer of a thread is given back when the thread ends
+class CTraceThreadState
+{
+public:
+  ~CTraceThreadState()
+  {
+    if (buffer)
+      buffer->store(false);
+  }
+
+  std::atomic<bool>* buffer = nullptr;
+};
+
+static thread_local void* t_traceBuffer = nullptr;
+static thread_local CTraceThreadState t_traceState;
+static thread_local std::string t_threadName;
+
+CTraceProfiler& CTraceProfiler::GetInstance()
+{
+  static CTraceProfiler s_instance;
+  return s_instance;
+}
+
+bool CTraceProfiler::IsAvailable()
+{
+#if defined(HAS_TRACE_PROFILER)
+  return true;
+#else
+  return false;
+#endif
+}
+
+void CTraceProfiler::Start()
+{
+  m_session++;
+  m_recording = true;
+  CLog::Log(LOGNOTICE, "CTraceProfiler: tracing started");
+}
+
+bool CTraceProfiler::Stop()
+{
+  if (!m_recording.exchange(false))
+    return false;
+
+  CLog::Log(LOGNOTICE, "CTraceProfiler: tracing stopped");
+  return true;
+}
+
+int64_t CTraceProfiler::Now()
+{
+  using namespace std::chrono;
+  static const steady_clock::time_point start = steady_clock::now();
+  return duration_cast<microseconds>(steady_clock::now() - start).count();
+}
+
+void CTraceProfiler::SetThreadName(const std::string& name)
+{
+  t_threadName = name;
+}
+
+CTraceProfiler::ThreadBuffer* CTraceProfiler::GetThreadBuffer()
+{
+  if (t_traceBuffer)
+    return static_cast<ThreadBuffer*>(t_traceBuffer);
+
+  std::unique_lock<std::mutex> lock(m_buffersMutex);
+
+  // take over the buffer of an ended thread, unless it holds events of the current session
+  ThreadBuffer* buffer = nullptr;
+  for (auto& it : m_buffers)
+  {
+    if (!it->inUse && (it->session != m_session || it->count == 0))
+    {
+      buffer = it.get();
+      break;
+    }
+  }
+
+  if (!buffer)
+  {
+    m_buffers.emplace_back(new ThreadBuffer);
+    buffer = m_buffers.back().get();
+    buffer->threadId = static_cast<uint32_t>(m_buffers.size());
+  }
+
+  buffer->inUse = true;
+  buffer->threadName = t_threadName.empty() ? StringUtils::Format("Thread %u", buffer->threadId) : t_threadName;
+  buffer->session = 0;
+
+  t_traceBuffer = buffer;
+  t_traceState.buffer = &buffer->inUse;
+  return buffer;
+}
+
+CTraceProfiler::Event* CTraceProfiler::Reserve(ThreadBuffer*& buffer)
+{
+  buffer = GetThreadBuffer();
+
+  // only the owning thread writes to its buffer, the exporter reads committed events only.
+  // the lock is only contended while the exporter frees the buffer, the event is dropped then.
+  if (buffer->locked.exchange(true, std::memory_order_acquire))
+    return nullptr;
+
+  // recording may have stopped since the caller checked, the buffer may be freed already
+  if (!IsRecording())
+  {
+    buffer->locked.store(false, std::memory_order_release);
+    return nullptr;
+  }
+
+  unsigned int session = m_session.load(std::memory_order_relaxed);
+  if (buffer->session != session)
+  {
+    buffer->count.store(0, std::memory_order_relaxed);
+    buffer->dropped.store(0, std::memory_order_relaxed);
+    if (!buffer->events)
+      buffer->events.reset(new Event[TRACE_BUFFER_EVENTS]);
+    buffer->session = session;
+  }
+
+  size_t count = buffer->count.load(std::memory_order_relaxed);
+  if (count >= TRACE_BUFFER_EVENTS)
+  {
+    buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+    buffer->locked.store(false, std::memory_order_release);
+    return nullptr;
+  }
+
+  return &buffer->events[count];
+}
+
+void CTraceProfiler::Commit(ThreadBuffer* buffer)
+{
+  buffer->count.fetch_add(1, std::memory_order_release);
+  buffer->locked.store(false, std::memory_order_release);
+}
+
+void CTraceProfiler::FreeBuffers()
+{
+  std::unique_lock<std::mutex> lock(m_buffersMutex);
+  for (auto& buffer : m_buffers)
+  {
+    // a thread may still be writing an event it started before recording stopped
+    while (buffer->locked.exchange(true, std::memory_order_acquire))
+      std::this_thread::yield();
+
+    buffer->events.reset();
+    buffer->count.store(0, std::memory_order_relaxed);
+    buffer->dropped.store(0, std::memory_order_relaxed);
+    buffer->session = 0;
+
+    buffer->locked.store(false, std::memory_order_release);
+  }
+}
+
+void CTraceProfiler::AddSpan(const char* category, const char* name, int64_t start, int64_t end)
+{
+  if (!IsRecording())
+    return;
+
+  ThreadBuffer* buffer;
+  Event* event = Reserve(buffer);
+  if (!event)
+    return;
+
+  event->category = category;
+  event->name = name;
+  event->timestamp = start;
+  event->value = end - start;
+  event->counter = false;
+  Commit(buffer);
+}
+
+void CTraceProfiler::AddCounter(const char* category, const char* name, int64_t value)
+{
+  if (!IsRecording())
+    return;
+
+  ThreadBuffer* buffer;
+  Event* event = Reserve(buffer);
+  if (!event)
+    return;
+
+  event->category = category;
+  event->name = name;
+  event->timestamp = Now();
+  event->value = value;
+  event->counter = true;
+  Commit(buffer);
+}
+
+std::string CTraceProfiler::ToJSON()
+{
+  std::string json = "{\"traceEvents\":[";
+  bool first = true;
+  size_t dropped = 0;
+
+  std::unique_lock<std::mutex> lock(m_buffersMutex);
+  const unsigned int session = m_session;
+  for (const auto& buffer : m_buffers)
+  {
+    if (buffer->session != session)
+      continue;
+
+    const size_t count = buffer->count.load(std::memory_order_acquire);
+    if (count == 0)
+      continue;
+    dropped += buffer->dropped.load(std::memory_order_relaxed);
+
+    if (!first)
+      json += ",";
+    first = false;
+    json += StringUtils::Format("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                                buffer->threadId, EscapeJSON(buffer->threadName.c_str()).c_str());
+
+    for (size_t i = 0; i < count; ++i)
+    {
+      const Event& event = buffer->events[i];
+      if (event.counter)
+        json += StringUtils::Format(",{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"C\",\"ts\":%" PRId64 ",\"pid\":1,\"tid\":%u,\"args\":{\"value\":%" PRId64 "}}",
+                                    EscapeJSON(event.name).c_str(), EscapeJSON(event.category).c_str(),
+                                    event.timestamp, buffer->threadId, event.value);
+      else
+        json += StringUtils::Format(",{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%" PRId64 ",\"dur\":%" PRId64 ",\"pid\":1,\"tid\":%u}",
+                                    EscapeJSON(event.name).c_str(), EscapeJSON(event.category).c_str(),
+                                    event.timestamp, event.value, buffer->threadId);
+    }
+  }
+  json += "],\"displayTimeUnit\":\"ms\"}";
+
+  if (dropped > 0)
+    CLog::Log(LOGWARNING, "CTraceProfiler: %zu events were dropped because thread buffers were full", dropped);
+
+  return json;
+}
+
+bool CTraceProfiler::Export(const std::string& path)
+{
+  if (IsRecording())
+  {
+    CLog::Log(LOGERROR, "CTraceProfiler: can't export while tracing is running");
+    return false;
+  }
+
+  const std::string json = ToJSON();
+
+  XFILE::CFile file;
+  if (!file.OpenForWrite(path, true) ||
+      file.Write(json.c_str(), json.size()) != static_cast<ssize_t>(json.size()))
+  {
+    CLog::Log(LOGERROR, "CTraceProfiler: failed to write trace to %s", path.c_str());
+    return false;
+  }
+
+  CLog::Log(LOGNOTICE, "CTraceProfiler: trace written to %s", path.c_str());
+
+  FreeBuffers();
+  return true;
+}
+
+std::string CTraceProfiler::Export()
+{
+  const std::string path = StringUtils::Format("special://temp/kodi-trace-%s.json",
+                                               CDateTime::GetCurrentDateTime().GetAsSaveString().c_str());
+  if (!Export(path))
+    return "";
+
+  return path;
+}
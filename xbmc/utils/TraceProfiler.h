@@ -0,0 +1,167 @@
+/*
+ *  Copyright (C) 2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/*!
+ \brief Low overhead span and counter recorder, exported in the Chrome trace
+ event format (load the file in chrome://tracing or Perfetto).
+
+ Every thread records into its own fixed size buffer, so recording never takes
+ a lock. A buffer is only handed to the exporter when tracing has been stopped.
+ Event names and categories must be string literals, only the pointers are stored.
+
+ Instrumentation is compiled in with the ENABLE_TRACE_PROFILER cmake option,
+ otherwise the KODI_TRACE_* macros expand to nothing.
+ */
+class CTraceProfiler
+{
+public:
+  static CTraceProfiler& GetInstance();
+
+  /*!
+   \brief Whether the instrumentation macros were compiled in.
+   */
+  static bool IsAvailable();
+
+  /*!
+   \brief Discards previously recorded events and starts recording.
+   */
+  void Start();
+
+  /*!
+   \brief Stops recording.
+   \return false if tracing was not running.
+   */
+  bool Stop();
+
+  bool IsRecording() const { return m_recording.load(std::memory_order_relaxed); }
+
+  /*!
+   \brief Writes the events recorded by the last session as Chrome trace JSON
+   and frees the thread buffers.
+   \param path file to write, special:// paths are supported.
+   \return false if tracing is still running or the file can't be written.
+   */
+  bool Export(const std::string& path);
+
+  /*!
+   \brief Writes the events recorded by the last session to a new file in
+   special://temp/, see Export(const std::string&).
+   \return the path of the file, empty on failure.
+   */
+  std::string Export();
+
+  /*!
+   \brief Serializes the events recorded by the last session as Chrome trace JSON.
+   */
+  std::string ToJSON();
+
+  /*!
+   \brief Names the calling thread in exported traces.
+   */
+  static void SetThreadName(const std::string& name);
+
+  /*!
+   \brief Current trace clock in microseconds.
+   */
+  static int64_t Now();
+
+  void AddSpan(const char* category, const char* name, int64_t start, int64_t end);
+  void AddCounter(const char* category, const char* name, int64_t value);
+
+private:
+  CTraceProfiler() = default;
+  CTraceProfiler(const CTraceProfiler&) = delete;
+  CTraceProfiler& operator=(const CTraceProfiler&) = delete;
+
+  struct Event
+  {
+    const char* category;
+    const char* name;
+    int64_t timestamp;
+    int64_t value; // duration of spans, value of counters
+    bool counter;
+  };
+
+  struct ThreadBuffer
+  {
+    std::string threadName;
+    uint32_t threadId;
+    std::atomic<bool> inUse{false};
+    std::atomic<bool> locked{false}; // held while the events are written or freed
+    std::atomic<unsigned int> session{0};
+    std::unique_ptr<Event[]> events;
+    std::atomic<size_t> count{0};
+    std::atomic<size_t> dropped{0};
+  };
+
+  ThreadBuffer* GetThreadBuffer();
+  Event* Reserve(ThreadBuffer*& buffer);
+  void Commit(ThreadBuffer* buffer);
+  void FreeBuffers();
+
+  std::atomic<bool> m_recording{false};
+  std::atomic<unsigned int> m_session{0};
+
+  std::mutex m_buffersMutex;
+  std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+};
+
+/*!
+ \brief Records a span from construction to destruction.
+ */
+class CTraceScope
+{
+public:
+  CTraceScope(const char* category, const char* name)
+    : m_category(category), m_name(name)
+  {
+    if (CTraceProfiler::GetInstance().IsRecording())
+      m_start = CTraceProfiler::Now();
+  }
+
+  ~CTraceScope()
+  {
+    if (m_start >= 0)
+      CTraceProfiler::GetInstance().AddSpan(m_category, m_name, m_start, CTraceProfiler::Now());
+  }
+
+private:
+  CTraceScope(const CTraceScope&) = delete;
+  CTraceScope& operator=(const CTraceScope&) = delete;
+
+  const char* m_category;
+  const char* m_name;
+  int64_t m_start = -1;
+};
+
+#define KODI_TRACE_CONCAT_IMPL(a, b) a##b
+#define KODI_TRACE_CONCAT(a, b) KODI_TRACE_CONCAT_IMPL(a, b)
+
+#if defined(HAS_TRACE_PROFILER)
+#define KODI_TRACE_SCOPE(category, name) \
+  CTraceScope KODI_TRACE_CONCAT(traceScope, __LINE__)(category, name)
+#define KODI_TRACE_COUNTER(category, name, value) \
+  do { \
+    if (CTraceProfiler::GetInstance().IsRecording()) \
+      CTraceProfiler::GetInstance().AddCounter(category, name, static_cast<int64_t>(value)); \
+  } while (0)
+#define KODI_TRACE_THREAD_NAME(name) CTraceProfiler::SetThreadName(name)
+#else
+#define KODI_TRACE_SCOPE(category, name) do { } while (0)
+#define KODI_TRACE_COUNTER(category, name, value) do { } while (0)
+#define KODI_TRACE_THREAD_NAME(name) do { } while (0)
+#endif
@@ -7,10 +7,29 @@
  */
 
 #include "utils/JSONVariantParser.h"
+#include "utils/StringUtils.h"
 #include "utils/Variant.h"
 
+#include <string>
+#include <vector>
+
 #include "gtest/gtest.h"
 
+namespace
+{
+  // A Playlist.Add call of the given number of files, as sent by remotes
+  std::string GetPlaylistAddRequest(int items)
+  {
+    std::vector<std::string> files;
+    for (int i = 0; i < items; i++)
+      files.push_back("{ \"file\": \"smb://server/music/artist " + std::to_string(i / 12) + "/album/" +
+                      StringUtils::Format("%02i", i % 12) + " - track with a longer title.flac\" }");
+
+    return "{ \"jsonrpc\": \"2.0\", \"method\": \"Playlist.Add\", \"id\": 1, "
+           "\"params\": { \"playlistid\": 0, \"item\": [ " + StringUtils::Join(files, ", ") + " ] } }";
+  }
+}
+
 TEST(TestJSONVariantParser, CannotParseNullptr)
 {
   CVariant variant;
@@ -187,3 +206,97 @@ TEST(TestJSONVariantParser, CanParseArray)
   ASSERT_TRUE(variant[0]["foo"].isString());
   ASSERT_STREQ("bar", variant[0]["foo"].asString().c_str());
 }
+
+TEST(TestJSONVariantParser, LeavesDataUntouchedOnError)
+{
+  CVariant variant("foo");
+  ASSERT_FALSE(CJSONVariantParser::Parse("{ \"foo\": [ true, ", variant));
+  ASSERT_TRUE(variant.isString());
+  ASSERT_STREQ("foo", variant.asString().c_str());
+}
+
+TEST(TestJSONVariantParser, CanParseArrayElementByElement)
+{
+  CVariant variant;
+  std::vector<CVariant> elements;
+  auto collect = [&elements](CVariant& element)
+  {
+    elements.push_back(element);
+    return true;
+  };
+
+  ASSERT_TRUE(CJSONVariantParser::Parse("[ true, { \"foo\": [ \"bar\", 1 ] }, [ null ] ]", variant, collect));
+  ASSERT_TRUE(variant.isArray());
+  ASSERT_TRUE(variant.empty());
+  ASSERT_EQ(3U, elements.size());
+  ASSERT_TRUE(elements[0].isBoolean());
+  ASSERT_TRUE(elements[1].isObject());
+  ASSERT_EQ(2U, elements[1]["foo"].size());
+  ASSERT_STREQ("bar", elements[1]["foo"][0].asString().c_str());
+  ASSERT_EQ(1U, elements[1]["foo"][1].asUnsignedInteger());
+  ASSERT_TRUE(elements[2].isArray());
+  ASSERT_TRUE(elements[2][0].isNull());
+
+  // values that aren't arrays are parsed as a whole
+  elements.clear();
+  ASSERT_TRUE(CJSONVariantParser::Parse("{ \"foo\": [ 1, 2 ] }", variant, collect));
+  ASSERT_TRUE(elements.empty());
+  ASSERT_TRUE(variant.isObject());
+  ASSERT_EQ(2U, variant["foo"].size());
+}
+
+TEST(TestJSONVariantParser, HandsOutNoElementsOfInvalidJson)
+{
+  CVariant variant;
+  unsigned int elements = 0;
+  auto count = [&elements](CVariant& element)
+  {
+    elements++;
+    return true;
+  };
+
+  ASSERT_FALSE(CJSONVariantParser::Parse("[ true, false, ", variant, count));
+  ASSERT_FALSE(CJSONVariantParser::Parse("[ true, false ] ]", variant, count));
+  ASSERT_EQ(0U, elements);
+}
+
+TEST(TestJSONVariantParser, CallbackCanStopParsing)
+{
+  CVariant variant;
+  unsigned int elements = 0;
+  auto stopAtSecond = [&elements](CVariant& element)
+  {
+    return ++elements < 2;
+  };
+
+  ASSERT_FALSE(CJSONVariantParser::Parse("[ 1, 2, 3 ]", variant, stopAtSecond));
+  ASSERT_EQ(2U, elements);
+}
+
+TEST(TestJSONVariantParser, ParseLargeRequests)
+{
+  const int items = 5000;
+  const std::string request = GetPlaylistAddRequest(items);
+
+  CVariant variant;
+  ASSERT_TRUE(CJSONVariantParser::Parse(request, variant));
+  ASSERT_EQ(static_cast<unsigned int>(items), variant["params"]["item"].size());
+  ASSERT_STREQ("smb://server/music/artist 416/album/07 - track with a longer title.flac",
+               variant["params"]["item"][items - 1]["file"].asString().c_str());
+
+  // the same files as a batch of single calls, handled one by one
+  std::vector<std::string> calls;
+  for (int i = 0; i < items; i++)
+    calls.push_back("{ \"jsonrpc\": \"2.0\", \"method\": \"Playlist.Add\", \"id\": " + std::to_string(i) + ", "
+                    "\"params\": { \"playlistid\": 0, \"item\": { \"file\": \"smb://server/" + std::to_string(i) + ".flac\" } } }");
+  const std::string batch = "[ " + StringUtils::Join(calls, ", ") + " ]";
+
+  unsigned int handled = 0;
+  auto handle = [&handled](CVariant& call)
+  {
+    handled += call["params"]["item"]["file"].isString() ? 1 : 0;
+    return true;
+  };
+  ASSERT_TRUE(CJSONVariantParser::Parse(batch, variant, handle));
+  ASSERT_EQ(static_cast<unsigned int>(items), handled);
+}
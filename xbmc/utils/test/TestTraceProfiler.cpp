@@ -0,0 +1,100 @@
+/*
+ *  Copyright (C) 2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "utils/TraceProfiler.h"
+#include "filesystem/File.h"
+#include "test/TestUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <thread>
+
+TEST(TestTraceProfiler, NotRecording)
+{
+  CTraceProfiler& profiler = CTraceProfiler::GetInstance();
+  EXPECT_FALSE(profiler.IsRecording());
+  EXPECT_FALSE(profiler.Stop());
+
+  {
+    CTraceScope scope("test", "NotRecordedSpan");
+  }
+  EXPECT_EQ(std::string::npos, profiler.ToJSON().find("NotRecordedSpan"));
+}
+
+TEST(TestTraceProfiler, RecordSpansAndCounters)
+{
+  CTraceProfiler& profiler = CTraceProfiler::GetInstance();
+  profiler.Start();
+  EXPECT_TRUE(profiler.IsRecording());
+
+  {
+    CTraceScope scope("test", "RecordedSpan");
+  }
+  profiler.AddCounter("test", "RecordedCounter", 42);
+
+  std::thread worker([]()
+  {
+    CTraceProfiler::SetThreadName("TraceWorker");
+    CTraceScope scope("test", "WorkerSpan");
+  });
+  worker.join();
+
+  EXPECT_TRUE(profiler.Stop());
+  EXPECT_FALSE(profiler.IsRecording());
+
+  const std::string json = profiler.ToJSON();
+  EXPECT_EQ(0u, json.find("{\"traceEvents\":["));
+  EXPECT_NE(std::string::npos, json.find("\"name\":\"RecordedSpan\",\"cat\":\"test\",\"ph\":\"X\""));
+  EXPECT_NE(std::string::npos, json.find("\"name\":\"RecordedCounter\",\"cat\":\"test\",\"ph\":\"C\""));
+  EXPECT_NE(std::string::npos, json.find("\"args\":{\"value\":42}"));
+  EXPECT_NE(std::string::npos, json.find("\"name\":\"WorkerSpan\""));
+  EXPECT_NE(std::string::npos, json.find("\"args\":{\"name\":\"TraceWorker\"}"));
+
+  // spans recorded after stopping are not part of the trace
+  {
+    CTraceScope scope("test", "LateSpan");
+  }
+  EXPECT_EQ(std::string::npos, profiler.ToJSON().find("LateSpan"));
+}
+
+TEST(TestTraceProfiler, NewSessionDiscardsEvents)
+{
+  CTraceProfiler& profiler = CTraceProfiler::GetInstance();
+  profiler.Start();
+  {
+    CTraceScope scope("test", "FirstSessionSpan");
+  }
+  profiler.Stop();
+
+  profiler.Start();
+  {
+    CTraceScope scope("test", "SecondSessionSpan");
+  }
+  profiler.Stop();
+
+  const std::string json = profiler.ToJSON();
+  EXPECT_EQ(std::string::npos, json.find("FirstSessionSpan"));
+  EXPECT_NE(std::string::npos, json.find("SecondSessionSpan"));
+}
+
+TEST(TestTraceProfiler, ExportFreesBuffers)
+{
+  CTraceProfiler& profiler = CTraceProfiler::GetInstance();
+  profiler.Start();
+  {
+    CTraceScope scope("test", "ExportedSpan");
+  }
+  profiler.Stop();
+
+  XFILE::CFile *file = XBMC_CREATETEMPFILE(".json");
+  ASSERT_NE(nullptr, file);
+  const std::string path = XBMC_TEMPFILEPATH(file);
+  EXPECT_TRUE(profiler.Export(path));
+  EXPECT_EQ(std::string::npos, profiler.ToJSON().find("ExportedSpan"));
+  XBMC_DELETETEMPFILE(file);
+}
@@ -5381,6 +5381,56 @@ bool CVideoDatabase::GetPlayCounts(const std::string &strPath, CFileItemList &it
   return false;
 }
 
+bool CVideoDatabase::GetPlayCountsAndResumePoints(const std::string &strPathPrefix, std::map<std::string, int> &playCounts, std::map<std::string, CBookmark> &resumePoints)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    std::string sql = PrepareSQL(
+      "SELECT"
+      "  path.strPath, files.strFilename, files.playCount,"
+      "  bookmark.timeInSeconds, bookmark.totalTimeInSeconds, bookmark.playerState, bookmark.player "
+      "FROM files"
+      "  JOIN path ON"
+      "    files.idPath = path.idPath"
+      "  LEFT JOIN bookmark ON"
+      "    files.idFile = bookmark.idFile AND bookmark.type = %i"
+      "  WHERE path.strPath LIKE '%s%%'", (int)CBookmark::RESUME, strPathPrefix.c_str());
+
+    if (!m_pDS->query(sql))
+      return false;
+
+    while (!m_pDS->eof())
+    {
+      std::string path;
+      ConstructPath(path, m_pDS->fv(0).get_asString(), m_pDS->fv(1).get_asString());
+      playCounts[path] = m_pDS->fv(2).get_asInt();
+
+      if (!m_pDS->fv(3).get_isNull())
+      {
+        CBookmark bookmark;
+        bookmark.timeInSeconds = m_pDS->fv(3).get_asDouble();
+        bookmark.totalTimeInSeconds = m_pDS->fv(4).get_asDouble();
+        bookmark.playerState = m_pDS->fv(5).get_asString();
+        bookmark.player = m_pDS->fv(6).get_asString();
+        bookmark.type = CBookmark::RESUME;
+        resumePoints[path] = bookmark;
+      }
+      m_pDS->next();
+    }
+    m_pDS->close();
+
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s (%s) failed", __FUNCTION__, strPathPrefix.c_str());
+  }
+  return false;
+}
+
 int CVideoDatabase::GetPlayCount(int iFileId)
 {
   if (iFileId < 0)
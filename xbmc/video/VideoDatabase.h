@@ -471,6 +471,15 @@ public:
    */
   bool GetPlayCounts(const std::string &path, CFileItemList &items);
 
+  /*! \brief Get the playcounts and resume points of all files below a path in a single query
+   Files that aren't in the database are left out, files without a resume point have no entry in resumePoints.
+   \param strPathPrefix the path the files are below
+   \param playCounts the playcounts, keyed by the full path of the files
+   \param resumePoints the resume points, keyed by the full path of the files
+   \sa GetPlayCounts, GetResumeBookMark
+   */
+  bool GetPlayCountsAndResumePoints(const std::string &strPathPrefix, std::map<std::string, int> &playCounts, std::map<std::string, CBookmark> &resumePoints);
+
   void UpdateMovieTitle(int idMovie, const std::string& strNewMovieTitle, VIDEODB_CONTENT_TYPE iType=VIDEODB_CONTENT_MOVIES);
   bool UpdateVideoSortTitle(int idDb, const std::string& strNewSortTitle, VIDEODB_CONTENT_TYPE iType = VIDEODB_CONTENT_MOVIES);
 
@@ -8,6 +8,7 @@
 
 #include "VideoInfoScanner.h"
 
+#include <deque>
 #include <utility>
 
 #include "ServiceBroker.h"
@@ -34,11 +35,14 @@
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "TextureCache.h"
+#include "threads/Condition.h"
+#include "threads/SingleLock.h"
 #include "threads/SystemClock.h"
 #include "URL.h"
 #include "Util.h"
 #include "utils/Digest.h"
 #include "utils/FileExtensionProvider.h"
+#include "utils/JobManager.h"
 #include "utils/log.h"
 #include "utils/RegExp.h"
 #include "utils/StringUtils.h"
@@ -56,6 +60,33 @@ using namespace KODI::MESSAGING;
 using KODI::MESSAGING::HELPERS::DialogResponse;
 using KODI::UTILITY::CDigest;
 
+namespace
+{
+  // number of jobs walking folders along with the scanner thread
+  const unsigned int MAX_FOLDER_WALKERS = 8;
+
+  int64_t GetFolderTime(const std::string &folder)
+  {
+    struct __stat64 buffer;
+    if (CFile::Stat(folder, &buffer) != 0)
+      return 0;
+
+    return buffer.st_mtime ? buffer.st_mtime : buffer.st_ctime;
+  }
+
+  struct FolderWalk
+  {
+    CCriticalSection critSection;
+    XbmcThreads::ConditionVariable changed;
+    std::deque<std::pair<size_t, std::string>> pending; // index of the walked folder, folder to stat
+    std::vector<int64_t> times;
+    std::vector<bool> failed;
+    unsigned int active = 0; // folders being stat'ed outside the lock
+    unsigned int walked = 0;
+    bool finished = false; // the scanner returned, late jobs must not touch it anymore
+  };
+}
+
 namespace VIDEO
 {
 
@@ -63,6 +94,8 @@ namespace VIDEO
   {
     m_bStop = false;
     m_scanAll = false;
+    m_walkedFolders = 0;
+    m_walkTime = 0;
   }
 
   CVideoInfoScanner::~CVideoInfoScanner()
@@ -98,6 +131,8 @@ namespace VIDEO
       }
 
       unsigned int tick = XbmcThreads::SystemClockMillis();
+      m_walkedFolders = 0;
+      m_walkTime = 0;
 
       m_database.Open();
 
@@ -156,12 +191,16 @@ namespace VIDEO
 
       tick = XbmcThreads::SystemClockMillis() - tick;
       CLog::Log(LOGNOTICE, "VideoInfoScanner: Finished scan. Scanning for video info took %s", StringUtils::SecondsToTimeString(tick / 1000).c_str());
+      CLog::Log(LOGDEBUG, "VideoInfoScanner: Stat'ing %u folders for their fast hashes took %u ms", m_walkedFolders, m_walkTime);
     }
     catch (...)
     {
       CLog::Log(LOGERROR, "VideoInfoScanner: Exception while scanning.");
     }
 
+    m_folderTimes.clear();
+    m_recursiveFolderTimes.clear();
+
     m_bRunning = false;
     ANNOUNCEMENT::CAnnouncementManager::GetInstance().Announce(ANNOUNCEMENT::VideoLibrary, "xbmc", "OnScanFinished");
 
@@ -347,6 +386,9 @@ namespace VIDEO
 
     if (!bSkip)
     {
+      if (content == CONTENT_TVSHOWS)
+        PrefetchFolderTimes(items, regexps, true);
+
       if (RetrieveVideoInfo(items, settings.parent_name_root, content))
       {
         if (!m_bStop && (content == CONTENT_MOVIES || content == CONTENT_MUSICVIDEOS))
@@ -372,6 +414,9 @@ namespace VIDEO
     if (m_handle)
       OnDirectoryScanned(strDirectory);
 
+    if (settings.recurse > 0 && content != CONTENT_TVSHOWS)
+      PrefetchFolderTimes(items, regexps, false);
+
     for (int i = 0; i < items.Size(); ++i)
     {
       CFileItemPtr pItem = items[i];
@@ -1856,63 +1901,170 @@ namespace VIDEO
   }
 
   std::string CVideoInfoScanner::GetFastHash(const std::string &directory,
-      const std::vector<std::string> &excludes) const
+      const std::vector<std::string> &excludes)
   {
     CDigest digest{CDigest::Type::MD5};
 
     if (excludes.size())
       digest.Update(StringUtils::Join(excludes, "|"));
 
-    struct __stat64 buffer;
-    if (XFILE::CFile::Stat(directory, &buffer) == 0)
+    int64_t time;
+    auto it = m_folderTimes.find(directory);
+    if (it != m_folderTimes.end())
     {
-      int64_t time = buffer.st_mtime;
-      if (!time)
-        time = buffer.st_ctime;
-      if (time)
-      {
-        digest.Update((unsigned char *)&time, sizeof(time));
-        return digest.Finalize();
-      }
+      time = it->second;
+      m_folderTimes.erase(it);
+    }
+    else
+      time = GetFolderTime(directory);
+
+    if (time)
+    {
+      digest.Update((unsigned char *)&time, sizeof(time));
+      return digest.Finalize();
     }
     return "";
   }
 
   std::string CVideoInfoScanner::GetRecursiveFastHash(const std::string &directory,
-      const std::vector<std::string> &excludes) const
+      const std::vector<std::string> &excludes)
   {
-    CFileItemList items;
-    items.Add(CFileItemPtr(new CFileItem(directory, true)));
-    CUtil::GetRecursiveDirsListing(directory, items, DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_NO_FILE_INFO);
+    int64_t time = 0;
+    auto it = m_recursiveFolderTimes.find(directory);
+    if (it != m_recursiveFolderTimes.end())
+    {
+      time = it->second;
+      m_recursiveFolderTimes.erase(it);
+    }
+    else
+    {
+      std::vector<int64_t> times;
+      if (GetFolderTimes(std::vector<std::string>{directory}, true, times))
+        time = times[0];
+    }
 
     CDigest digest{CDigest::Type::MD5};
 
     if (excludes.size())
       digest.Update(StringUtils::Join(excludes, "|"));
 
-    int64_t time = 0;
-    for (int i=0; i < items.Size(); ++i)
+    if (time)
+    {
+      digest.Update((unsigned char *)&time, sizeof(time));
+      return digest.Finalize();
+    }
+    return "";
+  }
+
+  bool CVideoInfoScanner::GetFolderTimes(const std::vector<std::string> &folders, bool recursive, std::vector<int64_t> &times)
+  {
+    unsigned int start = XbmcThreads::SystemClockMillis();
+
+    // Jobs that only start after the walk is done still hold on to the walk
+    std::shared_ptr<FolderWalk> walk = std::make_shared<FolderWalk>();
+    walk->times.assign(folders.size(), 0);
+    walk->failed.assign(folders.size(), false);
+    for (size_t i = 0; i < folders.size(); ++i)
+      walk->pending.emplace_back(i, folders[i]);
+
+    auto walkFolders = [this, walk, recursive]()
     {
-      int64_t stat_time = 0;
-      struct __stat64 buffer;
-      if (XFILE::CFile::Stat(items[i]->GetPath(), &buffer) == 0)
+      CSingleLock lock(walk->critSection);
+      while (!walk->finished && !m_bStop)
       {
-        //! @todo some filesystems may return the mtime/ctime inline, in which case this is
-        //! unnecessarily expensive. Consider supporting Stat() in our directory cache?
-        stat_time = buffer.st_mtime ? buffer.st_mtime : buffer.st_ctime;
-        time += stat_time;
+        if (walk->pending.empty())
+        {
+          // the folders being stat'ed may still add subfolders
+          if (walk->active == 0)
+            break;
+          walk->changed.wait(lock);
+          continue;
+        }
+
+        std::pair<size_t, std::string> folder = std::move(walk->pending.front());
+        walk->pending.pop_front();
+        if (walk->failed[folder.first])
+          continue;
+
+        walk->active++;
+        int64_t time;
+        CFileItemList items;
+        {
+          CSingleExit exit(walk->critSection);
+          time = GetFolderTime(folder.second);
+          if (time && recursive)
+            CDirectory::GetDirectory(folder.second, items, "", DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_NO_FILE_INFO);
+        }
+        walk->active--;
+        walk->walked++;
+
+        // like the listing of CUtil::GetRecursiveDirsListing, one folder without
+        // a time leaves its whole tree without a hash
+        if (!time)
+          walk->failed[folder.first] = true;
+        else
+        {
+          walk->times[folder.first] += time;
+          for (const auto &item : items)
+          {
+            if (item->m_bIsFolder && !item->IsPath(".."))
+              walk->pending.emplace_back(folder.first, item->GetPath());
+          }
+        }
+        walk->changed.notifyAll();
       }
+    };
 
-      if (!stat_time)
-        return "";
+    // a recursive walk finds its folders as it goes
+    unsigned int workers = recursive ? MAX_FOLDER_WALKERS : std::min<size_t>(MAX_FOLDER_WALKERS, folders.size() - 1);
+    for (unsigned int i = 0; i < workers; ++i)
+      CJobManager::GetInstance().Submit(walkFolders, CJob::PRIORITY_NORMAL);
+
+    walkFolders();
+
+    CSingleLock lock(walk->critSection);
+    while (walk->active > 0)
+      walk->changed.wait(lock);
+    walk->finished = true;
+    walk->changed.notifyAll();
+
+    for (size_t i = 0; i < folders.size(); ++i)
+    {
+      if (walk->failed[i])
+        walk->times[i] = 0;
     }
+    times.swap(walk->times);
 
-    if (time)
+    m_walkedFolders += walk->walked;
+    m_walkTime += XbmcThreads::SystemClockMillis() - start;
+
+    return !m_bStop;
+  }
+
+  void CVideoInfoScanner::PrefetchFolderTimes(const CFileItemList &items, const std::vector<std::string> &excludes, bool recursive)
+  {
+    if (!g_advancedSettings.m_bVideoLibraryUseFastHash)
+      return;
+
+    std::vector<std::string> folders;
+    for (const auto &item : items)
     {
-      digest.Update((unsigned char *)&time, sizeof(time));
-      return digest.Finalize();
+      if (item->m_bIsFolder && !item->IsParentFolder() && !item->IsPlayList() && !item->IsPlugin() &&
+          !CUtil::ExcludeFileOrFolder(item->GetPath(), excludes))
+        folders.push_back(item->GetPath());
     }
-    return "";
+
+    // a single folder is walked when it's hashed
+    if (folders.size() < 2)
+      return;
+
+    std::vector<int64_t> times;
+    if (!GetFolderTimes(folders, recursive, times))
+      return;
+
+    std::map<std::string, int64_t> &folderTimes = recursive ? m_recursiveFolderTimes : m_folderTimes;
+    for (size_t i = 0; i < folders.size(); ++i)
+      folderTimes[folders[i]] = times[i];
   }
 
   void CVideoInfoScanner::GetSeasonThumbs(const CVideoInfoTag &show,
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <map>
 #include <set>
 #include <string>
 #include <vector>
@@ -186,7 +187,7 @@ namespace VIDEO
      \param excludes string array of exclude expressions
      \return the md5 hash of the folder"
      */
-    std::string GetFastHash(const std::string &directory, const std::vector<std::string> &excludes) const;
+    std::string GetFastHash(const std::string &directory, const std::vector<std::string> &excludes);
 
     /*! \brief Retrieve a "fast" hash of the given directory recursively (if available)
      Performs a stat() on the directory, and uses modified time to create a "fast"
@@ -198,7 +199,24 @@ namespace VIDEO
      \param excludes string array of exclude expressions
      \return the md5 hash of the folder
      */
-    std::string GetRecursiveFastHash(const std::string &directory, const std::vector<std::string> &excludes) const;
+    std::string GetRecursiveFastHash(const std::string &directory, const std::vector<std::string> &excludes);
+
+    /*! \brief Get the modified times of folders for their fast hashes
+     Folders are stat'ed (and listed if recursive) by a bounded number of jobs
+     along with the scanner thread, as each stat is a round trip on network shares.
+     \param folders the folders to walk
+     \param recursive whether the time of a folder is the sum of the times of all its subfolders
+     \param times the time of each folder, 0 if it or one of its subfolders couldn't be stat'ed
+     \return false if the scan was stopped during the walk
+     */
+    bool GetFolderTimes(const std::vector<std::string> &folders, bool recursive, std::vector<int64_t> &times);
+
+    /*! \brief Walk the subfolders of a listing at once before they are hashed one by one
+     \param items the directory listing
+     \param excludes string array of exclude expressions
+     \param recursive whether the subfolders are hashed recursively
+     */
+    void PrefetchFolderTimes(const CFileItemList &items, const std::vector<std::string> &excludes, bool recursive);
 
     /*! \brief Decide whether a folder listing could use the "fast" hash
      Fast hashing can be done whenever the folder contains no scannable subfolders, as the
@@ -232,6 +250,10 @@ namespace VIDEO
     CVideoDatabase m_database;
     std::set<std::string> m_pathsToCount;
     std::set<int> m_pathsToClean;
+    std::map<std::string, int64_t> m_folderTimes; //!< prefetched times of folders, removed once hashed
+    std::map<std::string, int64_t> m_recursiveFolderTimes; //!< prefetched times of folder trees, removed once hashed
+    unsigned int m_walkedFolders;
+    unsigned int m_walkTime;
   };
 }
 